@@ -1,6 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include "arctic/core/engine/engine_settings.h"
+#include "arctic/core/utilities/trace_writer.h"
+#include "arctic/graphics/rhi/draw_item.h"
+#include "arctic/graphics/rhi/frame_timings.h"
+#include "arctic/graphics/rhi/gpu_timings.h"
+#include "arctic/graphics/rhi/memory_stats.h"
 
 class VulkanWindow;
 class VulkanContext;
@@ -11,11 +18,37 @@ public:
     ArcticEngine();
     virtual ~ArcticEngine();
 
-    void Initialize();
+    void Initialize(const EngineSettings& settings = EngineSettings());
     void Run();
+    bool Update();
     void Cleanup();
 
+    // scene: draws rendered every frame until the list is replaced, the quad is drawn by default
+    void SetDrawList(const std::vector<DrawItem>& drawList);
+    DrawItem GetQuadDraw() const;
+
+    // pipeline of draws, compiled in the background, the draws use the default pipeline until it is ready
+    PipelineHandle RequestPipeline(const PipelineDesc& desc);
+
+    FrameTimings GetFrameTimings() const;
+    GpuFrameTimings GetGpuFrameTimings() const;
+    MemoryStats GetMemoryStats() const;
+
+    // frames in flight actually used, present.framesInFlight clamped to what the engine supports
+    uint32_t GetFramesInFlight() const;
+
 private:
+    // trace tracks: the gpu, then one per thread recording profiler zones
+    const uint32_t TRACE_THREAD_GPU = 0;
+    const uint32_t TRACE_THREAD_FIRST_CPU = 1;
+
+    EngineSettings settings;
+    uint64_t renderedFrameCount = 0;
+    FrameLimiter frameLimiter;
+    TraceWriter trace;
+    uint64_t tracedGpuFrameValue = 0;
     std::shared_ptr<VulkanWindow> pVulkanWindow;
     std::unique_ptr<VulkanContext> pVulkanContext;
+
+    void traceFrame();
 };
\ No newline at end of file
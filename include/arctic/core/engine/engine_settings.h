@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "arctic/graphics/rhi/memory_pool_sizes.h"
+#include "arctic/graphics/rhi/present_settings.h"
+#include "arctic/core/utilities/frame_limiter.h"
+
+struct EngineSettings
+{
+    // render into a ring of offscreen images instead of a window (no X server required)
+    bool headless = false;
+
+    // number of frames to run before returning from Run, 0 runs until the window is closed
+    uint64_t frameCount = 0;
+
+    // append gpu memory statistics as one json line to this file every memoryReportInterval frames, empty disables the report
+    std::string memoryReportPath;
+    uint64_t memoryReportInterval = 600;
+
+    // write a chrome trace of cpu frames and gpu zones to this file on Cleanup, empty disables the trace
+    std::string tracePath;
+
+    // present mode, swapchain images and frames in flight
+    PresentSettings present;
+
+    // block sizes of the gpu memory pools per resource class
+    MemoryPoolSizes memoryPools;
+
+    // recompile edited shaders and rebuild their pipelines while running (development), off for measurements
+    bool watchShaders = false;
+
+    // draw opaque geometry depth only first, the main pass then shades each pixel once (equal depth test)
+    bool depthPrepass = true;
+
+    // pacing of frame starts, targetFps 0 does not cap the frame rate
+    FrameLimiterMode frameLimiterMode = FrameLimiterMode::Off;
+    double targetFps = 0.0;
+};
+
+/// @brief parses fifo, fifo-relaxed, mailbox or immediate
+/// @return false when the name is unknown
+inline bool ParsePresentMode(const std::string& name, PresentMode& presentMode)
+{
+    if(name == "fifo")
+        presentMode = PresentMode::Fifo;
+    else if(name == "fifo-relaxed")
+        presentMode = PresentMode::FifoRelaxed;
+    else if(name == "mailbox")
+        presentMode = PresentMode::Mailbox;
+    else if(name == "immediate")
+        presentMode = PresentMode::Immediate;
+    else
+        return false;
+    return true;
+}
+
+/// @brief parses off, throughput or latency
+/// @return false when the name is unknown
+inline bool ParseFrameLimiterMode(const std::string& name, FrameLimiterMode& mode)
+{
+    if(name == "off")
+        mode = FrameLimiterMode::Off;
+    else if(name == "throughput")
+        mode = FrameLimiterMode::Throughput;
+    else if(name == "latency")
+        mode = FrameLimiterMode::Latency;
+    else
+        return false;
+    return true;
+}
\ No newline at end of file
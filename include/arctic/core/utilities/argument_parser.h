@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+/// @brief Parses numeric command line values.
+/// @brief Invalid or out of range values print an error and leave the value unchanged, they never throw.
+class ArgumentParser
+{
+public:
+    // decimal integer of at most maxValue
+    static bool ParseCount(const char* text, uint64_t& value, uint64_t maxValue = UINT64_MAX);
+    static bool ParseCount(const char* text, uint32_t& value);
+
+    // size in MB, value is set in bytes
+    static bool ParseMegabytes(const char* text, uint64_t& value);
+
+    // finite number, not negative
+    static bool ParseNumber(const char* text, double& value);
+};
\ No newline at end of file
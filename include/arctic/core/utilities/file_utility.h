@@ -7,4 +7,8 @@ class FileUtility
 {
 public:
     static bool ReadBinaryFile(const std::string &path, std::vector<char>&buffer);
+
+    // writes into a temporary file next to path and renames it over path
+    // >> readers see either the old or the new file, never a partially written one
+    static bool WriteBinaryFileAtomic(const std::string &path, const void* pData, size_t size);
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+enum class FrameLimiterMode : uint8_t
+{
+    Off = 0,    // frames start as soon as the previous one was submitted
+    Throughput, // frame starts are paced to the target rate, the cpu may record ahead of the gpu
+    Latency     // frames start as late as possible, after the gpu finished the previous frame
+};
+
+/// @brief Paces the start of frames, input is sampled after WaitForNextFrame returns.
+/// @brief Throughput: caps the frame rate, frames in flight keep the gpu busy.
+/// @brief Latency: the caller waits for the gpu before each frame and reports it with FrameCompleted, the limiter
+/// @brief learns how long a frame takes from input to gpu completion and delays the next start so the frame
+/// @brief finishes just before its deadline. Input is sampled later and no frame queues behind another,
+/// @brief at the cost of an idle gpu between frames.
+class FrameLimiter
+{
+public:
+    // targetFps 0: no rate cap (latency mode still waits for the gpu)
+    void Configure(FrameLimiterMode mode, double targetFps);
+    FrameLimiterMode GetMode() const;
+
+    // waits until the next frame should start
+    void WaitForNextFrame();
+
+    // latency: the gpu finished the frame started by the last WaitForNextFrame
+    void FrameCompleted();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // the end of a wait is spun, sleeping overshoots by up to a scheduler tick
+    const Clock::duration SPIN_DURATION = std::chrono::microseconds(1000);
+
+    // latency: share of the predicted frame duration kept as headroom, smoothing of the prediction
+    const double DURATION_HEADROOM = 0.1;
+    const double DURATION_SMOOTHING = 0.1;
+
+    FrameLimiterMode mode = FrameLimiterMode::Off;
+    Clock::duration framePeriod = Clock::duration::zero();
+
+    Clock::time_point frameStart{};
+    Clock::time_point frameDeadline{};
+    double predictedDurationUs = 0.0;
+
+    void waitUntil(Clock::time_point time) const;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+class TraceWriter;
+
+// cpu profiler zones
+// >> ARCTIC_PROFILE_ZONE("name") times the enclosing scope, ARCTIC_PROFILE_FUNCTION() the enclosing function (full signature)
+// >> ARCTIC_PROFILE_THREAD("name") names the track of the calling thread
+// >> names must be string literals, only the pointer is stored
+// >> compiled to nothing without ARCTIC_ENABLE_PROFILER (cmake option), recorded only while the profiler is enabled
+#ifdef ARCTIC_ENABLE_PROFILER
+    #define ARCTIC_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define ARCTIC_PROFILE_CONCAT(a, b) ARCTIC_PROFILE_CONCAT_IMPL(a, b)
+    #define ARCTIC_PROFILE_ZONE(name) ProfilerZone ARCTIC_PROFILE_CONCAT(profilerZone, __LINE__)(name)
+    #define ARCTIC_PROFILE_FUNCTION() ARCTIC_PROFILE_ZONE(__PRETTY_FUNCTION__)
+    #define ARCTIC_PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+    #define ARCTIC_PROFILE_ZONE(name)
+    #define ARCTIC_PROFILE_FUNCTION()
+    #define ARCTIC_PROFILE_THREAD(name)
+#endif
+
+/// @brief Records cpu zones into one ring buffer per thread.
+/// @brief A zone is a single write into the ring of its thread: no lock, no allocation, two reads of the time stamp
+/// @brief counter. The collector drains the rings (single producer, single consumer) into a trace, a full ring drops
+/// @brief zones until it is drained again.
+class Profiler
+{
+public:
+    // recording is off until enabled, zones then cost a relaxed load
+    static void SetEnabled(bool isEnabled);
+    static bool IsEnabled();
+
+    static void SetThreadName(const char* name);
+
+    // moves the recorded zones into the trace, one track per thread starting at firstThreadId
+    static void Collect(TraceWriter& trace, uint32_t firstThreadId);
+
+    static uint64_t Now();
+    static void Record(const char* name, uint64_t beginTicks, uint64_t endTicks);
+
+private:
+    struct Zone
+    {
+        const char* name = nullptr;
+        uint64_t beginTicks = 0;
+        uint64_t endTicks = 0;
+    };
+
+    // zones of one thread between two collections
+    static constexpr uint64_t RING_CAPACITY = 1 << 14;
+
+    struct ThreadRing
+    {
+        std::array<Zone, RING_CAPACITY> zones;
+        std::atomic<uint64_t> head = 0;     // written by the owning thread
+        std::atomic<uint64_t> tail = 0;     // written by the collector
+        std::atomic<uint64_t> droppedCount = 0;
+
+        uint32_t index = 0;
+        std::string name;
+    };
+
+    static std::atomic<bool> isEnabled;
+    static thread_local ThreadRing* pThreadRing;
+    static thread_local const char* pThreadName; // rings are created by the first zone, threads that never record cost nothing
+
+    // rings of every thread that recorded a zone, kept until the process exits (threads may exit before a collection)
+    static std::mutex registryMutex;
+    static std::vector<std::unique_ptr<ThreadRing>> rings;
+
+    // conversion of ticks to steady clock microseconds, guarded by the registry mutex
+    static uint64_t calibrationTicks;
+    static int64_t calibrationUs;
+    static double ticksPerUs;
+
+    static ThreadRing* registerThread();
+};
+
+/// @brief times its scope, see ARCTIC_PROFILE_ZONE
+class ProfilerZone
+{
+public:
+    explicit ProfilerZone(const char* name)
+    {
+        if(Profiler::IsEnabled())
+        {
+            this->name = name;
+            this->beginTicks = Profiler::Now();
+        }
+    }
+
+    ~ProfilerZone()
+    {
+        if(name != nullptr)
+            Profiler::Record(name, beginTicks, Profiler::Now());
+    }
+
+    ProfilerZone(const ProfilerZone&) = delete;
+    ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+private:
+    const char* name = nullptr;
+    uint64_t beginTicks = 0;
+};
+
+inline bool Profiler::IsEnabled()
+{
+    return isEnabled.load(std::memory_order_relaxed);
+}
+
+/// @brief time stamp counter on x86 (converted by the collector), steady clock ticks elsewhere
+inline uint64_t Profiler::Now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline void Profiler::Record(const char* name, uint64_t beginTicks, uint64_t endTicks)
+{
+    ThreadRing* pRing = pThreadRing != nullptr ? pThreadRing : registerThread();
+
+    // >> the owning thread is the only writer of head, the collector publishes freed slots through tail
+    uint64_t head = pRing->head.load(std::memory_order_relaxed);
+    if(head - pRing->tail.load(std::memory_order_acquire) >= RING_CAPACITY)
+    {
+        pRing->droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    pRing->zones[head & (RING_CAPACITY - 1)] = { name, beginTicks, endTicks };
+    pRing->head.store(head + 1, std::memory_order_release);
+}
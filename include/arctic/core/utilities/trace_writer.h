@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @brief Collects timed zones and counters and writes them as a Chrome trace (json), viewable in
+/// @brief chrome://tracing or Perfetto. Times are steady clock microseconds (NowUs), so cpu zones and gpu zones
+/// @brief converted to the cpu clock line up. Every thread id is one track, named with SetThreadName.
+/// @brief Events can be added from any thread.
+class TraceWriter
+{
+public:
+    using CounterValues = std::vector<std::pair<std::string, double>>;
+
+    static int64_t NowUs();
+
+    void SetThreadName(uint32_t threadId, const std::string& name);
+    void AddZone(const std::string& name, uint32_t threadId, int64_t startUs, int64_t durationUs);
+    void AddCounter(const std::string& name, int64_t timeUs, const CounterValues& values);
+
+    bool Save(const std::string& path) const;
+    void Clear();
+
+private:
+    struct Event
+    {
+        char phase = 'X';   // X: complete zone, C: counter, M: metadata (thread name)
+        std::string name;
+        uint32_t threadId = 0;
+        int64_t timeUs = 0;
+        int64_t durationUs = 0;
+        CounterValues values;
+    };
+
+    // events beyond the limit are dropped, a trace of a long run stays loadable
+    const size_t MAX_EVENTS = 1000000;
+
+    mutable std::mutex mutex;
+    std::vector<Event> events;
+    bool isTruncated = false;
+
+    void addEvent(Event&& event);
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+/// @brief per-draw data sent as push constants
+/// @brief must stay within 128 bytes, the minimum maxPushConstantsSize guaranteed by the spec
+struct DrawConstants {
+    glm::mat4 model;
+};
+
+static_assert(sizeof(DrawConstants) <= 128, "DrawConstants exceed the guaranteed push constant size");
\ No newline at end of file
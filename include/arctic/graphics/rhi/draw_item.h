@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "arctic/graphics/rhi/pipeline_desc.h"
+
+// a single indexed draw of the draw list
+struct DrawItem
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    PipelineHandle pipeline = 0;
+
+    uint32_t indexCount = 0;
+    uint32_t instanceCount = 1;
+    uint32_t firstIndex = 0;
+    int32_t vertexOffset = 0;
+};
\ No newline at end of file
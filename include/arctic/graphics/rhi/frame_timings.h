@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// cpu timings of a single rendered frame in milliseconds
+struct FrameTimings
+{
+    double waitMs = 0.0;    // waiting until the gpu finished the previous use of the frame in flight
+    double acquireMs = 0.0; // acquiring the next image to render into
+    double recordMs = 0.0;  // recording the command buffer
+    double submitMs = 0.0;  // submitting the command buffer to the graphics queue
+    double presentMs = 0.0; // queueing the image for presentation
+    double frameMs = 0.0;   // the complete frame
+    uint64_t frameValue = 0; // frame timeline value of the frame, 0 when the frame was not submitted
+};
\ No newline at end of file
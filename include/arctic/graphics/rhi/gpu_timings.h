@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// one profiled zone of a frame (pass, draw group), timed with gpu timestamps
+struct GpuZoneTiming
+{
+    std::string name;
+    double startMs = 0.0;       // relative to the start of the frame on the gpu
+    double durationMs = 0.0;
+};
+
+// pipeline statistics of the render graph passes
+struct GpuPipelineStatistics
+{
+    uint64_t inputAssemblyVertices = 0;
+    uint64_t inputAssemblyPrimitives = 0;
+    uint64_t vertexShaderInvocations = 0;
+    uint64_t clippingInvocations = 0;   // primitives reaching the clipping stage
+    uint64_t clippingPrimitives = 0;    // primitives left after clipping
+    uint64_t fragmentShaderInvocations = 0;
+};
+
+// gpu timings of a single frame, available once the frame completed (frames in flight behind the cpu)
+struct GpuFrameTimings
+{
+    uint64_t frameValue = 0;        // frame timeline value of the frame, 0 when no frame was profiled yet
+    int64_t startUs = 0;            // start of the frame on the gpu in steady clock microseconds of the cpu
+    double frameMs = 0.0;           // first to last command of the frame
+    std::vector<GpuZoneTiming> zones;
+
+    bool hasStatistics = false;     // false when the device does not support pipeline statistics queries
+    GpuPipelineStatistics statistics;
+};
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+// block sizes of the custom memory pools in bytes, 0 uses the vma default block size
+// >> larger blocks mean fewer device allocations, smaller blocks waste less memory in partly used blocks
+// >> resources larger than a block get a dedicated allocation
+struct MemoryPoolSizes
+{
+    uint64_t geometryBlockSize = 64ull * 1024 * 1024;
+    uint64_t uniformBlockSize = 8ull * 1024 * 1024;
+    uint64_t stagingBlockSize = 64ull * 1024 * 1024;
+    uint64_t textureBlockSize = 128ull * 1024 * 1024;
+};
\ No newline at end of file
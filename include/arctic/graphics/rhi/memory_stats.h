@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// usage of one memory heap against the budget reported by the driver (VK_EXT_memory_budget)
+// >> without the extension the budget is estimated by vma (80% of the heap) and usage only counts its own blocks
+struct HeapStats
+{
+    uint32_t heapIndex = 0;
+    bool isDeviceLocal = false;
+    uint64_t budgetBytes = 0;       // how much the process can use before the driver starts evicting
+    uint64_t usageBytes = 0;        // current usage of the process (all allocations incl. other apis)
+    uint64_t peakUsageBytes = 0;    // highest sampled usage
+    uint64_t blockBytes = 0;        // device memory allocated by vma
+    uint64_t allocationBytes = 0;   // part of blockBytes used by live allocations
+};
+
+// live allocations per memory type
+struct MemoryTypeStats
+{
+    uint32_t memoryTypeIndex = 0;
+    uint32_t heapIndex = 0;
+    uint32_t blockCount = 0;        // VkDeviceMemory objects
+    uint32_t allocationCount = 0;   // sub-allocations in those blocks
+    uint64_t blockBytes = 0;
+    uint64_t allocationBytes = 0;
+};
+
+// live allocations per owner (mesh, texture, uniform, staging, other)
+struct OwnerStats
+{
+    std::string owner;
+    uint64_t allocationCount = 0;
+    uint64_t allocationBytes = 0;
+    uint64_t peakAllocationBytes = 0;
+};
+
+struct MemoryStats
+{
+    bool isBudgetEstimated = false; // the device does not support VK_EXT_memory_budget
+    std::vector<HeapStats> heaps;
+    std::vector<MemoryTypeStats> memoryTypes;
+    std::vector<OwnerStats> owners;
+};
\ No newline at end of file
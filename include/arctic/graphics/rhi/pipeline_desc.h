@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+enum class PrimitiveTopology : uint8_t
+{
+    TriangleList = 0,
+    TriangleStrip,
+    LineList,
+    PointList
+};
+
+enum class CullMode : uint8_t
+{
+    None = 0,
+    Front,
+    Back
+};
+
+enum class BlendMode : uint8_t
+{
+    Opaque = 0,
+    AlphaBlend,     // src * a + dst * (1 - a)
+    Additive        // src * a + dst
+};
+
+// shaders and fixed function state of a graphics pipeline
+// >> equal descriptions share one pipeline, render pass and pipeline layout are owned by the renderer
+struct PipelineDesc
+{
+    std::string vertexShader = "first_shader.vert.spv";     // spir-v file in assets/shaders
+    std::string fragmentShader = "first_shader.frag.spv";
+
+    PrimitiveTopology topology = PrimitiveTopology::TriangleList;
+    CullMode cullMode = CullMode::Back;
+    bool isFrontFaceClockwise = false;
+    BlendMode blendMode = BlendMode::Opaque;    // only opaque draws are in the depth prepass
+
+    bool operator==(const PipelineDesc& other) const = default;
+};
+
+// pipeline of a draw, returned when the pipeline is requested
+// >> 0 is the default pipeline, draws fall back to it while their pipeline is compiling
+using PipelineHandle = uint32_t;
\ No newline at end of file
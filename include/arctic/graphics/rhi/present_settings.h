@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+enum class PresentMode : uint8_t
+{
+    Fifo = 0,       // vsync, always supported, frames queue up behind the display
+    FifoRelaxed,    // vsync, late frames are shown at once (may tear)
+    Mailbox,        // vsync without queueing, the newest frame replaces the waiting one
+    Immediate       // no vsync, lowest latency, tears
+};
+
+// presentation settings, chosen per deployment
+// >> validated against the surface and device when the swapchain is created, unsupported values fall back
+struct PresentSettings
+{
+    PresentMode presentMode = PresentMode::Mailbox; // falls back to fifo when unsupported
+    uint32_t imageCount = 3;                        // swapchain images, clamped to the surface limits
+    uint32_t framesInFlight = 3;                    // frames the cpu records ahead of the gpu, 1 to 4
+};
\ No newline at end of file
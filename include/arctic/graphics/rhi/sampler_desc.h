@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+enum class SamplerFilter : uint8_t
+{
+    Nearest = 0,
+    Linear
+};
+
+enum class SamplerAddressMode : uint8_t
+{
+    Repeat = 0,
+    MirroredRepeat,
+    ClampToEdge
+};
+
+// sampling settings a material uses for its textures
+// >> equal descriptions share one sampler
+struct SamplerDesc
+{
+    SamplerFilter filter = SamplerFilter::Linear;       // magnification and minification
+    SamplerFilter mipFilter = SamplerFilter::Linear;    // linear: blends between mips (trilinear)
+    SamplerAddressMode addressMode = SamplerAddressMode::Repeat;
+
+    float maxAnisotropy = 16.0f;    // <= 1 disables anisotropic filtering, clamped to the device limit
+    float mipLodBias = 0.0f;
+    float minLod = 0.0f;
+    float maxLod = 1000.0f;         // mips past maxLod are never sampled
+
+    bool operator==(const SamplerDesc& other) const = default;
+};
\ No newline at end of file
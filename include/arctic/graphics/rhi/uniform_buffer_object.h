@@ -2,8 +2,8 @@
 
 #include <glm/glm.hpp>
 
+// per-frame uniforms, the model matrix is sent per draw as push constants (see DrawConstants)
 struct UniformBufferObject {
-    glm::mat4 model;
     glm::mat4 view;
     glm::mat4 proj;
 };
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include "arctic/graphics/texture/texture_data.h"
+
+/// @brief CPU decompression of block compressed textures to RGBA8.
+/// @brief Used when the device cannot sample a BC format, block decoders write 4x4 texels of 4 bytes each (row major).
+class BcDecoder
+{
+public:
+    static bool Decompress(const TextureData& source, TextureData& destination);
+
+    static void DecodeBlockBC1(const uint8_t* pBlock, uint8_t* pTexels);
+    static void DecodeBlockBC1RGB(const uint8_t* pBlock, uint8_t* pTexels);
+    static void DecodeBlockBC3(const uint8_t* pBlock, uint8_t* pTexels);
+    static void DecodeBlockBC5(const uint8_t* pBlock, uint8_t* pTexels);
+    static void DecodeBlockBC7(const uint8_t* pBlock, uint8_t* pTexels);
+};
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+// instruction sets of the block encoder kernels, ordered by width
+enum class SimdLevel : uint32_t
+{
+    Scalar = 0,
+    SSE41,
+    AVX2
+};
+
+// speed / quality trade off of the block encoder
+// >> Fast: bounding box endpoints, no refinement
+// >> Normal: better of bounding box and principal axis endpoints, one least squares refinement, p-bit search (bc7)
+// >> Quality: as Normal, refinement until the error stops improving
+enum class EncodePreset : uint32_t
+{
+    Fast = 0,
+    Normal,
+    Quality
+};
+
+struct BcEncodeSettings
+{
+    EncodePreset preset = EncodePreset::Normal;
+    SimdLevel simdLevel = SimdLevel::AVX2; // limited to the level supported by the cpu
+};
+
+/// @brief CPU encoder of block compressed textures, the inverse of BcDecoder.
+/// @brief The index search (error of every texel against every palette entry) runs on SSE4.1 or AVX2 kernels, chosen at
+/// @brief runtime. All kernels produce identical blocks. Block encoders read 4x4 texels of 4 bytes each (row major).
+/// @brief BC7 blocks are encoded in mode 6 (one subset, rgba endpoints, 4 bit indices).
+class BcEncoder
+{
+public:
+    static SimdLevel GetSupportedSimdLevel();
+    static const char* GetSimdLevelName(SimdLevel level);
+
+    static void EncodeBlockBC1(const uint8_t* pTexels, uint8_t* pBlock, const BcEncodeSettings& settings);
+    static void EncodeBlockBC7(const uint8_t* pTexels, uint8_t* pBlock, const BcEncodeSettings& settings);
+};
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "arctic/graphics/texture/texture_data.h"
+
+/// @brief Reads and writes KTX2 containers holding 2d textures in one of the TextureFormat formats.
+/// @brief Only uncompressed containers are supported (no supercompression), arrays, cube maps and 3d textures are rejected.
+class Ktx2Loader
+{
+public:
+    static bool IsKtx2File(const std::string& path);
+    static bool Load(const std::string& path, TextureData& texture);
+    static bool LoadFromMemory(const uint8_t* pData, size_t size, TextureData& texture);
+    static bool Save(const std::string& path, const TextureData& texture);
+
+    static TextureFormat FromVkFormat(uint32_t vkFormat);
+    static uint32_t ToVkFormat(TextureFormat format);
+};
\ No newline at end of file
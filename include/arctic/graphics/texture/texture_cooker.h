@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include "arctic/graphics/texture/texture_data.h"
+#include "arctic/graphics/texture/bc_encoder.h"
+
+class ThreadPool;
+
+struct CookSettings
+{
+    TextureFormat format = TextureFormat::BC7_SRGB; // BC1_* / BC7_* compress, RGBA8_* keeps the texels
+    BcEncodeSettings encodeSettings;
+    bool generateMips = true;
+};
+
+/// @brief Turns rgba8 images into gpu ready textures: builds the mip chain and block compresses every level.
+/// @brief Mips are filtered in linear space, srgb sources are decoded before and encoded after filtering.
+/// @brief Blocks are encoded in bands of block rows on the thread pool.
+class TextureCooker
+{
+public:
+    static bool Cook(const TextureData& source, const CookSettings& settings, ThreadPool& threadPool, TextureData& cooked);
+    static bool GenerateMips(TextureData& texture);
+    static bool Compress(const TextureLevel& level, TextureFormat format, const BcEncodeSettings& settings, ThreadPool& threadPool, TextureLevel& compressed);
+};
\ No newline at end of file
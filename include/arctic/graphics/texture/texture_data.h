@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// formats of texture data
+// >> block compressed (BC) formats store 4x4 texel blocks
+enum class TextureFormat : uint32_t
+{
+    Undefined = 0,
+    RGBA8_UNORM,
+    RGBA8_SRGB,
+    BC1_UNORM,  // rgb + 1 bit alpha, 8 bytes per block
+    BC1_SRGB,
+    BC3_UNORM,  // rgba, 16 bytes per block
+    BC3_SRGB,
+    BC5_UNORM,  // two channels (normal maps), 16 bytes per block
+    BC7_UNORM,  // rgba at higher quality than bc3, 16 bytes per block
+    BC7_SRGB,
+    BC1_RGB_UNORM, // rgb, index 3 of three color blocks is opaque black, 8 bytes per block
+    BC1_RGB_SRGB
+};
+
+// one mip level, tightly packed rows of texels or blocks
+struct TextureLevel
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> data;
+};
+
+// texture with its mip chain, level 0 is the largest
+struct TextureData
+{
+    TextureFormat format = TextureFormat::Undefined;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<TextureLevel> levels;
+
+    size_t GetSize() const
+    {
+        size_t size = 0;
+        for(const auto& level : levels)
+            size += level.data.size();
+        return size;
+    }
+};
+
+class TextureFormats
+{
+public:
+    static bool IsCompressed(TextureFormat format);
+    static bool IsSrgb(TextureFormat format);
+    static uint32_t GetBlockSize(TextureFormat format);
+    static uint32_t GetBytesPerBlock(TextureFormat format);
+    static size_t GetLevelSize(TextureFormat format, uint32_t width, uint32_t height);
+};
\ No newline at end of file
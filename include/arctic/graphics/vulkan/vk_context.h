@@ -1,6 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include "arctic/graphics/rhi/draw_item.h"
+#include "arctic/graphics/rhi/frame_timings.h"
+#include "arctic/graphics/rhi/gpu_timings.h"
+#include "arctic/graphics/rhi/memory_pool_sizes.h"
+#include "arctic/graphics/rhi/memory_stats.h"
+#include "arctic/graphics/rhi/present_settings.h"
 
 class VulkanWindow;
 class VulkanLoader;
@@ -9,11 +16,39 @@ class VulkanRenderLoop;
 class VulkanContext
 {
 public: 
-    VulkanContext(std::shared_ptr<VulkanWindow> vulkanWindow);
+    VulkanContext(
+        std::shared_ptr<VulkanWindow> vulkanWindow,
+        const PresentSettings& presentSettings = PresentSettings(),
+        const MemoryPoolSizes& memoryPoolSizes = MemoryPoolSizes());
     virtual ~VulkanContext();
 
     void Cleanup();
-    void Render();
+
+    // returns false when the frame was skipped: the swapchain cannot be recreated (minimized window)
+    bool Render();
+
+    // blocks until the gpu finished every submitted frame
+    void WaitForSubmittedFrames();
+
+    // draws of the next frames, see VulkanRenderLoop::SetDrawList
+    void SetDrawList(const std::vector<DrawItem>& drawList);
+    DrawItem GetQuadDraw() const;
+
+    // pipelines are compiled in the background, draws use the default pipeline until theirs is ready
+    PipelineHandle RequestPipeline(const PipelineDesc& desc);
+
+    // recompiles edited shaders and rebuilds their pipelines while running
+    void SetShaderWatch(bool isEnabled);
+
+    // opaque draws write depth in a prepass, the main pass shades only their visible fragments
+    void SetDepthPrepass(bool isEnabled);
+
+    FrameTimings GetFrameTimings() const;
+    GpuFrameTimings GetGpuFrameTimings() const;
+    MemoryStats GetMemoryStats() const;
+
+    // frames in flight the render loop uses, the requested count is clamped to what the engine supports
+    uint32_t GetFramesInFlight() const;
 
 private:
     std::unique_ptr<VulkanLoader> pVulkanLoader;
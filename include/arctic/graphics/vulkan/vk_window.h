@@ -21,12 +21,18 @@ public:
     std::pair<uint32_t,uint32_t> GetFramebufferSize() const;
 
     void CreateWindow();
+    void CreateHeadless();
     void CreateSurface(const VkInstance& vkInstance, VkSurfaceKHR& vkSurface) const;
     void CleanupWindow();
 
+    bool IsHeadless() const;
+
 private:
     
     const uint32_t WINDOW_WIDTH = 1280;
     const uint32_t WINDOW_HEIGHT = 720;
     SDL_Window* window = nullptr;
+
+    // headless: no SDL window is created, rendering happens into offscreen images
+    bool isHeadless = false;
 };
\ No newline at end of file
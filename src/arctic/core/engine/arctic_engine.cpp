@@ -2,6 +2,59 @@
 #include <SDL2/SDL.h>
 #include "arctic/graphics/vulkan/vk_window.h"
 #include "arctic/graphics/vulkan/vk_context.h"
+#include "arctic/core/utilities/profiler.h"
+#include <fstream>
+#include <iostream>
+
+/// @brief appends the memory statistics as a single json line
+static void writeMemoryReport(const std::string& path, uint64_t frame, const MemoryStats& stats)
+{
+    std::ofstream file(path, std::ios::app);
+    if(!file.is_open())
+    {
+        std::cout << "error: engine: failed to open memory report " << path << std::endl;
+        return;
+    }
+
+    file << "{\"frame\": " << frame << ", \"budgetEstimated\": " << (stats.isBudgetEstimated ? "true" : "false") << ", \"heaps\": [";
+    for(size_t i = 0; i < stats.heaps.size(); ++i)
+    {
+        const HeapStats& heap = stats.heaps[i];
+        file << (i > 0 ? ", " : "")
+             << "{\"heap\": " << heap.heapIndex
+             << ", \"deviceLocal\": " << (heap.isDeviceLocal ? "true" : "false")
+             << ", \"budget\": " << heap.budgetBytes
+             << ", \"usage\": " << heap.usageBytes
+             << ", \"peakUsage\": " << heap.peakUsageBytes
+             << ", \"blockBytes\": " << heap.blockBytes
+             << ", \"allocationBytes\": " << heap.allocationBytes << "}";
+    }
+
+    file << "], \"memoryTypes\": [";
+    for(size_t i = 0; i < stats.memoryTypes.size(); ++i)
+    {
+        const MemoryTypeStats& memoryType = stats.memoryTypes[i];
+        file << (i > 0 ? ", " : "")
+             << "{\"type\": " << memoryType.memoryTypeIndex
+             << ", \"heap\": " << memoryType.heapIndex
+             << ", \"blocks\": " << memoryType.blockCount
+             << ", \"allocations\": " << memoryType.allocationCount
+             << ", \"blockBytes\": " << memoryType.blockBytes
+             << ", \"allocationBytes\": " << memoryType.allocationBytes << "}";
+    }
+
+    file << "], \"owners\": [";
+    for(size_t i = 0; i < stats.owners.size(); ++i)
+    {
+        const OwnerStats& owner = stats.owners[i];
+        file << (i > 0 ? ", " : "")
+             << "{\"owner\": \"" << owner.owner << "\""
+             << ", \"allocations\": " << owner.allocationCount
+             << ", \"bytes\": " << owner.allocationBytes
+             << ", \"peakBytes\": " << owner.peakAllocationBytes << "}";
+    }
+    file << "]}\n";
+}
 
 ArcticEngine::ArcticEngine()
 {
@@ -16,35 +69,179 @@ ArcticEngine::~ArcticEngine()
 void ArcticEngine::Run()
 {
     // loop while no close window
-    auto window = pVulkanWindow->GetSDLWindow();
-    SDL_Event event;
-    bool running = true;
-    while(running)
+    // >> or until the requested frame count is reached
+    uint64_t frameIndex = 0;
+    while(Update())
+    {
+        // stop when frame count reached
+        ++frameIndex;
+        if(settings.frameCount != 0 && frameIndex >= settings.frameCount)
+            break;
+    }
+}
+
+/// @brief Processes window events and renders a single frame.
+/// @return false when the window has been closed
+bool ArcticEngine::Update()
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    // pace frame
+    // >> latency: the gpu finished every submitted frame before input is sampled, nothing queues behind the display
     {
-        // check input
+        ARCTIC_PROFILE_ZONE("frame pacing");
+        if(frameLimiter.GetMode() == FrameLimiterMode::Latency)
+        {
+            pVulkanContext->WaitForSubmittedFrames();
+            frameLimiter.FrameCompleted();
+        }
+        frameLimiter.WaitForNextFrame();
+    }
+
+    // check input
+    // >> headless: there is no window to receive events from
+    if(!settings.headless)
+    {
+        ARCTIC_PROFILE_ZONE("input");
+        SDL_Event event;
         while(SDL_PollEvent(&event))
         {
             if(event.type == SDL_QUIT)
-                running = false;
+                return false;
         }
-        
-        // render
-        pVulkanContext->Render();
     }
+    
+    // render
+    // >> minimized: block until a window event (restore, quit) instead of retrying the swapchain in a busy loop
+    if(!pVulkanContext->Render())
+    {
+        ARCTIC_PROFILE_ZONE("minimized");
+        SDL_Event event;
+        if(SDL_WaitEventTimeout(&event, 100) && event.type == SDL_QUIT)
+            return false;
+        return true;
+    }
+    ++renderedFrameCount;
+
+    if(!settings.tracePath.empty())
+        traceFrame();
+
+    // report memory periodically
+    if(!settings.memoryReportPath.empty() && settings.memoryReportInterval > 0 && 
+        renderedFrameCount % settings.memoryReportInterval == 0)
+    {
+        writeMemoryReport(settings.memoryReportPath, renderedFrameCount, pVulkanContext->GetMemoryStats());
+    }
+    return true;
 }
 
-void ArcticEngine::Initialize()
+void ArcticEngine::SetDrawList(const std::vector<DrawItem>& drawList)
 {
+    pVulkanContext->SetDrawList(drawList);
+}
+
+DrawItem ArcticEngine::GetQuadDraw() const
+{
+    return pVulkanContext->GetQuadDraw();
+}
+
+PipelineHandle ArcticEngine::RequestPipeline(const PipelineDesc& desc)
+{
+    return pVulkanContext->RequestPipeline(desc);
+}
+
+FrameTimings ArcticEngine::GetFrameTimings() const
+{
+    return pVulkanContext->GetFrameTimings();
+}
+
+GpuFrameTimings ArcticEngine::GetGpuFrameTimings() const
+{
+    return pVulkanContext->GetGpuFrameTimings();
+}
+
+MemoryStats ArcticEngine::GetMemoryStats() const
+{
+    return pVulkanContext->GetMemoryStats();
+}
+
+uint32_t ArcticEngine::GetFramesInFlight() const
+{
+    return pVulkanContext->GetFramesInFlight();
+}
+
+/// @brief adds the profiler zones recorded since the last frame and the latest completed gpu frame to the trace
+void ArcticEngine::traceFrame()
+{
+    auto toUs = [](double ms) { return static_cast<int64_t>(ms * 1000.0); };
+
+    // cpu: zones of every thread, collected once per frame so the thread rings never fill up
+    Profiler::Collect(trace, TRACE_THREAD_FIRST_CPU);
+
+    // gpu: completes frames in flight later, every frame is added once
+    GpuFrameTimings gpuTimings = pVulkanContext->GetGpuFrameTimings();
+    if(gpuTimings.frameValue == 0 || gpuTimings.frameValue == tracedGpuFrameValue)
+        return;
+    tracedGpuFrameValue = gpuTimings.frameValue;
+
+    trace.AddZone("gpu frame", TRACE_THREAD_GPU, gpuTimings.startUs, toUs(gpuTimings.frameMs));
+    for(const auto& zone : gpuTimings.zones)
+        trace.AddZone(zone.name, TRACE_THREAD_GPU, gpuTimings.startUs + toUs(zone.startMs), toUs(zone.durationMs));
+
+    if(gpuTimings.hasStatistics)
+    {
+        const GpuPipelineStatistics& statistics = gpuTimings.statistics;
+        trace.AddCounter("render passes", gpuTimings.startUs,
+        {
+            { "vertices", static_cast<double>(statistics.inputAssemblyVertices) },
+            { "primitives", static_cast<double>(statistics.inputAssemblyPrimitives) },
+            { "vertex invocations", static_cast<double>(statistics.vertexShaderInvocations) },
+            { "clipped primitives", static_cast<double>(statistics.clippingPrimitives) },
+            { "fragment invocations", static_cast<double>(statistics.fragmentShaderInvocations) },
+        });
+    }
+}
+
+void ArcticEngine::Initialize(const EngineSettings& settings)
+{
+    this->settings = settings;
+
     // create window
     pVulkanWindow = std::make_shared<VulkanWindow>();
-    pVulkanWindow->CreateWindow();
+    if(settings.headless)
+        pVulkanWindow->CreateHeadless();
+    else
+        pVulkanWindow->CreateWindow();
 
     // load vulkan
-    pVulkanContext = std::make_unique<VulkanContext>(pVulkanWindow);
+    pVulkanContext = std::make_unique<VulkanContext>(pVulkanWindow, settings.present, settings.memoryPools);
+    pVulkanContext->SetDepthPrepass(settings.depthPrepass);
+    pVulkanContext->SetShaderWatch(settings.watchShaders);
+
+    // pace frames
+    frameLimiter.Configure(settings.frameLimiterMode, settings.targetFps);
+
+    // record profiler zones for the trace
+    // >> builds without ARCTIC_ENABLE_PROFILER trace the gpu only
+    if(!settings.tracePath.empty())
+    {
+        trace.SetThreadName(TRACE_THREAD_GPU, "gpu: graphics queue");
+        Profiler::SetEnabled(true);
+        ARCTIC_PROFILE_THREAD("main");
+    }
 }
 
 void ArcticEngine::Cleanup()
 {
+    // write trace
+    if(!settings.tracePath.empty())
+    {
+        Profiler::SetEnabled(false);
+        Profiler::Collect(trace, TRACE_THREAD_FIRST_CPU);
+        if(trace.Save(settings.tracePath))
+            std::cout << "info: engine: trace written to " << settings.tracePath << std::endl;
+    }
+
     // cleanup vulkan
     pVulkanContext->Cleanup();
     pVulkanContext.reset();
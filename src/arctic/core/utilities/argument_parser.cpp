@@ -0,0 +1,55 @@
+#include "arctic/core/utilities/argument_parser.h"
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+
+bool ArgumentParser::ParseCount(const char* text, uint64_t& value, uint64_t maxValue)
+{
+    uint64_t result = 0;
+    const char* end = text + std::strlen(text);
+    auto [ptr, errorCode] = std::from_chars(text, end, result);
+    if(errorCode != std::errc() || ptr != end || result > maxValue)
+    {
+        std::cout << "error: arguments: invalid count " << text << std::endl;
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+bool ArgumentParser::ParseCount(const char* text, uint32_t& value)
+{
+    uint64_t result = value;
+    if(!ParseCount(text, result, UINT32_MAX))
+        return false;
+    value = static_cast<uint32_t>(result);
+    return true;
+}
+
+bool ArgumentParser::ParseMegabytes(const char* text, uint64_t& value)
+{
+    // >> bounded so the size in bytes does not overflow
+    uint64_t sizeMB = 0;
+    if(!ParseCount(text, sizeMB, UINT64_MAX / (1024 * 1024)))
+        return false;
+    value = sizeMB * 1024 * 1024;
+    return true;
+}
+
+bool ArgumentParser::ParseNumber(const char* text, double& value)
+{
+    char* end = nullptr;
+    errno = 0;
+    double result = std::strtod(text, &end);
+    if(end == text || *end != '\0' || errno == ERANGE || !std::isfinite(result) || result < 0.0)
+    {
+        std::cout << "error: arguments: invalid number " << text << std::endl;
+        return false;
+    }
+    value = result;
+    return true;
+}
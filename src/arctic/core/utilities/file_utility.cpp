@@ -26,5 +26,43 @@ bool FileUtility::ReadBinaryFile(const std::string& path, std::vector<char>& buf
     // finish reading
     file.close();
 
+    return true;
+}
+
+bool FileUtility::WriteBinaryFileAtomic(const std::string& path, const void* pData, size_t size)
+{
+    fs::path fsPath(path);
+    fs::path tempPath = fsPath;
+    tempPath += ".tmp";
+
+    // create parent directories
+    std::error_code error;
+    if(fsPath.has_parent_path())
+        fs::create_directories(fsPath.parent_path(), error);
+
+    // write temporary file
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if(!file.is_open())
+            return false;
+
+        file.write(static_cast<const char*>(pData), static_cast<std::streamsize>(size));
+        file.flush();
+        if(!file.good())
+        {
+            file.close();
+            fs::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    // replace file
+    // >> rename is atomic within one file system, the temporary file lives in the same directory
+    fs::rename(tempPath, fsPath, error);
+    if(error)
+    {
+        fs::remove(tempPath, error);
+        return false;
+    }
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "arctic/core/utilities/frame_limiter.h"
+#include <algorithm>
+#include <thread>
+
+void FrameLimiter::Configure(FrameLimiterMode mode, double targetFps)
+{
+    this->mode = mode;
+    this->framePeriod = targetFps > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps))
+        : Clock::duration::zero();
+
+    frameStart = {};
+    frameDeadline = {};
+    predictedDurationUs = 0.0;
+}
+
+FrameLimiterMode FrameLimiter::GetMode() const
+{
+    return this->mode;
+}
+
+void FrameLimiter::WaitForNextFrame()
+{
+    auto now = Clock::now();
+    bool isFirstFrame = frameStart == Clock::time_point{};
+
+    switch(mode)
+    {
+    case FrameLimiterMode::Off:
+        break;
+
+    case FrameLimiterMode::Throughput:
+    {
+        // start one period after the previous start
+        // >> more than a period behind: start now instead of catching up with a burst of frames
+        if(framePeriod == Clock::duration::zero() || isFirstFrame)
+            break;
+
+        auto start = frameStart + framePeriod;
+        if(now > start + framePeriod)
+            break;
+
+        waitUntil(start);
+        frameStart = start;
+        return;
+    }
+
+    case FrameLimiterMode::Latency:
+    {
+        // deadline: one period after the previous deadline, but never before the frame can finish
+        // >> start: the predicted frame duration (plus headroom) before the deadline
+        auto predictedDuration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::micro>(predictedDurationUs * (1.0 + DURATION_HEADROOM)));
+        frameDeadline = isFirstFrame ? now + predictedDuration : std::max(frameDeadline + framePeriod, now + predictedDuration);
+
+        waitUntil(frameDeadline - predictedDuration);
+        break;
+    }
+    }
+
+    frameStart = Clock::now();
+}
+
+void FrameLimiter::FrameCompleted()
+{
+    if(mode != FrameLimiterMode::Latency || frameStart == Clock::time_point{})
+        return;
+
+    // predict the duration of the next frame from the measured ones
+    // >> input sampled at the frame start until the gpu finished it
+    double durationUs = std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count();
+    predictedDurationUs = predictedDurationUs == 0.0
+        ? durationUs
+        : predictedDurationUs + DURATION_SMOOTHING * (durationUs - predictedDurationUs);
+}
+
+void FrameLimiter::waitUntil(Clock::time_point time) const
+{
+    // sleep most of the time, spin the rest
+    auto now = Clock::now();
+    if(time - now > SPIN_DURATION)
+        std::this_thread::sleep_until(time - SPIN_DURATION);
+
+    while(Clock::now() < time)
+        std::this_thread::yield();
+}
@@ -0,0 +1,114 @@
+#include "arctic/core/utilities/profiler.h"
+#include "arctic/core/utilities/trace_writer.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+std::atomic<bool> Profiler::isEnabled = false;
+thread_local Profiler::ThreadRing* Profiler::pThreadRing = nullptr;
+thread_local const char* Profiler::pThreadName = nullptr;
+
+std::mutex Profiler::registryMutex;
+std::vector<std::unique_ptr<Profiler::ThreadRing>> Profiler::rings;
+
+uint64_t Profiler::calibrationTicks = 0;
+int64_t Profiler::calibrationUs = 0;
+double Profiler::ticksPerUs = 1.0;
+
+/// @brief ticks and steady clock microseconds sampled back to back
+static void sampleClocks(uint64_t& ticks, int64_t& us)
+{
+    ticks = Profiler::Now();
+    us = TraceWriter::NowUs();
+}
+
+void Profiler::SetEnabled(bool isEnabled)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if(isEnabled && !Profiler::isEnabled)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        // x86: the time stamp counter rate is measured against the steady clock, refined with every collection
+        // >> measure the counter rate over a few milliseconds, once when recording starts
+        sampleClocks(calibrationTicks, calibrationUs);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        uint64_t ticks = 0;
+        int64_t us = 0;
+        sampleClocks(ticks, us);
+        ticksPerUs = static_cast<double>(ticks - calibrationTicks) / static_cast<double>(std::max<int64_t>(1, us - calibrationUs));
+#else
+        sampleClocks(calibrationTicks, calibrationUs);
+        ticksPerUs = static_cast<double>(std::chrono::steady_clock::period::den) / (1000000.0 * std::chrono::steady_clock::period::num);
+#endif
+    }
+    Profiler::isEnabled = isEnabled;
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    pThreadName = name;
+    if(pThreadRing == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    pThreadRing->name = name;
+}
+
+void Profiler::Collect(TraceWriter& trace, uint32_t firstThreadId)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+#if defined(__x86_64__) || defined(__i386__)
+    // refine the counter rate over the whole recording
+    uint64_t ticks = 0;
+    int64_t us = 0;
+    sampleClocks(ticks, us);
+    if(us - calibrationUs > 1000000)
+        ticksPerUs = static_cast<double>(ticks - calibrationTicks) / static_cast<double>(us - calibrationUs);
+#endif
+
+    auto toUs = [](uint64_t ticks)
+    {
+        return calibrationUs + static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(ticks - calibrationTicks)) / ticksPerUs);
+    };
+
+    for(auto& pRing : rings)
+    {
+        // name the track once
+        uint32_t threadId = firstThreadId + pRing->index;
+        if(!pRing->name.empty())
+        {
+            trace.SetThreadName(threadId, pRing->name);
+            pRing->name.clear();
+        }
+
+        // drain recorded zones
+        // >> head is published after the zone was written, slots up to it are complete
+        uint64_t tail = pRing->tail.load(std::memory_order_relaxed);
+        uint64_t head = pRing->head.load(std::memory_order_acquire);
+        for(; tail < head; ++tail)
+        {
+            const Zone& zone = pRing->zones[tail & (RING_CAPACITY - 1)];
+            int64_t beginUs = toUs(zone.beginTicks);
+            trace.AddZone(zone.name, threadId, beginUs, toUs(zone.endTicks) - beginUs);
+        }
+        pRing->tail.store(tail, std::memory_order_release);
+
+        uint64_t droppedCount = pRing->droppedCount.exchange(0, std::memory_order_relaxed);
+        if(droppedCount > 0)
+            trace.AddCounter("dropped profiler zones", TraceWriter::NowUs(), { { std::to_string(threadId), static_cast<double>(droppedCount) } });
+    }
+}
+
+Profiler::ThreadRing* Profiler::registerThread()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    auto pRing = std::make_unique<ThreadRing>();
+    pRing->index = static_cast<uint32_t>(rings.size());
+    pRing->name = pThreadName != nullptr ? pThreadName : "thread " + std::to_string(pRing->index);
+    pThreadRing = pRing.get();
+    rings.push_back(std::move(pRing));
+    return pThreadRing;
+}
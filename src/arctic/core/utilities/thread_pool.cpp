@@ -0,0 +1,64 @@
+#include "arctic/core/utilities/thread_pool.h"
+#include "arctic/core/utilities/profiler.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    // default: leave one core for the calling (main) thread
+    if(threadCount == 0)
+    {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = std::max<uint32_t>(1, hardwareThreads > 1 ? hardwareThreads - 1 : 1);
+    }
+
+    // start workers
+    workers.reserve(threadCount);
+    for(uint32_t i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    // stop workers after the remaining tasks are finished
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    condition.notify_all();
+
+    for(auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+    return static_cast<uint32_t>(workers.size());
+}
+
+void ThreadPool::workerLoop()
+{
+    ARCTIC_PROFILE_THREAD("worker");
+
+    while(true)
+    {
+        // wait for task
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return isStopping || !tasks.empty(); });
+
+            if(isStopping && tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        // execute task
+        task();
+    }
+}
@@ -0,0 +1,121 @@
+#include "arctic/core/utilities/trace_writer.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+/// @brief escapes quotes, backslashes and control characters of a json string
+static std::string escapeJson(const std::string& text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for(char c : text)
+    {
+        if(c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if(static_cast<unsigned char>(c) < 0x20)
+            escaped += ' ';
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+int64_t TraceWriter::NowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceWriter::SetThreadName(uint32_t threadId, const std::string& name)
+{
+    Event event{};
+    event.phase = 'M';
+    event.name = name;
+    event.threadId = threadId;
+    addEvent(std::move(event));
+}
+
+void TraceWriter::AddZone(const std::string& name, uint32_t threadId, int64_t startUs, int64_t durationUs)
+{
+    Event event{};
+    event.phase = 'X';
+    event.name = name;
+    event.threadId = threadId;
+    event.timeUs = startUs;
+    event.durationUs = durationUs;
+    addEvent(std::move(event));
+}
+
+void TraceWriter::AddCounter(const std::string& name, int64_t timeUs, const CounterValues& values)
+{
+    Event event{};
+    event.phase = 'C';
+    event.name = name;
+    event.timeUs = timeUs;
+    event.values = values;
+    addEvent(std::move(event));
+}
+
+/// @return true when the trace was written
+bool TraceWriter::Save(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::ofstream file(path);
+    if(!file.is_open())
+    {
+        std::cout << "error: trace: failed to open " << path << std::endl;
+        return false;
+    }
+
+    // >> one process, the tracks are the thread ids
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for(size_t i = 0; i < events.size(); ++i)
+    {
+        const Event& event = events[i];
+        file << (i > 0 ? ",\n" : "");
+
+        switch(event.phase)
+        {
+        case 'M':
+            file << "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 0, \"tid\": " << event.threadId
+                 << ", \"args\": {\"name\": \"" << escapeJson(event.name) << "\"}}";
+            break;
+        case 'C':
+            file << "{\"ph\": \"C\", \"name\": \"" << escapeJson(event.name) << "\", \"pid\": 0, \"ts\": " << event.timeUs << ", \"args\": {";
+            for(size_t v = 0; v < event.values.size(); ++v)
+                file << (v > 0 ? ", " : "") << "\"" << escapeJson(event.values[v].first) << "\": " << event.values[v].second;
+            file << "}}";
+            break;
+        default:
+            file << "{\"ph\": \"X\", \"name\": \"" << escapeJson(event.name) << "\", \"pid\": 0, \"tid\": " << event.threadId
+                 << ", \"ts\": " << event.timeUs << ", \"dur\": " << event.durationUs << "}";
+            break;
+        }
+    }
+    file << "\n]}\n";
+
+    if(isTruncated)
+        std::cout << "info: trace: more than " << MAX_EVENTS << " events, later events were dropped" << std::endl;
+    return true;
+}
+
+void TraceWriter::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+    isTruncated = false;
+}
+
+void TraceWriter::addEvent(Event&& event)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(events.size() >= MAX_EVENTS)
+    {
+        isTruncated = true;
+        return;
+    }
+    events.push_back(std::move(event));
+}
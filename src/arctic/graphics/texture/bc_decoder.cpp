@@ -0,0 +1,426 @@
+#include "arctic/graphics/texture/bc_decoder.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// bc7 partition tables
+// >> two subsets: one bit per texel, three subsets: two bits per texel, texel 0 in the lowest bits
+static const uint16_t BC7_PARTITIONS_2[64] = {
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22 };
+
+static const uint32_t BC7_PARTITIONS_3[64] = {
+    0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+    0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+    0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+    0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+    0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+    0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+    0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+    0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254 };
+
+// bc7 anchor texels: their index omits the highest bit, the first texel is the anchor of subset 0
+static const uint8_t BC7_ANCHORS_2_SUBSET_1[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15 };
+
+static const uint8_t BC7_ANCHORS_3_SUBSET_1[64] = {
+     3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+     3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+     8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+     3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3 };
+
+static const uint8_t BC7_ANCHORS_3_SUBSET_2[64] = {
+    15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+    15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+    15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+    15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8 };
+
+// interpolation weights (of 64) per index bit count
+static const uint8_t BC7_WEIGHTS_2[4] = { 0, 21, 43, 64 };
+static const uint8_t BC7_WEIGHTS_3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const uint8_t BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+struct Bc7ModeInfo
+{
+    uint8_t subsetCount;
+    uint8_t partitionBits;
+    uint8_t rotationBits;
+    uint8_t indexSelectionBits;
+    uint8_t colorBits;
+    uint8_t alphaBits;
+    uint8_t endpointPBits;  // one p-bit per endpoint
+    uint8_t sharedPBits;    // one p-bit per subset
+    uint8_t indexBits;
+    uint8_t secondaryIndexBits;
+};
+
+static const Bc7ModeInfo BC7_MODES[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 } };
+
+// reads a 128 bit block from the lowest bit up
+class BlockBitReader
+{
+public:
+    explicit BlockBitReader(const uint8_t* pBlock)
+    {
+        memcpy(&low, pBlock, sizeof(uint64_t));
+        memcpy(&high, pBlock + sizeof(uint64_t), sizeof(uint64_t));
+    }
+
+    uint32_t Read(uint32_t bitCount)
+    {
+        uint32_t value = 0;
+        for(uint32_t i = 0; i < bitCount; ++i, ++position)
+        {
+            uint64_t bit = position < 64 ? (low >> position) & 1 : (high >> (position - 64)) & 1;
+            value |= static_cast<uint32_t>(bit) << i;
+        }
+        return value;
+    }
+
+private:
+    uint64_t low = 0;
+    uint64_t high = 0;
+    uint32_t position = 0;
+};
+
+static uint8_t expand5(uint32_t value) { return static_cast<uint8_t>((value << 3) | (value >> 2)); }
+static uint8_t expand6(uint32_t value) { return static_cast<uint8_t>((value << 2) | (value >> 4)); }
+
+/// @brief expands a bitCount wide value to 8 bits by replicating its highest bits
+static uint8_t expandBits(uint32_t value, uint32_t bitCount)
+{
+    value <<= (8 - bitCount);
+    return static_cast<uint8_t>(value | (value >> bitCount));
+}
+
+static uint8_t interpolate(uint8_t e0, uint8_t e1, uint32_t weight)
+{
+    return static_cast<uint8_t>(((64 - weight) * e0 + weight * e1 + 32) >> 6);
+}
+
+/// @brief decodes the color part of a bc1/bc3 block
+/// @param isOpaque bc3 color blocks always use four colors
+static void decodeColorBlock(const uint8_t* pBlock, uint8_t* pTexels, bool isOpaque)
+{
+    uint16_t c0 = static_cast<uint16_t>(pBlock[0] | (pBlock[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(pBlock[2] | (pBlock[3] << 8));
+
+    uint8_t palette[4][4];
+    palette[0][0] = expand5(c0 >> 11);
+    palette[0][1] = expand6((c0 >> 5) & 0x3f);
+    palette[0][2] = expand5(c0 & 0x1f);
+    palette[0][3] = 255;
+    palette[1][0] = expand5(c1 >> 11);
+    palette[1][1] = expand6((c1 >> 5) & 0x3f);
+    palette[1][2] = expand5(c1 & 0x1f);
+    palette[1][3] = 255;
+
+    if(c0 > c1 || isOpaque)
+    {
+        for(int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    }
+    else
+    {
+        // three colors + transparent black
+        for(int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c] + 1) / 2);
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+    }
+
+    uint32_t indices = static_cast<uint32_t>(pBlock[4] | (pBlock[5] << 8) | (pBlock[6] << 16) | (pBlock[7] << 24));
+    for(int texel = 0; texel < 16; ++texel)
+    {
+        uint32_t index = (indices >> (2 * texel)) & 0x3;
+        memcpy(pTexels + texel * 4, palette[index], 4);
+    }
+}
+
+/// @brief decodes a single channel block (bc3 alpha, bc4, bc5 channels) into every 4th byte starting at pTexels
+static void decodeChannelBlock(const uint8_t* pBlock, uint8_t* pTexels)
+{
+    uint8_t palette[8];
+    palette[0] = pBlock[0];
+    palette[1] = pBlock[1];
+    if(palette[0] > palette[1])
+    {
+        for(int i = 1; i < 7; ++i)
+            palette[i + 1] = static_cast<uint8_t>(((7 - i) * palette[0] + i * palette[1] + 3) / 7);
+    }
+    else
+    {
+        for(int i = 1; i < 5; ++i)
+            palette[i + 1] = static_cast<uint8_t>(((5 - i) * palette[0] + i * palette[1] + 2) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for(int i = 0; i < 6; ++i)
+        indices |= static_cast<uint64_t>(pBlock[2 + i]) << (8 * i);
+
+    for(int texel = 0; texel < 16; ++texel)
+        pTexels[texel * 4] = palette[(indices >> (3 * texel)) & 0x7];
+}
+
+void BcDecoder::DecodeBlockBC1(const uint8_t* pBlock, uint8_t* pTexels)
+{
+    decodeColorBlock(pBlock, pTexels, false);
+}
+
+void BcDecoder::DecodeBlockBC1RGB(const uint8_t* pBlock, uint8_t* pTexels)
+{
+    // no alpha: index 3 of three color blocks is black
+    decodeColorBlock(pBlock, pTexels, false);
+    for(int texel = 0; texel < 16; ++texel)
+        pTexels[texel * 4 + 3] = 255;
+}
+
+void BcDecoder::DecodeBlockBC3(const uint8_t* pBlock, uint8_t* pTexels)
+{
+    // alpha block followed by the color block
+    decodeColorBlock(pBlock + 8, pTexels, true);
+    decodeChannelBlock(pBlock, pTexels + 3);
+}
+
+void BcDecoder::DecodeBlockBC5(const uint8_t* pBlock, uint8_t* pTexels)
+{
+    // red block followed by the green block
+    for(int texel = 0; texel < 16; ++texel)
+    {
+        pTexels[texel * 4 + 2] = 0;
+        pTexels[texel * 4 + 3] = 255;
+    }
+    decodeChannelBlock(pBlock, pTexels);
+    decodeChannelBlock(pBlock + 8, pTexels + 1);
+}
+
+void BcDecoder::DecodeBlockBC7(const uint8_t* pBlock, uint8_t* pTexels)
+{
+    BlockBitReader reader(pBlock);
+
+    // mode: position of the lowest set bit
+    uint32_t mode = 0;
+    while(mode < 8 && reader.Read(1) == 0)
+        ++mode;
+
+    // reserved mode: transparent black
+    if(mode == 8)
+    {
+        memset(pTexels, 0, 16 * 4);
+        return;
+    }
+
+    const Bc7ModeInfo& info = BC7_MODES[mode];
+    uint32_t partition = reader.Read(info.partitionBits);
+    uint32_t rotation = reader.Read(info.rotationBits);
+    uint32_t indexSelection = reader.Read(info.indexSelectionBits);
+
+    // endpoints: all endpoints of a channel are stored together
+    uint32_t endpointCount = info.subsetCount * 2u;
+    uint32_t endpoints[6][4] = {};
+    for(uint32_t channel = 0; channel < 3; ++channel)
+    {
+        for(uint32_t endpoint = 0; endpoint < endpointCount; ++endpoint)
+            endpoints[endpoint][channel] = reader.Read(info.colorBits);
+    }
+    for(uint32_t endpoint = 0; endpoint < endpointCount; ++endpoint)
+        endpoints[endpoint][3] = info.alphaBits > 0 ? reader.Read(info.alphaBits) : 255;
+
+    // p-bits: extra lowest bit shared by all channels of an endpoint
+    uint32_t colorBits = info.colorBits;
+    uint32_t alphaBits = info.alphaBits;
+    if(info.endpointPBits || info.sharedPBits)
+    {
+        uint32_t pBits[6] = {};
+        if(info.endpointPBits)
+        {
+            for(uint32_t endpoint = 0; endpoint < endpointCount; ++endpoint)
+                pBits[endpoint] = reader.Read(1);
+        }
+        else
+        {
+            for(uint32_t subset = 0; subset < info.subsetCount; ++subset)
+            {
+                uint32_t pBit = reader.Read(1);
+                pBits[subset * 2] = pBit;
+                pBits[subset * 2 + 1] = pBit;
+            }
+        }
+
+        for(uint32_t endpoint = 0; endpoint < endpointCount; ++endpoint)
+        {
+            for(uint32_t channel = 0; channel < 3; ++channel)
+                endpoints[endpoint][channel] = (endpoints[endpoint][channel] << 1) | pBits[endpoint];
+            if(info.alphaBits > 0)
+                endpoints[endpoint][3] = (endpoints[endpoint][3] << 1) | pBits[endpoint];
+        }
+        colorBits += 1;
+        if(info.alphaBits > 0)
+            alphaBits += 1;
+    }
+
+    uint8_t expanded[6][4];
+    for(uint32_t endpoint = 0; endpoint < endpointCount; ++endpoint)
+    {
+        for(uint32_t channel = 0; channel < 3; ++channel)
+            expanded[endpoint][channel] = expandBits(endpoints[endpoint][channel], colorBits);
+        expanded[endpoint][3] = info.alphaBits > 0 ? expandBits(endpoints[endpoint][3], alphaBits) : 255;
+    }
+
+    // subset and anchor of every texel
+    uint32_t subsets[16] = {};
+    bool isAnchor[16] = {};
+    isAnchor[0] = true;
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        if(info.subsetCount == 2)
+            subsets[texel] = (BC7_PARTITIONS_2[partition] >> texel) & 0x1;
+        else if(info.subsetCount == 3)
+            subsets[texel] = (BC7_PARTITIONS_3[partition] >> (2 * texel)) & 0x3;
+    }
+    if(info.subsetCount == 2)
+        isAnchor[BC7_ANCHORS_2_SUBSET_1[partition]] = true;
+    else if(info.subsetCount == 3)
+    {
+        isAnchor[BC7_ANCHORS_3_SUBSET_1[partition]] = true;
+        isAnchor[BC7_ANCHORS_3_SUBSET_2[partition]] = true;
+    }
+
+    // indices: anchors store one bit less
+    uint32_t indices[16] = {};
+    for(uint32_t texel = 0; texel < 16; ++texel)
+        indices[texel] = reader.Read(isAnchor[texel] ? info.indexBits - 1u : info.indexBits);
+
+    uint32_t secondaryIndices[16] = {};
+    if(info.secondaryIndexBits > 0)
+    {
+        for(uint32_t texel = 0; texel < 16; ++texel)
+            secondaryIndices[texel] = reader.Read(texel == 0 ? info.secondaryIndexBits - 1u : info.secondaryIndexBits);
+    }
+
+    auto weight = [](uint32_t bitCount, uint32_t index) -> uint32_t
+    {
+        if(bitCount == 2)
+            return BC7_WEIGHTS_2[index];
+        if(bitCount == 3)
+            return BC7_WEIGHTS_3[index];
+        return BC7_WEIGHTS_4[index];
+    };
+
+    // interpolate
+    // >> modes with two index sets: color and alpha use separate indices, the index selection bit swaps them
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        const uint8_t* e0 = expanded[subsets[texel] * 2];
+        const uint8_t* e1 = expanded[subsets[texel] * 2 + 1];
+
+        uint32_t colorWeight = weight(info.indexBits, indices[texel]);
+        uint32_t alphaWeight = colorWeight;
+        if(info.secondaryIndexBits > 0)
+        {
+            uint32_t secondaryWeight = weight(info.secondaryIndexBits, secondaryIndices[texel]);
+            if(indexSelection)
+                colorWeight = secondaryWeight;
+            else
+                alphaWeight = secondaryWeight;
+        }
+
+        uint8_t* pTexel = pTexels + texel * 4;
+        for(uint32_t channel = 0; channel < 3; ++channel)
+            pTexel[channel] = interpolate(e0[channel], e1[channel], colorWeight);
+        pTexel[3] = interpolate(e0[3], e1[3], alphaWeight);
+
+        // rotation: swap alpha with a color channel
+        if(rotation > 0)
+            std::swap(pTexel[3], pTexel[rotation - 1]);
+    }
+}
+
+/// @brief decompresses all levels of a block compressed texture to RGBA8 (srgb formats to RGBA8_SRGB)
+/// @return false when the source format is not block compressed
+bool BcDecoder::Decompress(const TextureData& source, TextureData& destination)
+{
+    void (*decodeBlock)(const uint8_t*, uint8_t*) = nullptr;
+    switch(source.format)
+    {
+        case TextureFormat::BC1_UNORM:
+        case TextureFormat::BC1_SRGB: decodeBlock = &DecodeBlockBC1; break;
+        case TextureFormat::BC1_RGB_UNORM:
+        case TextureFormat::BC1_RGB_SRGB: decodeBlock = &DecodeBlockBC1RGB; break;
+        case TextureFormat::BC3_UNORM:
+        case TextureFormat::BC3_SRGB: decodeBlock = &DecodeBlockBC3; break;
+        case TextureFormat::BC5_UNORM: decodeBlock = &DecodeBlockBC5; break;
+        case TextureFormat::BC7_UNORM:
+        case TextureFormat::BC7_SRGB: decodeBlock = &DecodeBlockBC7; break;
+        default:
+            std::cout << "error: texture: format is not block compressed!";
+            return false;
+    }
+
+    uint32_t bytesPerBlock = TextureFormats::GetBytesPerBlock(source.format);
+
+    destination.format = TextureFormats::IsSrgb(source.format) ? TextureFormat::RGBA8_SRGB : TextureFormat::RGBA8_UNORM;
+    destination.width = source.width;
+    destination.height = source.height;
+    destination.levels.clear();
+    destination.levels.resize(source.levels.size());
+    for(size_t level = 0; level < source.levels.size(); ++level)
+    {
+        const TextureLevel& sourceLevel = source.levels[level];
+        TextureLevel& destinationLevel = destination.levels[level];
+        destinationLevel.width = sourceLevel.width;
+        destinationLevel.height = sourceLevel.height;
+        destinationLevel.data.resize(static_cast<size_t>(sourceLevel.width) * sourceLevel.height * 4);
+
+        uint32_t blocksWide = (sourceLevel.width + 3) / 4;
+        uint32_t blocksHigh = (sourceLevel.height + 3) / 4;
+        if(sourceLevel.data.size() < static_cast<size_t>(blocksWide) * blocksHigh * bytesPerBlock)
+        {
+            std::cout << "error: texture: truncated block data!";
+            return false;
+        }
+
+        // decode block by block, partial blocks at the edges are clipped
+        uint8_t texels[16 * 4];
+        for(uint32_t blockY = 0; blockY < blocksHigh; ++blockY)
+        {
+            for(uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+            {
+                const uint8_t* pBlock = sourceLevel.data.data() + (static_cast<size_t>(blockY) * blocksWide + blockX) * bytesPerBlock;
+                decodeBlock(pBlock, texels);
+
+                uint32_t rows = std::min(4u, sourceLevel.height - blockY * 4);
+                uint32_t columns = std::min(4u, sourceLevel.width - blockX * 4);
+                for(uint32_t row = 0; row < rows; ++row)
+                {
+                    size_t dstOffset = ((static_cast<size_t>(blockY) * 4 + row) * sourceLevel.width + blockX * 4) * 4;
+                    memcpy(destinationLevel.data.data() + dstOffset, texels + row * 16, columns * 4);
+                }
+            }
+        }
+    }
+    return true;
+}
\ No newline at end of file
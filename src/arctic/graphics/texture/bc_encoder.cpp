@@ -0,0 +1,709 @@
+#include "arctic/graphics/texture/bc_encoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ARCTIC_BC_ENCODER_X86
+#include <immintrin.h>
+#endif
+
+// texels of a block split into channels, aligned for the simd kernels
+struct alignas(32) BlockChannels
+{
+    int32_t r[16];
+    int32_t g[16];
+    int32_t b[16];
+    int32_t a[16];
+};
+
+// colors the texels of a block can be encoded as
+struct alignas(32) Palette
+{
+    int32_t r[16];
+    int32_t g[16];
+    int32_t b[16];
+    int32_t a[16];
+    uint32_t size = 0;
+};
+
+// finds the closest palette entry of every texel
+// >> error is the sum of the squared channel differences, scaled by the channel weights (r, g, b, a)
+// >> ties resolve to the lowest index in every kernel, so all kernels produce identical blocks
+using SelectIndicesFunction = uint32_t (*)(const BlockChannels& block, const Palette& palette, const int32_t* pWeights, uint8_t* pIndices);
+
+struct PresetParameters
+{
+    bool usePrincipalAxis;     // evaluate the principal axis endpoints besides the bounding box, refine the better
+    uint32_t refineIterations; // least squares refinements, stops early when the error does not improve
+    bool searchPBits;          // bc7: evaluate all p-bit combinations instead of rounding each endpoint
+};
+
+// bc1: green weighs most (luminance), alpha only separates transparent from opaque texels and outweighs any color error
+static const int32_t BC1_ERROR_WEIGHTS[4] = { 3, 6, 1, 16 };
+static const int32_t BC7_ERROR_WEIGHTS[4] = { 1, 1, 1, 1 };
+
+// weight of the second endpoint per index, negative: texel is not interpolated (transparent)
+static const float BC1_WEIGHTS_4[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+static const float BC1_WEIGHTS_3[4] = { 0.0f, 1.0f, 0.5f, -1.0f };
+
+static const int32_t BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static PresetParameters getPresetParameters(EncodePreset preset)
+{
+    switch(preset)
+    {
+        case EncodePreset::Fast: return { false, 0, false };
+        case EncodePreset::Quality: return { true, 8, true };
+        default: return { true, 1, true };
+    }
+}
+
+// >> kernels
+
+static uint32_t selectIndicesScalar(const BlockChannels& block, const Palette& palette, const int32_t* pWeights, uint8_t* pIndices)
+{
+    uint32_t totalError = 0;
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        int32_t bestError = std::numeric_limits<int32_t>::max();
+        uint32_t bestIndex = 0;
+        for(uint32_t entry = 0; entry < palette.size; ++entry)
+        {
+            int32_t dr = block.r[texel] - palette.r[entry];
+            int32_t dg = block.g[texel] - palette.g[entry];
+            int32_t db = block.b[texel] - palette.b[entry];
+            int32_t da = block.a[texel] - palette.a[entry];
+            int32_t error = dr * dr * pWeights[0] + dg * dg * pWeights[1] + db * db * pWeights[2] + da * da * pWeights[3];
+            if(error < bestError)
+            {
+                bestError = error;
+                bestIndex = entry;
+            }
+        }
+        pIndices[texel] = static_cast<uint8_t>(bestIndex);
+        totalError += static_cast<uint32_t>(bestError);
+    }
+    return totalError;
+}
+
+#ifdef ARCTIC_BC_ENCODER_X86
+/// @brief four texels per iteration (32 bit lanes), needs SSE4.1 for the 32 bit multiply, min and blend
+__attribute__((target("sse4.1")))
+static uint32_t selectIndicesSse41(const BlockChannels& block, const Palette& palette, const int32_t* pWeights, uint8_t* pIndices)
+{
+    const __m128i weightR = _mm_set1_epi32(pWeights[0]);
+    const __m128i weightG = _mm_set1_epi32(pWeights[1]);
+    const __m128i weightB = _mm_set1_epi32(pWeights[2]);
+    const __m128i weightA = _mm_set1_epi32(pWeights[3]);
+
+    __m128i totalError = _mm_setzero_si128();
+    for(uint32_t texel = 0; texel < 16; texel += 4)
+    {
+        const __m128i r = _mm_load_si128(reinterpret_cast<const __m128i*>(block.r + texel));
+        const __m128i g = _mm_load_si128(reinterpret_cast<const __m128i*>(block.g + texel));
+        const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(block.b + texel));
+        const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(block.a + texel));
+
+        __m128i bestError = _mm_set1_epi32(std::numeric_limits<int32_t>::max());
+        __m128i bestIndex = _mm_setzero_si128();
+        for(uint32_t entry = 0; entry < palette.size; ++entry)
+        {
+            __m128i dr = _mm_sub_epi32(r, _mm_set1_epi32(palette.r[entry]));
+            __m128i dg = _mm_sub_epi32(g, _mm_set1_epi32(palette.g[entry]));
+            __m128i db = _mm_sub_epi32(b, _mm_set1_epi32(palette.b[entry]));
+            __m128i da = _mm_sub_epi32(a, _mm_set1_epi32(palette.a[entry]));
+
+            __m128i error = _mm_mullo_epi32(_mm_mullo_epi32(dr, dr), weightR);
+            error = _mm_add_epi32(error, _mm_mullo_epi32(_mm_mullo_epi32(dg, dg), weightG));
+            error = _mm_add_epi32(error, _mm_mullo_epi32(_mm_mullo_epi32(db, db), weightB));
+            error = _mm_add_epi32(error, _mm_mullo_epi32(_mm_mullo_epi32(da, da), weightA));
+
+            __m128i isBetter = _mm_cmplt_epi32(error, bestError);
+            bestError = _mm_min_epi32(error, bestError);
+            bestIndex = _mm_blendv_epi8(bestIndex, _mm_set1_epi32(static_cast<int32_t>(entry)), isBetter);
+        }
+        totalError = _mm_add_epi32(totalError, bestError);
+
+        alignas(16) int32_t indices[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(indices), bestIndex);
+        for(uint32_t lane = 0; lane < 4; ++lane)
+            pIndices[texel + lane] = static_cast<uint8_t>(indices[lane]);
+    }
+
+    alignas(16) uint32_t errors[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(errors), totalError);
+    return errors[0] + errors[1] + errors[2] + errors[3];
+}
+
+/// @brief eight texels per iteration (32 bit lanes)
+__attribute__((target("avx2")))
+static uint32_t selectIndicesAvx2(const BlockChannels& block, const Palette& palette, const int32_t* pWeights, uint8_t* pIndices)
+{
+    const __m256i weightR = _mm256_set1_epi32(pWeights[0]);
+    const __m256i weightG = _mm256_set1_epi32(pWeights[1]);
+    const __m256i weightB = _mm256_set1_epi32(pWeights[2]);
+    const __m256i weightA = _mm256_set1_epi32(pWeights[3]);
+
+    __m256i totalError = _mm256_setzero_si256();
+    for(uint32_t texel = 0; texel < 16; texel += 8)
+    {
+        const __m256i r = _mm256_load_si256(reinterpret_cast<const __m256i*>(block.r + texel));
+        const __m256i g = _mm256_load_si256(reinterpret_cast<const __m256i*>(block.g + texel));
+        const __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(block.b + texel));
+        const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(block.a + texel));
+
+        __m256i bestError = _mm256_set1_epi32(std::numeric_limits<int32_t>::max());
+        __m256i bestIndex = _mm256_setzero_si256();
+        for(uint32_t entry = 0; entry < palette.size; ++entry)
+        {
+            __m256i dr = _mm256_sub_epi32(r, _mm256_set1_epi32(palette.r[entry]));
+            __m256i dg = _mm256_sub_epi32(g, _mm256_set1_epi32(palette.g[entry]));
+            __m256i db = _mm256_sub_epi32(b, _mm256_set1_epi32(palette.b[entry]));
+            __m256i da = _mm256_sub_epi32(a, _mm256_set1_epi32(palette.a[entry]));
+
+            __m256i error = _mm256_mullo_epi32(_mm256_mullo_epi32(dr, dr), weightR);
+            error = _mm256_add_epi32(error, _mm256_mullo_epi32(_mm256_mullo_epi32(dg, dg), weightG));
+            error = _mm256_add_epi32(error, _mm256_mullo_epi32(_mm256_mullo_epi32(db, db), weightB));
+            error = _mm256_add_epi32(error, _mm256_mullo_epi32(_mm256_mullo_epi32(da, da), weightA));
+
+            __m256i isBetter = _mm256_cmpgt_epi32(bestError, error);
+            bestError = _mm256_min_epi32(error, bestError);
+            bestIndex = _mm256_blendv_epi8(bestIndex, _mm256_set1_epi32(static_cast<int32_t>(entry)), isBetter);
+        }
+        totalError = _mm256_add_epi32(totalError, bestError);
+
+        alignas(32) int32_t indices[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(indices), bestIndex);
+        for(uint32_t lane = 0; lane < 8; ++lane)
+            pIndices[texel + lane] = static_cast<uint8_t>(indices[lane]);
+    }
+
+    alignas(32) uint32_t errors[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(errors), totalError);
+    uint32_t sum = 0;
+    for(uint32_t lane = 0; lane < 8; ++lane)
+        sum += errors[lane];
+    return sum;
+}
+#endif
+
+static SelectIndicesFunction getSelectIndicesFunction(SimdLevel requestedLevel)
+{
+    SimdLevel level = std::min(requestedLevel, BcEncoder::GetSupportedSimdLevel());
+#ifdef ARCTIC_BC_ENCODER_X86
+    if(level == SimdLevel::AVX2)
+        return &selectIndicesAvx2;
+    if(level == SimdLevel::SSE41)
+        return &selectIndicesSse41;
+#endif
+    return &selectIndicesScalar;
+}
+
+// >> endpoints
+
+static void loadBlock(const uint8_t* pTexels, BlockChannels& block)
+{
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        block.r[texel] = pTexels[texel * 4 + 0];
+        block.g[texel] = pTexels[texel * 4 + 1];
+        block.b[texel] = pTexels[texel * 4 + 2];
+        block.a[texel] = pTexels[texel * 4 + 3];
+    }
+}
+
+static float getChannel(const BlockChannels& block, uint32_t channel, uint32_t texel)
+{
+    const int32_t* channels[4] = { block.r, block.g, block.b, block.a };
+    return static_cast<float>(channels[channel][texel]);
+}
+
+/// @brief Initial endpoints of the texels in texelMask (bit per texel).
+/// @brief Bounding box: corners of the box, flipped per channel along the direction the channel correlates with red.
+/// @brief Principal axis: extremes of the texels projected on the axis of largest variance (power iteration).
+/// @param channelCount channels considered, remaining channels are set to 255
+static void computeEndpoints(const BlockChannels& block, uint32_t channelCount, uint32_t texelMask, bool usePrincipalAxis, float e0[4], float e1[4])
+{
+    float mean[4] = {};
+    uint32_t texelCount = 0;
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        if(!(texelMask & (1u << texel)))
+            continue;
+        for(uint32_t channel = 0; channel < channelCount; ++channel)
+            mean[channel] += getChannel(block, channel, texel);
+        ++texelCount;
+    }
+    for(uint32_t channel = 0; channel < 4; ++channel)
+    {
+        mean[channel] = channel < channelCount ? mean[channel] / static_cast<float>(texelCount) : 255.0f;
+        e0[channel] = mean[channel];
+        e1[channel] = mean[channel];
+    }
+
+    // covariance
+    float covariance[4][4] = {};
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        if(!(texelMask & (1u << texel)))
+            continue;
+        float delta[4] = {};
+        for(uint32_t channel = 0; channel < channelCount; ++channel)
+            delta[channel] = getChannel(block, channel, texel) - mean[channel];
+        for(uint32_t i = 0; i < channelCount; ++i)
+        {
+            for(uint32_t j = 0; j < channelCount; ++j)
+                covariance[i][j] += delta[i] * delta[j];
+        }
+    }
+
+    if(!usePrincipalAxis)
+    {
+        for(uint32_t channel = 0; channel < channelCount; ++channel)
+        {
+            float minValue = 255.0f;
+            float maxValue = 0.0f;
+            for(uint32_t texel = 0; texel < 16; ++texel)
+            {
+                if(!(texelMask & (1u << texel)))
+                    continue;
+                minValue = std::min(minValue, getChannel(block, channel, texel));
+                maxValue = std::max(maxValue, getChannel(block, channel, texel));
+            }
+            bool isFlipped = channel > 0 && covariance[0][channel] < 0.0f;
+            e0[channel] = isFlipped ? maxValue : minValue;
+            e1[channel] = isFlipped ? minValue : maxValue;
+        }
+        return;
+    }
+
+    // power iteration, starts with the row of the channel with the largest variance
+    uint32_t largestChannel = 0;
+    for(uint32_t channel = 1; channel < channelCount; ++channel)
+    {
+        if(covariance[channel][channel] > covariance[largestChannel][largestChannel])
+            largestChannel = channel;
+    }
+    if(covariance[largestChannel][largestChannel] <= 0.0f)
+        return; // flat block
+
+    float axis[4] = {};
+    for(uint32_t channel = 0; channel < channelCount; ++channel)
+        axis[channel] = covariance[largestChannel][channel];
+
+    for(uint32_t iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[4] = {};
+        float length = 0.0f;
+        for(uint32_t i = 0; i < channelCount; ++i)
+        {
+            for(uint32_t j = 0; j < channelCount; ++j)
+                next[i] += covariance[i][j] * axis[j];
+            length = std::max(length, std::fabs(next[i]));
+        }
+        if(length <= 0.0f)
+            break;
+        for(uint32_t channel = 0; channel < channelCount; ++channel)
+            axis[channel] = next[channel] / length;
+    }
+
+    float length = 0.0f;
+    for(uint32_t channel = 0; channel < channelCount; ++channel)
+        length += axis[channel] * axis[channel];
+    length = std::sqrt(length);
+    for(uint32_t channel = 0; channel < channelCount; ++channel)
+        axis[channel] /= length;
+
+    // project the texels on the axis
+    float minProjection = std::numeric_limits<float>::max();
+    float maxProjection = std::numeric_limits<float>::lowest();
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        if(!(texelMask & (1u << texel)))
+            continue;
+        float projection = 0.0f;
+        for(uint32_t channel = 0; channel < channelCount; ++channel)
+            projection += (getChannel(block, channel, texel) - mean[channel]) * axis[channel];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+
+    for(uint32_t channel = 0; channel < channelCount; ++channel)
+    {
+        e0[channel] = std::clamp(mean[channel] + axis[channel] * minProjection, 0.0f, 255.0f);
+        e1[channel] = std::clamp(mean[channel] + axis[channel] * maxProjection, 0.0f, 255.0f);
+    }
+}
+
+/// @brief endpoints with the least squared error for the texels, given the palette index of every texel
+/// @param pWeights weight of e1 per palette index, texels with a negative weight are ignored
+/// @return false when the system is singular (all texels share one weight)
+static bool refineEndpoints(const BlockChannels& block, uint32_t channelCount, const uint8_t* pIndices, const float* pWeights, float e0[4], float e1[4])
+{
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    float ax[4] = {};
+    float bx[4] = {};
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        float weight = pWeights[pIndices[texel]];
+        if(weight < 0.0f)
+            continue;
+
+        float inverseWeight = 1.0f - weight;
+        aa += inverseWeight * inverseWeight;
+        ab += inverseWeight * weight;
+        bb += weight * weight;
+        for(uint32_t channel = 0; channel < channelCount; ++channel)
+        {
+            float value = getChannel(block, channel, texel);
+            ax[channel] += inverseWeight * value;
+            bx[channel] += weight * value;
+        }
+    }
+
+    float determinant = aa * bb - ab * ab;
+    if(std::fabs(determinant) < 1e-6f)
+        return false;
+
+    for(uint32_t channel = 0; channel < channelCount; ++channel)
+    {
+        e0[channel] = std::clamp((ax[channel] * bb - bx[channel] * ab) / determinant, 0.0f, 255.0f);
+        e1[channel] = std::clamp((bx[channel] * aa - ax[channel] * ab) / determinant, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+// >> bc1
+
+struct Bc1Candidate
+{
+    uint16_t color0 = 0;
+    uint16_t color1 = 0;
+    uint8_t indices[16] = {};
+    uint32_t error = std::numeric_limits<uint32_t>::max();
+};
+
+static uint16_t packColor565(const float color[4])
+{
+    uint32_t r = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+    uint32_t g = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+    uint32_t b = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static void unpackColor565(uint16_t color, int32_t& r, int32_t& g, int32_t& b)
+{
+    uint32_t r5 = color >> 11;
+    uint32_t g6 = (color >> 5) & 0x3f;
+    uint32_t b5 = color & 0x1f;
+    r = static_cast<int32_t>((r5 << 3) | (r5 >> 2));
+    g = static_cast<int32_t>((g6 << 2) | (g6 >> 4));
+    b = static_cast<int32_t>((b5 << 3) | (b5 >> 2));
+}
+
+/// @brief quantizes the endpoints and selects the indices, the endpoint order selects the mode
+/// @brief >> opaque blocks: color0 > color1 (four colors), blocks with transparent texels: color0 <= color1 (three colors + transparent)
+static void evaluateBC1(const BlockChannels& block, const float e0[4], const float e1[4], bool hasTransparency, SelectIndicesFunction selectIndices, Bc1Candidate& candidate)
+{
+    candidate.color0 = packColor565(e0);
+    candidate.color1 = packColor565(e1);
+    if(hasTransparency ? candidate.color0 > candidate.color1 : candidate.color0 < candidate.color1)
+        std::swap(candidate.color0, candidate.color1);
+
+    // palette as the decoder builds it
+    Palette palette{};
+    palette.size = 4;
+    unpackColor565(candidate.color0, palette.r[0], palette.g[0], palette.b[0]);
+    unpackColor565(candidate.color1, palette.r[1], palette.g[1], palette.b[1]);
+    int32_t* channels[3] = { palette.r, palette.g, palette.b };
+    for(int32_t* channel : channels)
+    {
+        if(candidate.color0 > candidate.color1)
+        {
+            channel[2] = (2 * channel[0] + channel[1] + 1) / 3;
+            channel[3] = (channel[0] + 2 * channel[1] + 1) / 3;
+        }
+        else
+        {
+            channel[2] = (channel[0] + channel[1] + 1) / 2;
+            channel[3] = 0;
+        }
+    }
+    palette.a[0] = 255;
+    palette.a[1] = 255;
+    palette.a[2] = 255;
+    palette.a[3] = candidate.color0 > candidate.color1 ? 255 : 0;
+
+    candidate.error = selectIndices(block, palette, BC1_ERROR_WEIGHTS, candidate.indices);
+}
+
+void BcEncoder::EncodeBlockBC1(const uint8_t* pTexels, uint8_t* pBlock, const BcEncodeSettings& settings)
+{
+    BlockChannels block;
+    loadBlock(pTexels, block);
+
+    // bc1 alpha is 1 bit: texels below half coverage are transparent
+    uint32_t opaqueMask = 0;
+    for(uint32_t texel = 0; texel < 16; ++texel)
+    {
+        block.a[texel] = block.a[texel] < 128 ? 0 : 255;
+        if(block.a[texel] == 255)
+            opaqueMask |= 1u << texel;
+    }
+
+    // fully transparent: three color mode, all texels use the transparent index
+    if(opaqueMask == 0)
+    {
+        memset(pBlock, 0, 4);
+        memset(pBlock + 4, 0xff, 4);
+        return;
+    }
+
+    bool hasTransparency = opaqueMask != 0xffff;
+    PresetParameters parameters = getPresetParameters(settings.preset);
+    SelectIndicesFunction selectIndices = getSelectIndicesFunction(settings.simdLevel);
+
+    float e0[4];
+    float e1[4];
+    computeEndpoints(block, 3, opaqueMask, false, e0, e1);
+
+    Bc1Candidate best;
+    evaluateBC1(block, e0, e1, hasTransparency, selectIndices, best);
+
+    if(parameters.usePrincipalAxis)
+    {
+        float axisE0[4];
+        float axisE1[4];
+        computeEndpoints(block, 3, opaqueMask, true, axisE0, axisE1);
+
+        Bc1Candidate candidate;
+        evaluateBC1(block, axisE0, axisE1, hasTransparency, selectIndices, candidate);
+        if(candidate.error < best.error)
+            best = candidate;
+    }
+
+    for(uint32_t iteration = 0; iteration < parameters.refineIterations && best.error > 0; ++iteration)
+    {
+        const float* pWeights = best.color0 > best.color1 ? BC1_WEIGHTS_4 : BC1_WEIGHTS_3;
+        if(!refineEndpoints(block, 3, best.indices, pWeights, e0, e1))
+            break;
+
+        Bc1Candidate candidate;
+        evaluateBC1(block, e0, e1, hasTransparency, selectIndices, candidate);
+        if(candidate.error >= best.error)
+            break;
+        best = candidate;
+    }
+
+    // block: color0, color1, 2 bit indices (little endian)
+    uint32_t indices = 0;
+    for(uint32_t texel = 0; texel < 16; ++texel)
+        indices |= static_cast<uint32_t>(best.indices[texel]) << (2 * texel);
+
+    pBlock[0] = static_cast<uint8_t>(best.color0);
+    pBlock[1] = static_cast<uint8_t>(best.color0 >> 8);
+    pBlock[2] = static_cast<uint8_t>(best.color1);
+    pBlock[3] = static_cast<uint8_t>(best.color1 >> 8);
+    for(uint32_t i = 0; i < 4; ++i)
+        pBlock[4 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+
+// >> bc7
+
+struct Bc7Candidate
+{
+    uint8_t endpoints[2][4] = {}; // 7 bit values with the p-bit appended
+    uint8_t indices[16] = {};
+    uint32_t error = std::numeric_limits<uint32_t>::max();
+};
+
+// writes a 128 bit block from the lowest bit up
+class BlockBitWriter
+{
+public:
+    explicit BlockBitWriter(uint8_t* pBlock) : pBlock(pBlock)
+    {
+        memset(pBlock, 0, 16);
+    }
+
+    void Write(uint32_t value, uint32_t bitCount)
+    {
+        for(uint32_t i = 0; i < bitCount; ++i, ++position)
+        {
+            if((value >> i) & 1)
+                pBlock[position / 8] |= static_cast<uint8_t>(1u << (position % 8));
+        }
+    }
+
+private:
+    uint8_t* pBlock = nullptr;
+    uint32_t position = 0;
+};
+
+/// @brief rounds the endpoint to 7 bits per channel with the given p-bit as shared lowest bit
+static void quantizeEndpointBC7(const float endpoint[4], uint32_t pBit, uint8_t quantized[4])
+{
+    for(uint32_t channel = 0; channel < 4; ++channel)
+    {
+        long value = std::lround((endpoint[channel] - static_cast<float>(pBit)) * 0.5f);
+        quantized[channel] = static_cast<uint8_t>((std::clamp(value, 0L, 127L) << 1) | pBit);
+    }
+}
+
+static float getQuantizationError(const float endpoint[4], const uint8_t quantized[4])
+{
+    float error = 0.0f;
+    for(uint32_t channel = 0; channel < 4; ++channel)
+    {
+        float delta = endpoint[channel] - static_cast<float>(quantized[channel]);
+        error += delta * delta;
+    }
+    return error;
+}
+
+static void evaluateBC7(const BlockChannels& block, const uint8_t e0[4], const uint8_t e1[4], SelectIndicesFunction selectIndices, Bc7Candidate& candidate)
+{
+    memcpy(candidate.endpoints[0], e0, 4);
+    memcpy(candidate.endpoints[1], e1, 4);
+
+    // palette as the decoder interpolates it
+    Palette palette{};
+    palette.size = 16;
+    int32_t* channels[4] = { palette.r, palette.g, palette.b, palette.a };
+    for(uint32_t entry = 0; entry < 16; ++entry)
+    {
+        int32_t weight = BC7_WEIGHTS_4[entry];
+        for(uint32_t channel = 0; channel < 4; ++channel)
+            channels[channel][entry] = ((64 - weight) * e0[channel] + weight * e1[channel] + 32) >> 6;
+    }
+
+    candidate.error = selectIndices(block, palette, BC7_ERROR_WEIGHTS, candidate.indices);
+}
+
+/// @brief quantizes the endpoints and keeps the result when it beats best
+/// @param searchPBits evaluate all four p-bit combinations, otherwise each endpoint takes the p-bit closest to it
+static void encodeEndpointsBC7(const BlockChannels& block, const float e0[4], const float e1[4], bool searchPBits, SelectIndicesFunction selectIndices, Bc7Candidate& best)
+{
+    uint8_t quantized[2][2][4]; // endpoint, p-bit, channel
+    for(uint32_t pBit = 0; pBit < 2; ++pBit)
+    {
+        quantizeEndpointBC7(e0, pBit, quantized[0][pBit]);
+        quantizeEndpointBC7(e1, pBit, quantized[1][pBit]);
+    }
+
+    if(searchPBits)
+    {
+        for(uint32_t pBit0 = 0; pBit0 < 2; ++pBit0)
+        {
+            for(uint32_t pBit1 = 0; pBit1 < 2; ++pBit1)
+            {
+                Bc7Candidate candidate;
+                evaluateBC7(block, quantized[0][pBit0], quantized[1][pBit1], selectIndices, candidate);
+                if(candidate.error < best.error)
+                    best = candidate;
+            }
+        }
+        return;
+    }
+
+    uint32_t pBit0 = getQuantizationError(e0, quantized[0][1]) < getQuantizationError(e0, quantized[0][0]) ? 1 : 0;
+    uint32_t pBit1 = getQuantizationError(e1, quantized[1][1]) < getQuantizationError(e1, quantized[1][0]) ? 1 : 0;
+
+    Bc7Candidate candidate;
+    evaluateBC7(block, quantized[0][pBit0], quantized[1][pBit1], selectIndices, candidate);
+    if(candidate.error < best.error)
+        best = candidate;
+}
+
+void BcEncoder::EncodeBlockBC7(const uint8_t* pTexels, uint8_t* pBlock, const BcEncodeSettings& settings)
+{
+    BlockChannels block;
+    loadBlock(pTexels, block);
+
+    PresetParameters parameters = getPresetParameters(settings.preset);
+    SelectIndicesFunction selectIndices = getSelectIndicesFunction(settings.simdLevel);
+
+    float e0[4];
+    float e1[4];
+    computeEndpoints(block, 4, 0xffff, false, e0, e1);
+
+    Bc7Candidate best;
+    encodeEndpointsBC7(block, e0, e1, parameters.searchPBits, selectIndices, best);
+
+    if(parameters.usePrincipalAxis)
+    {
+        computeEndpoints(block, 4, 0xffff, true, e0, e1);
+        encodeEndpointsBC7(block, e0, e1, parameters.searchPBits, selectIndices, best);
+    }
+
+    float weights[16];
+    for(uint32_t index = 0; index < 16; ++index)
+        weights[index] = static_cast<float>(BC7_WEIGHTS_4[index]) / 64.0f;
+
+    for(uint32_t iteration = 0; iteration < parameters.refineIterations && best.error > 0; ++iteration)
+    {
+        if(!refineEndpoints(block, 4, best.indices, weights, e0, e1))
+            break;
+
+        uint32_t previousError = best.error;
+        encodeEndpointsBC7(block, e0, e1, parameters.searchPBits, selectIndices, best);
+        if(best.error >= previousError)
+            break;
+    }
+
+    // anchor: the highest index bit of texel 0 is implicit 0, mirror the indices by swapping the endpoints
+    if(best.indices[0] & 0x8)
+    {
+        for(uint32_t channel = 0; channel < 4; ++channel)
+            std::swap(best.endpoints[0][channel], best.endpoints[1][channel]);
+        for(uint32_t texel = 0; texel < 16; ++texel)
+            best.indices[texel] = static_cast<uint8_t>(15 - best.indices[texel]);
+    }
+
+    // block: mode 6 bit, endpoints per channel (r0 r1 g0 g1 b0 b1 a0 a1), p-bits, indices
+    BlockBitWriter writer(pBlock);
+    writer.Write(1u << 6, 7);
+    for(uint32_t channel = 0; channel < 4; ++channel)
+    {
+        writer.Write(best.endpoints[0][channel] >> 1, 7);
+        writer.Write(best.endpoints[1][channel] >> 1, 7);
+    }
+    writer.Write(best.endpoints[0][0] & 1, 1);
+    writer.Write(best.endpoints[1][0] & 1, 1);
+    writer.Write(best.indices[0], 3);
+    for(uint32_t texel = 1; texel < 16; ++texel)
+        writer.Write(best.indices[texel], 4);
+}
+
+// >> dispatch
+
+/// @brief widest kernel the cpu supports, detected once
+SimdLevel BcEncoder::GetSupportedSimdLevel()
+{
+    static const SimdLevel supportedLevel = []()
+    {
+#ifdef ARCTIC_BC_ENCODER_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            return SimdLevel::AVX2;
+        if(__builtin_cpu_supports("sse4.1"))
+            return SimdLevel::SSE41;
+#endif
+        return SimdLevel::Scalar;
+    }();
+    return supportedLevel;
+}
+
+const char* BcEncoder::GetSimdLevelName(SimdLevel level)
+{
+    switch(level)
+    {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE41: return "sse4.1";
+        default: return "scalar";
+    }
+}
\ No newline at end of file
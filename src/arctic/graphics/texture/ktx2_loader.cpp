@@ -0,0 +1,303 @@
+#include "arctic/graphics/texture/ktx2_loader.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// file layout (all values little endian)
+// >> identifier, header, index, level index (one entry per level), data format descriptor, key/value data, level data
+static const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+// packed: the 64 bit offsets follow 13 32 bit values and are not naturally aligned
+#pragma pack(push, 1)
+struct Ktx2Header
+{
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+
+struct Ktx2LevelIndex
+{
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Ktx2Header) == 68, "ktx2 header must match the file layout");
+static_assert(sizeof(Ktx2LevelIndex) == 24, "ktx2 level index must match the file layout");
+
+// VkFormat values, the loader does not depend on the vulkan headers
+static const uint32_t VK_FORMAT_VALUE_R8G8B8A8_UNORM = 37;
+static const uint32_t VK_FORMAT_VALUE_R8G8B8A8_SRGB = 43;
+static const uint32_t VK_FORMAT_VALUE_BC1_RGB_UNORM = 131;
+static const uint32_t VK_FORMAT_VALUE_BC1_RGB_SRGB = 132;
+static const uint32_t VK_FORMAT_VALUE_BC1_RGBA_UNORM = 133;
+static const uint32_t VK_FORMAT_VALUE_BC1_RGBA_SRGB = 134;
+static const uint32_t VK_FORMAT_VALUE_BC3_UNORM = 137;
+static const uint32_t VK_FORMAT_VALUE_BC3_SRGB = 138;
+static const uint32_t VK_FORMAT_VALUE_BC5_UNORM = 141;
+static const uint32_t VK_FORMAT_VALUE_BC7_UNORM = 145;
+static const uint32_t VK_FORMAT_VALUE_BC7_SRGB = 146;
+
+/// @brief khronos data format color model of the format
+static uint32_t getColorModel(TextureFormat format)
+{
+    switch(format)
+    {
+        case TextureFormat::BC1_UNORM:
+        case TextureFormat::BC1_SRGB:
+        case TextureFormat::BC1_RGB_UNORM:
+        case TextureFormat::BC1_RGB_SRGB: return 128;  // KHR_DF_MODEL_BC1A
+        case TextureFormat::BC3_UNORM:
+        case TextureFormat::BC3_SRGB: return 130;  // KHR_DF_MODEL_BC3
+        case TextureFormat::BC5_UNORM: return 132; // KHR_DF_MODEL_BC5
+        case TextureFormat::BC7_UNORM:
+        case TextureFormat::BC7_SRGB: return 134;  // KHR_DF_MODEL_BC7
+        default: return 1;                         // KHR_DF_MODEL_RGBSDA
+    }
+}
+
+bool Ktx2Loader::IsKtx2File(const std::string& path)
+{
+    const std::string extension = ".ktx2";
+    if(path.size() < extension.size())
+        return false;
+
+    std::string pathExtension = path.substr(path.size() - extension.size());
+    std::transform(pathExtension.begin(), pathExtension.end(), pathExtension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return pathExtension == extension;
+}
+
+/// @brief reads a ktx2 file
+/// @return false when the file could not be read or is not supported
+bool Ktx2Loader::Load(const std::string& path, TextureData& texture)
+{
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if(!file.is_open())
+    {
+        std::cout << "error: texture: failed to open " << path << "!";
+        return false;
+    }
+
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    std::vector<uint8_t> buffer(fileSize);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(fileSize));
+    file.close();
+
+    return LoadFromMemory(buffer.data(), buffer.size(), texture);
+}
+
+/// @brief parses a ktx2 container in memory, the level data is copied into the texture
+/// @return false when the container is invalid or not supported
+bool Ktx2Loader::LoadFromMemory(const uint8_t* pData, size_t size, TextureData& texture)
+{
+    // check identifier
+    if(size < sizeof(KTX2_IDENTIFIER) + sizeof(Ktx2Header) || memcmp(pData, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+    {
+        std::cout << "error: texture: not a ktx2 container!";
+        return false;
+    }
+
+    Ktx2Header header{};
+    memcpy(&header, pData + sizeof(KTX2_IDENTIFIER), sizeof(Ktx2Header));
+
+    // check supported content
+    TextureFormat format = FromVkFormat(header.vkFormat);
+    if(format == TextureFormat::Undefined)
+    {
+        std::cout << "error: texture: unsupported ktx2 format " << header.vkFormat << "!";
+        return false;
+    }
+    if(header.supercompressionScheme != 0)
+    {
+        std::cout << "error: texture: supercompressed ktx2 containers are not supported!";
+        return false;
+    }
+    if(header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1)
+    {
+        std::cout << "error: texture: only 2d ktx2 textures are supported!";
+        return false;
+    }
+
+    // read level index
+    // >> level count 0 asks the loader to generate mips, the file then holds level 0 only
+    // >> at most a full chain down to 1x1, deeper levels would shift the size by 32 bits and more
+    uint32_t levelCount = std::max<uint32_t>(1, header.levelCount);
+    uint32_t maxLevelCount = 1;
+    for(uint32_t extent = std::max(header.pixelWidth, header.pixelHeight); extent > 1; extent >>= 1)
+        ++maxLevelCount;
+    if(levelCount > maxLevelCount)
+    {
+        std::cout << "error: texture: ktx2 level count " << levelCount << " exceeds the mip chain!";
+        return false;
+    }
+    size_t levelIndexOffset = sizeof(KTX2_IDENTIFIER) + sizeof(Ktx2Header);
+    if(size < levelIndexOffset + levelCount * sizeof(Ktx2LevelIndex))
+    {
+        std::cout << "error: texture: truncated ktx2 level index!";
+        return false;
+    }
+
+    texture.format = format;
+    texture.width = header.pixelWidth;
+    texture.height = header.pixelHeight;
+    texture.levels.clear();
+    texture.levels.resize(levelCount);
+    for(uint32_t level = 0; level < levelCount; ++level)
+    {
+        Ktx2LevelIndex levelIndex{};
+        memcpy(&levelIndex, pData + levelIndexOffset + level * sizeof(Ktx2LevelIndex), sizeof(Ktx2LevelIndex));
+
+        TextureLevel& textureLevel = texture.levels[level];
+        textureLevel.width = std::max<uint32_t>(1, header.pixelWidth >> level);
+        textureLevel.height = std::max<uint32_t>(1, header.pixelHeight >> level);
+
+        size_t expectedSize = TextureFormats::GetLevelSize(format, textureLevel.width, textureLevel.height);
+        if(levelIndex.byteLength != expectedSize || levelIndex.byteOffset > size || levelIndex.byteLength > size - levelIndex.byteOffset)
+        {
+            std::cout << "error: texture: invalid ktx2 level " << level << "!";
+            texture.levels.clear();
+            return false;
+        }
+
+        const uint8_t* pLevel = pData + levelIndex.byteOffset;
+        textureLevel.data.assign(pLevel, pLevel + levelIndex.byteLength);
+    }
+
+    return true;
+}
+
+/// @brief writes a ktx2 container with a basic data format descriptor (without sample information)
+/// @brief level data is stored smallest level first, as required by the specification
+/// @return false when the file could not be written
+bool Ktx2Loader::Save(const std::string& path, const TextureData& texture)
+{
+    uint32_t levelCount = static_cast<uint32_t>(texture.levels.size());
+    uint32_t vkFormat = ToVkFormat(texture.format);
+    if(levelCount == 0 || vkFormat == 0)
+    {
+        std::cout << "error: texture: nothing to save to " << path << "!";
+        return false;
+    }
+
+    // data format descriptor: total size + basic descriptor block without samples
+    // >> readers in this engine rely on vkFormat only, the color model identifies the block format for other tools
+    const uint32_t dfdBlockSize = 24;
+    const uint32_t dfdSize = sizeof(uint32_t) + dfdBlockSize;
+    uint32_t dfd[dfdSize / sizeof(uint32_t)] = {};
+    dfd[0] = dfdSize;
+    dfd[1] = 0;                         // vendor id (khronos) + descriptor type (basic)
+    dfd[2] = 2 | (dfdBlockSize << 16);  // version (1.3) + block size
+    uint32_t transfer = TextureFormats::IsSrgb(texture.format) ? 2 : 1; // srgb / linear
+    dfd[3] = getColorModel(texture.format) | (1 << 8) | (transfer << 16); // color model, primaries bt709, transfer
+    uint32_t blockSize = TextureFormats::GetBlockSize(texture.format);
+    dfd[4] = (blockSize - 1) | ((blockSize - 1) << 8); // texel block dimensions - 1
+    dfd[5] = TextureFormats::GetBytesPerBlock(texture.format); // bytes plane 0
+
+    // layout: identifier, header, level index, dfd, level data (aligned to 16 bytes, smallest level last)
+    size_t levelIndexOffset = sizeof(KTX2_IDENTIFIER) + sizeof(Ktx2Header);
+    size_t dfdOffset = levelIndexOffset + levelCount * sizeof(Ktx2LevelIndex);
+    size_t dataOffset = (dfdOffset + dfdSize + 15) & ~size_t(15);
+
+    Ktx2Header header{};
+    header.vkFormat = vkFormat;
+    header.typeSize = 1;
+    header.pixelWidth = texture.width;
+    header.pixelHeight = texture.height;
+    header.pixelDepth = 0;
+    header.layerCount = 0;
+    header.faceCount = 1;
+    header.levelCount = levelCount;
+    header.supercompressionScheme = 0;
+    header.dfdByteOffset = static_cast<uint32_t>(dfdOffset);
+    header.dfdByteLength = dfdSize;
+
+    std::vector<Ktx2LevelIndex> levelIndices(levelCount);
+    size_t offset = dataOffset;
+    for(uint32_t level = levelCount; level-- > 0;)
+    {
+        const auto& levelData = texture.levels[level].data;
+        levelIndices[level].byteOffset = offset;
+        levelIndices[level].byteLength = levelData.size();
+        levelIndices[level].uncompressedByteLength = levelData.size();
+        offset = (offset + levelData.size() + 15) & ~size_t(15);
+    }
+
+    std::vector<uint8_t> buffer(offset, 0);
+    memcpy(buffer.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    memcpy(buffer.data() + sizeof(KTX2_IDENTIFIER), &header, sizeof(Ktx2Header));
+    memcpy(buffer.data() + levelIndexOffset, levelIndices.data(), levelCount * sizeof(Ktx2LevelIndex));
+    memcpy(buffer.data() + dfdOffset, dfd, dfdSize);
+    for(uint32_t level = 0; level < levelCount; ++level)
+    {
+        const auto& levelData = texture.levels[level].data;
+        memcpy(buffer.data() + levelIndices[level].byteOffset, levelData.data(), levelData.size());
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+    {
+        std::cout << "error: texture: failed to open " << path << " for writing!";
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return file.good();
+}
+
+/// @return TextureFormat::Undefined when the format is not supported
+TextureFormat Ktx2Loader::FromVkFormat(uint32_t vkFormat)
+{
+    switch(vkFormat)
+    {
+        case VK_FORMAT_VALUE_R8G8B8A8_UNORM: return TextureFormat::RGBA8_UNORM;
+        case VK_FORMAT_VALUE_R8G8B8A8_SRGB: return TextureFormat::RGBA8_SRGB;
+        case VK_FORMAT_VALUE_BC1_RGB_UNORM: return TextureFormat::BC1_RGB_UNORM;
+        case VK_FORMAT_VALUE_BC1_RGB_SRGB: return TextureFormat::BC1_RGB_SRGB;
+        case VK_FORMAT_VALUE_BC1_RGBA_UNORM: return TextureFormat::BC1_UNORM;
+        case VK_FORMAT_VALUE_BC1_RGBA_SRGB: return TextureFormat::BC1_SRGB;
+        case VK_FORMAT_VALUE_BC3_UNORM: return TextureFormat::BC3_UNORM;
+        case VK_FORMAT_VALUE_BC3_SRGB: return TextureFormat::BC3_SRGB;
+        case VK_FORMAT_VALUE_BC5_UNORM: return TextureFormat::BC5_UNORM;
+        case VK_FORMAT_VALUE_BC7_UNORM: return TextureFormat::BC7_UNORM;
+        case VK_FORMAT_VALUE_BC7_SRGB: return TextureFormat::BC7_SRGB;
+        default: return TextureFormat::Undefined;
+    }
+}
+
+/// @return 0 (VK_FORMAT_UNDEFINED) for TextureFormat::Undefined
+uint32_t Ktx2Loader::ToVkFormat(TextureFormat format)
+{
+    switch(format)
+    {
+        case TextureFormat::RGBA8_UNORM: return VK_FORMAT_VALUE_R8G8B8A8_UNORM;
+        case TextureFormat::RGBA8_SRGB: return VK_FORMAT_VALUE_R8G8B8A8_SRGB;
+        case TextureFormat::BC1_UNORM: return VK_FORMAT_VALUE_BC1_RGBA_UNORM;
+        case TextureFormat::BC1_SRGB: return VK_FORMAT_VALUE_BC1_RGBA_SRGB;
+        case TextureFormat::BC1_RGB_UNORM: return VK_FORMAT_VALUE_BC1_RGB_UNORM;
+        case TextureFormat::BC1_RGB_SRGB: return VK_FORMAT_VALUE_BC1_RGB_SRGB;
+        case TextureFormat::BC3_UNORM: return VK_FORMAT_VALUE_BC3_UNORM;
+        case TextureFormat::BC3_SRGB: return VK_FORMAT_VALUE_BC3_SRGB;
+        case TextureFormat::BC5_UNORM: return VK_FORMAT_VALUE_BC5_UNORM;
+        case TextureFormat::BC7_UNORM: return VK_FORMAT_VALUE_BC7_UNORM;
+        case TextureFormat::BC7_SRGB: return VK_FORMAT_VALUE_BC7_SRGB;
+        default: return 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "arctic/graphics/texture/texture_cooker.h"
+#include "arctic/core/utilities/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <vector>
+
+// band of block rows encoded by one task
+struct EncodeBand
+{
+    const TextureLevel* pLevel = nullptr;
+    TextureLevel* pCompressed = nullptr;
+    uint32_t firstRow = 0;
+    uint32_t rowCount = 0;
+};
+
+// bands per worker, smaller bands even out blocks of different cost
+static const uint32_t BANDS_PER_THREAD = 4;
+
+static bool isUncompressedFormat(TextureFormat format)
+{
+    return format == TextureFormat::RGBA8_UNORM || format == TextureFormat::RGBA8_SRGB;
+}
+
+static bool isEncodableFormat(TextureFormat format)
+{
+    return format == TextureFormat::BC1_UNORM || format == TextureFormat::BC1_SRGB ||
+           format == TextureFormat::BC7_UNORM || format == TextureFormat::BC7_SRGB;
+}
+
+static float srgbToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float linearToSrgb(float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static uint8_t toByte(float value)
+{
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+/// @brief encodes the blocks of the band, texels outside the level (partial blocks) repeat the edge texels
+static void encodeBand(const EncodeBand& band, TextureFormat format, const BcEncodeSettings& settings)
+{
+    const TextureLevel& level = *band.pLevel;
+    uint32_t bytesPerBlock = TextureFormats::GetBytesPerBlock(format);
+    uint32_t blocksWide = (level.width + 3) / 4;
+    bool isBC1 = format == TextureFormat::BC1_UNORM || format == TextureFormat::BC1_SRGB;
+
+    uint8_t texels[16 * 4];
+    for(uint32_t blockY = band.firstRow; blockY < band.firstRow + band.rowCount; ++blockY)
+    {
+        for(uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+        {
+            for(uint32_t y = 0; y < 4; ++y)
+            {
+                uint32_t sourceY = std::min(blockY * 4 + y, level.height - 1);
+                for(uint32_t x = 0; x < 4; ++x)
+                {
+                    uint32_t sourceX = std::min(blockX * 4 + x, level.width - 1);
+                    memcpy(texels + (y * 4 + x) * 4, level.data.data() + (static_cast<size_t>(sourceY) * level.width + sourceX) * 4, 4);
+                }
+            }
+
+            uint8_t* pBlock = band.pCompressed->data.data() + (static_cast<size_t>(blockY) * blocksWide + blockX) * bytesPerBlock;
+            if(isBC1)
+                BcEncoder::EncodeBlockBC1(texels, pBlock, settings);
+            else
+                BcEncoder::EncodeBlockBC7(texels, pBlock, settings);
+        }
+    }
+}
+
+/// @brief splits the level into bands of block rows
+static void appendBands(const TextureLevel& level, TextureLevel& compressed, uint32_t threadCount, std::vector<EncodeBand>& bands)
+{
+    uint32_t blocksHigh = (level.height + 3) / 4;
+    uint32_t rowsPerBand = std::max(1u, blocksHigh / (std::max(1u, threadCount) * BANDS_PER_THREAD));
+    for(uint32_t row = 0; row < blocksHigh; row += rowsPerBand)
+    {
+        EncodeBand band{};
+        band.pLevel = &level;
+        band.pCompressed = &compressed;
+        band.firstRow = row;
+        band.rowCount = std::min(rowsPerBand, blocksHigh - row);
+        bands.push_back(band);
+    }
+}
+
+static void encodeBands(const std::vector<EncodeBand>& bands, TextureFormat format, const BcEncodeSettings& settings, ThreadPool& threadPool)
+{
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(bands.size());
+    for(const auto& band : bands)
+        tasks.push_back(threadPool.Submit([band, format, settings]() { encodeBand(band, format, settings); }));
+
+    for(auto& task : tasks)
+        task.wait();
+}
+
+/// @brief builds the mip chain (optional) and compresses all levels
+/// @param source rgba8 texture, srgb sources must be cooked to srgb formats and unorm sources to unorm formats
+/// @return false when the source or the target format are not supported
+bool TextureCooker::Cook(const TextureData& source, const CookSettings& settings, ThreadPool& threadPool, TextureData& cooked)
+{
+    if(!isUncompressedFormat(source.format) || source.levels.empty())
+    {
+        std::cout << "error: texture: cooker expects rgba8 source textures!";
+        return false;
+    }
+    if(TextureFormats::IsSrgb(source.format) != TextureFormats::IsSrgb(settings.format))
+    {
+        std::cout << "error: texture: source and cooked texture must both be srgb or both be linear!";
+        return false;
+    }
+
+    TextureData texture = source;
+    if(settings.generateMips && !GenerateMips(texture))
+        return false;
+
+    if(isUncompressedFormat(settings.format))
+    {
+        cooked = std::move(texture);
+        cooked.format = settings.format;
+        return true;
+    }
+
+    if(!isEncodableFormat(settings.format))
+    {
+        std::cout << "error: texture: cooker only encodes bc1 and bc7!";
+        return false;
+    }
+
+    cooked.format = settings.format;
+    cooked.width = texture.width;
+    cooked.height = texture.height;
+    cooked.levels.clear();
+    cooked.levels.resize(texture.levels.size());
+
+    // encode all levels at once, small levels would leave the workers idle on their own
+    std::vector<EncodeBand> bands;
+    for(size_t level = 0; level < texture.levels.size(); ++level)
+    {
+        const TextureLevel& sourceLevel = texture.levels[level];
+        TextureLevel& cookedLevel = cooked.levels[level];
+        cookedLevel.width = sourceLevel.width;
+        cookedLevel.height = sourceLevel.height;
+        cookedLevel.data.resize(TextureFormats::GetLevelSize(settings.format, sourceLevel.width, sourceLevel.height));
+        appendBands(sourceLevel, cookedLevel, threadPool.GetThreadCount(), bands);
+    }
+    encodeBands(bands, settings.format, settings.encodeSettings, threadPool);
+    return true;
+}
+
+/// @brief Replaces the levels below level 0 by a full mip chain down to 1x1.
+/// @brief Each texel of a level is the box filtered average of its footprint in the level above, odd sizes spread
+/// @brief the remaining texel over the footprints. Filtering runs on linear floats, the chain is never requantized.
+/// @return false when the texture is not rgba8
+bool TextureCooker::GenerateMips(TextureData& texture)
+{
+    if(!isUncompressedFormat(texture.format) || texture.levels.empty())
+    {
+        std::cout << "error: texture: mips can only be generated for rgba8 textures!";
+        return false;
+    }
+
+    bool isSrgb = TextureFormats::IsSrgb(texture.format);
+    texture.levels.resize(1);
+
+    // decode table: srgb >> linear for the color channels, alpha is always linear
+    float colorTable[256];
+    for(uint32_t value = 0; value < 256; ++value)
+    {
+        float normalized = static_cast<float>(value) / 255.0f;
+        colorTable[value] = isSrgb ? srgbToLinear(normalized) : normalized;
+    }
+
+    uint32_t width = texture.levels[0].width;
+    uint32_t height = texture.levels[0].height;
+    const std::vector<uint8_t>& baseData = texture.levels[0].data;
+    std::vector<float> linear(static_cast<size_t>(width) * height * 4);
+    for(size_t i = 0; i < linear.size(); ++i)
+        linear[i] = (i % 4 == 3) ? static_cast<float>(baseData[i]) / 255.0f : colorTable[baseData[i]];
+
+    while(width > 1 || height > 1)
+    {
+        uint32_t nextWidth = std::max(1u, width / 2);
+        uint32_t nextHeight = std::max(1u, height / 2);
+        std::vector<float> next(static_cast<size_t>(nextWidth) * nextHeight * 4);
+
+        TextureLevel level{};
+        level.width = nextWidth;
+        level.height = nextHeight;
+        level.data.resize(next.size());
+
+        for(uint32_t y = 0; y < nextHeight; ++y)
+        {
+            uint32_t firstY = y * height / nextHeight;
+            uint32_t endY = (y + 1) * height / nextHeight;
+            for(uint32_t x = 0; x < nextWidth; ++x)
+            {
+                uint32_t firstX = x * width / nextWidth;
+                uint32_t endX = (x + 1) * width / nextWidth;
+
+                float sum[4] = {};
+                for(uint32_t sourceY = firstY; sourceY < endY; ++sourceY)
+                {
+                    for(uint32_t sourceX = firstX; sourceX < endX; ++sourceX)
+                    {
+                        const float* pTexel = &linear[(static_cast<size_t>(sourceY) * width + sourceX) * 4];
+                        for(uint32_t channel = 0; channel < 4; ++channel)
+                            sum[channel] += pTexel[channel];
+                    }
+                }
+
+                float count = static_cast<float>((endY - firstY) * (endX - firstX));
+                size_t offset = (static_cast<size_t>(y) * nextWidth + x) * 4;
+                for(uint32_t channel = 0; channel < 4; ++channel)
+                {
+                    float value = sum[channel] / count;
+                    next[offset + channel] = value;
+                    level.data[offset + channel] = toByte((isSrgb && channel < 3) ? linearToSrgb(value) : value);
+                }
+            }
+        }
+
+        texture.levels.push_back(std::move(level));
+        linear = std::move(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+    return true;
+}
+
+/// @brief block compresses one rgba8 level to a bc1 or bc7 format on the thread pool
+bool TextureCooker::Compress(const TextureLevel& level, TextureFormat format, const BcEncodeSettings& settings, ThreadPool& threadPool, TextureLevel& compressed)
+{
+    if(!isEncodableFormat(format))
+    {
+        std::cout << "error: texture: cooker only encodes bc1 and bc7!";
+        return false;
+    }
+
+    compressed.width = level.width;
+    compressed.height = level.height;
+    compressed.data.resize(TextureFormats::GetLevelSize(format, level.width, level.height));
+
+    std::vector<EncodeBand> bands;
+    appendBands(level, compressed, threadPool.GetThreadCount(), bands);
+    encodeBands(bands, format, settings, threadPool);
+    return true;
+}
\ No newline at end of file
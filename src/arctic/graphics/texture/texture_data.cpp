@@ -0,0 +1,68 @@
+#include "arctic/graphics/texture/texture_data.h"
+
+bool TextureFormats::IsCompressed(TextureFormat format)
+{
+    return GetBlockSize(format) > 1;
+}
+
+bool TextureFormats::IsSrgb(TextureFormat format)
+{
+    switch(format)
+    {
+        case TextureFormat::RGBA8_SRGB:
+        case TextureFormat::BC1_SRGB:
+        case TextureFormat::BC1_RGB_SRGB:
+        case TextureFormat::BC3_SRGB:
+        case TextureFormat::BC7_SRGB:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// @brief edge length of a block in texels, 1 for uncompressed formats
+uint32_t TextureFormats::GetBlockSize(TextureFormat format)
+{
+    switch(format)
+    {
+        case TextureFormat::RGBA8_UNORM:
+        case TextureFormat::RGBA8_SRGB:
+        case TextureFormat::Undefined:
+            return 1;
+        default:
+            return 4;
+    }
+}
+
+/// @brief size of a block in bytes, the size of a texel for uncompressed formats
+uint32_t TextureFormats::GetBytesPerBlock(TextureFormat format)
+{
+    switch(format)
+    {
+        case TextureFormat::RGBA8_UNORM:
+        case TextureFormat::RGBA8_SRGB:
+            return 4;
+        case TextureFormat::BC1_UNORM:
+        case TextureFormat::BC1_SRGB:
+        case TextureFormat::BC1_RGB_UNORM:
+        case TextureFormat::BC1_RGB_SRGB:
+            return 8;
+        case TextureFormat::BC3_UNORM:
+        case TextureFormat::BC3_SRGB:
+        case TextureFormat::BC5_UNORM:
+        case TextureFormat::BC7_UNORM:
+        case TextureFormat::BC7_SRGB:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+/// @brief size of a tightly packed level in bytes, partial blocks at the edges count as whole blocks
+size_t TextureFormats::GetLevelSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+    uint32_t blockSize = GetBlockSize(format);
+    size_t blocksWide = (width + blockSize - 1) / blockSize;
+    size_t blocksHigh = (height + blockSize - 1) / blockSize;
+    return blocksWide * blocksHigh * GetBytesPerBlock(format);
+}
\ No newline at end of file
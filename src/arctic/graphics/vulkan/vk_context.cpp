@@ -2,15 +2,17 @@
 
 #include "vk_loader.h"
 #include "vk_renderloop.h"
+#include "vk_memory_handler.h"
 #include "arctic/graphics/vulkan/vk_window.h"
+#include "arctic/core/utilities/profiler.h"
 
 // should only be defined once in your entire project to prevent multiple definitions of VMA functions:
 #define VMA_IMPLEMENTATION
 #include "vk_mem_alloc.h"
 
-VulkanContext::VulkanContext(std::shared_ptr<VulkanWindow> vulkanWindow)
+VulkanContext::VulkanContext(std::shared_ptr<VulkanWindow> vulkanWindow, const PresentSettings& presentSettings, const MemoryPoolSizes& memoryPoolSizes)
 {
-    pVulkanLoader = std::make_unique<VulkanLoader>(vulkanWindow);
+    pVulkanLoader = std::make_unique<VulkanLoader>(vulkanWindow, presentSettings, memoryPoolSizes);
 }
 
 VulkanContext::~VulkanContext()
@@ -24,17 +26,74 @@ void VulkanContext::Cleanup()
     pVulkanLoader.reset();
 }
 
-void VulkanContext::Render()
+bool VulkanContext::Render()
 {
+    ARCTIC_PROFILE_FUNCTION();
+
     // get renderloop
     auto renderLoop = pVulkanLoader->GetRenderLoop();
 
     // reload swapchain when dirty
+    // >> skip the frame while it cannot be recreated (minimized window)
     if(renderLoop->IsSwapChainDirty())
     {
-        pVulkanLoader->ReloadSwapChain();
+        ARCTIC_PROFILE_ZONE("swapchain reload");
+        if(!pVulkanLoader->ReloadSwapChain())
+            return false;
     }
 
     // render
     renderLoop->Render();
+    return true;
+}
+
+void VulkanContext::WaitForSubmittedFrames()
+{
+    auto renderLoop = pVulkanLoader->GetRenderLoop();
+    renderLoop->WaitForFrame(renderLoop->GetSubmittedFrameValue());
+}
+
+void VulkanContext::SetDrawList(const std::vector<DrawItem>& drawList)
+{
+    pVulkanLoader->GetRenderLoop()->SetDrawList(drawList);
+}
+
+DrawItem VulkanContext::GetQuadDraw() const
+{
+    return pVulkanLoader->GetRenderLoop()->GetQuadDraw();
+}
+
+PipelineHandle VulkanContext::RequestPipeline(const PipelineDesc& desc)
+{
+    return pVulkanLoader->GetRenderLoop()->RequestPipeline(desc);
+}
+
+void VulkanContext::SetShaderWatch(bool isEnabled)
+{
+    pVulkanLoader->GetRenderLoop()->SetShaderWatch(isEnabled);
+}
+
+void VulkanContext::SetDepthPrepass(bool isEnabled)
+{
+    pVulkanLoader->GetRenderLoop()->SetDepthPrepass(isEnabled);
+}
+
+FrameTimings VulkanContext::GetFrameTimings() const
+{
+    return pVulkanLoader->GetRenderLoop()->GetFrameTimings();
+}
+
+GpuFrameTimings VulkanContext::GetGpuFrameTimings() const
+{
+    return pVulkanLoader->GetRenderLoop()->GetGpuFrameTimings();
+}
+
+MemoryStats VulkanContext::GetMemoryStats() const
+{
+    return pVulkanLoader->GetMemoryHandler()->GetMemoryStats();
+}
+
+uint32_t VulkanContext::GetFramesInFlight() const
+{
+    return pVulkanLoader->GetRenderLoop()->GetFramesInFlight();
 }
\ No newline at end of file
@@ -0,0 +1,401 @@
+#include "vk_gpu_profiler.h"
+#include "vk_memory_handler.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/// @brief microseconds of the steady clock, the clock of cpu zones
+static int64_t steadyNowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// @return true when creation was successful, an unsupported device creates a profiler that records nothing
+bool VulkanGpuProfiler::Create(
+    VkDevice vkDevice,
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+    VkQueue graphicsQueue,
+    uint32_t graphicsFamilyIndex,
+    uint32_t frameSlotCount,
+    bool isCalibratedTimestampsEnabled)
+{
+    this->vkDevice = vkDevice;
+    this->vkGraphicsQueue = graphicsQueue;
+    this->graphicsFamilyIndex = graphicsFamilyIndex;
+    VkPhysicalDevice vkPhysicalDevice = memoryHandler->GetPhysicalDevice();
+
+    // check timestamp support of the graphics queue
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    uint32_t timestampValidBits = graphicsFamilyIndex < queueFamilyCount ? queueFamilies[graphicsFamilyIndex].timestampValidBits : 0;
+    const VkPhysicalDeviceLimits& limits = memoryHandler->GetPhysicalDeviceProperties().limits;
+    if(timestampValidBits == 0 || limits.timestampPeriod <= 0.0f)
+    {
+        std::cout << "info: vulkan: gpu timestamps are not supported, gpu profiling disabled" << std::endl;
+        return true;
+    }
+
+    timestampPeriodNs = limits.timestampPeriod;
+    timestampMask = timestampValidBits >= 64 ? UINT64_MAX : (1ull << timestampValidBits) - 1;
+
+    // check pipeline statistics support
+    // >> both features are enabled by the loader when supported
+    VkPhysicalDeviceFeatures features{};
+    vkGetPhysicalDeviceFeatures(vkPhysicalDevice, &features);
+    isStatisticsSupported = features.pipelineStatisticsQuery == VK_TRUE;
+    isStatisticsInheritable = isStatisticsSupported && features.inheritedQueries == VK_TRUE;
+
+    // create query pools per frame slot
+    frameSlots.resize(frameSlotCount);
+    for(auto& pSlot : frameSlots)
+    {
+        pSlot = std::make_unique<FrameSlot>();
+        pSlot->zones.resize(MAX_ZONES);
+
+        VkQueryPoolCreateInfo timestampPoolInfo{};
+        timestampPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        timestampPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        timestampPoolInfo.queryCount = TIMESTAMP_QUERY_COUNT;
+
+        if(vkCreateQueryPool(vkDevice, &timestampPoolInfo, nullptr, &pSlot->timestampPool) != VK_SUCCESS)
+        {
+            std::cout << "error: vulkan: failed to create timestamp query pool!";
+            return false;
+        }
+
+        if(isStatisticsSupported)
+        {
+            VkQueryPoolCreateInfo statisticsPoolInfo{};
+            statisticsPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            statisticsPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+            statisticsPoolInfo.queryCount = 1;
+            statisticsPoolInfo.pipelineStatistics = STATISTICS_FLAGS;
+
+            if(vkCreateQueryPool(vkDevice, &statisticsPoolInfo, nullptr, &pSlot->statisticsPool) != VK_SUCCESS)
+            {
+                std::cout << "error: vulkan: failed to create pipeline statistics query pool!";
+                return false;
+            }
+        }
+    }
+
+    // relate gpu ticks to the cpu clock
+    // >> the loader enables VK_EXT_calibrated_timestamps only when the device clock can be calibrated
+    if(isCalibratedTimestampsEnabled)
+        pGetCalibratedTimestamps = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(vkGetDeviceProcAddr(vkDevice, "vkGetCalibratedTimestampsEXT"));
+    calibrationIntervalUs = pGetCalibratedTimestamps != nullptr ? CALIBRATED_INTERVAL_US : SUBMIT_INTERVAL_US;
+
+    VkQueryPoolCreateInfo calibrationPoolInfo{};
+    calibrationPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    calibrationPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    calibrationPoolInfo.queryCount = 1;
+
+    if(vkCreateQueryPool(vkDevice, &calibrationPoolInfo, nullptr, &calibrationPool) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create timestamp query pool!";
+        return false;
+    }
+
+    if(!calibrate())
+        return false;
+
+    isSupported = true;
+    return true;
+}
+
+void VulkanGpuProfiler::CleanUp()
+{
+    for(auto& pSlot : frameSlots)
+    {
+        vkDestroyQueryPool(vkDevice, pSlot->timestampPool, nullptr);
+        vkDestroyQueryPool(vkDevice, pSlot->statisticsPool, nullptr);
+    }
+    frameSlots.clear();
+    pCurrentSlot = nullptr;
+    isSupported = false;
+
+    vkDestroyQueryPool(vkDevice, calibrationPool, nullptr);
+    calibrationPool = VK_NULL_HANDLE;
+    pGetCalibratedTimestamps = nullptr;
+}
+
+bool VulkanGpuProfiler::IsSupported() const
+{
+    return this->isSupported;
+}
+
+void VulkanGpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameSlot, uint64_t frameValue)
+{
+    pCurrentSlot = nullptr;
+    if(!isSupported || frameSlot >= frameSlots.size())
+        return;
+
+    // read results of the previous frame of the slot
+    // >> the caller waited for it on the frame timeline, the results are available
+    FrameSlot& slot = *frameSlots[frameSlot];
+    if(slot.frameValue != 0)
+        readResults(slot);
+
+    // renew the calibration anchor
+    // >> cpu and gpu clocks drift apart, a failed calibration keeps the previous anchor
+    if(steadyNowUs() - lastCalibrationUs >= calibrationIntervalUs && !calibrate())
+        lastCalibrationUs = steadyNowUs();
+
+    // reset queries
+    // >> outside of rendering, before any zone of the frame
+    vkCmdResetQueryPool(commandBuffer, slot.timestampPool, 0, TIMESTAMP_QUERY_COUNT);
+    if(slot.statisticsPool != VK_NULL_HANDLE)
+        vkCmdResetQueryPool(commandBuffer, slot.statisticsPool, 0, 1);
+
+    slot.frameValue = frameValue;
+    slot.hasStatistics = false;
+    slot.zoneCount = 0;
+    pCurrentSlot = &slot;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.timestampPool, 0);
+}
+
+void VulkanGpuProfiler::EndFrame(VkCommandBuffer commandBuffer)
+{
+    if(pCurrentSlot == nullptr)
+        return;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pCurrentSlot->timestampPool, 1);
+    pCurrentSlot = nullptr;
+}
+
+/// @return the zone to end, UINT32_MAX when the zone is not timed
+uint32_t VulkanGpuProfiler::BeginZone(VkCommandBuffer commandBuffer, const char* name)
+{
+    if(pCurrentSlot == nullptr)
+        return UINT32_MAX;
+
+    // >> zones of recording threads take their queries from one counter
+    uint32_t zone = pCurrentSlot->zoneCount.fetch_add(1);
+    if(zone >= MAX_ZONES)
+        return UINT32_MAX;
+
+    Zone& entry = pCurrentSlot->zones[zone];
+    entry.name = name;
+    entry.beginQuery = 2 + 2 * zone;
+    entry.endQuery = entry.beginQuery + 1;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pCurrentSlot->timestampPool, entry.beginQuery);
+    return zone;
+}
+
+void VulkanGpuProfiler::EndZone(VkCommandBuffer commandBuffer, uint32_t zone)
+{
+    if(pCurrentSlot == nullptr || zone >= MAX_ZONES)
+        return;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pCurrentSlot->timestampPool, pCurrentSlot->zones[zone].endQuery);
+}
+
+void VulkanGpuProfiler::BeginStatistics(VkCommandBuffer commandBuffer, bool isExecutingSecondaries)
+{
+    // >> secondary command buffers can only execute inside the query when they inherit it
+    if(pCurrentSlot == nullptr || pCurrentSlot->statisticsPool == VK_NULL_HANDLE)
+        return;
+    if(isExecutingSecondaries && !isStatisticsInheritable)
+        return;
+
+    vkCmdBeginQuery(commandBuffer, pCurrentSlot->statisticsPool, 0, 0);
+    pCurrentSlot->hasStatistics = true;
+}
+
+void VulkanGpuProfiler::EndStatistics(VkCommandBuffer commandBuffer)
+{
+    if(pCurrentSlot == nullptr || !pCurrentSlot->hasStatistics)
+        return;
+
+    vkCmdEndQuery(commandBuffer, pCurrentSlot->statisticsPool, 0);
+}
+
+VkQueryPipelineStatisticFlags VulkanGpuProfiler::GetInheritedStatistics() const
+{
+    return pCurrentSlot != nullptr && pCurrentSlot->hasStatistics ? STATISTICS_FLAGS : 0;
+}
+
+const GpuFrameTimings& VulkanGpuProfiler::GetFrameTimings() const
+{
+    return this->frameTimings;
+}
+
+/// @brief relates the gpu ticks to the cpu clock, with the device clock when available
+bool VulkanGpuProfiler::calibrate()
+{
+    if(pGetCalibratedTimestamps != nullptr && calibrateWithDeviceClock())
+        return true;
+    return calibrateWithSubmit();
+}
+
+/// @brief Reads the gpu clock with VK_EXT_calibrated_timestamps, no submit and no wait.
+/// @brief The cpu time is the middle of the call, off by at most half its duration and the reported deviation.
+bool VulkanGpuProfiler::calibrateWithDeviceClock()
+{
+    VkCalibratedTimestampInfoEXT timestampInfo{};
+    timestampInfo.sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    timestampInfo.timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+
+    uint64_t ticks = 0;
+    uint64_t maxDeviation = 0;
+    int64_t beforeUs = steadyNowUs();
+    if(pGetCalibratedTimestamps(vkDevice, 1, &timestampInfo, &ticks, &maxDeviation) != VK_SUCCESS)
+        return false;
+    int64_t afterUs = steadyNowUs();
+
+    calibrationTicks = ticks & timestampMask;
+    calibrationUs = beforeUs + (afterUs - beforeUs) / 2;
+    lastCalibrationUs = afterUs;
+    return true;
+}
+
+/// @brief Writes a timestamp in a one time submit and relates it to the cpu clock.
+/// @brief The cpu time is the middle of submit and wait, off by at most half the round trip.
+/// @brief >> waits for the graphics queue to drain, frames in flight complete first
+bool VulkanGpuProfiler::calibrateWithSubmit()
+{
+    // create command pool and buffer
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = graphicsFamilyIndex;
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    if(vkCreateCommandPool(vkDevice, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create command pool!";
+        return false;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    vkAllocateCommandBuffers(vkDevice, &allocInfo, &commandBuffer);
+
+    // record timestamp
+    // >> own pool, the queries of the frame slots may still hold unread results
+    VkQueryPool queryPool = calibrationPool;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    vkCmdResetQueryPool(commandBuffer, queryPool, 0, 1);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 0);
+    vkEndCommandBuffer(commandBuffer);
+
+    // submit and wait
+    // >> frames in flight are drained first, the round trip only covers the timestamp
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    uint64_t ticks = 0;
+    bool isCalibrated = vkQueueWaitIdle(vkGraphicsQueue) == VK_SUCCESS;
+    int64_t submitUs = steadyNowUs();
+    isCalibrated = isCalibrated && vkQueueSubmit(vkGraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS && vkQueueWaitIdle(vkGraphicsQueue) == VK_SUCCESS;
+    int64_t completeUs = steadyNowUs();
+
+    if(isCalibrated)
+        isCalibrated = vkGetQueryPoolResults(vkDevice, queryPool, 0, 1, sizeof(uint64_t), &ticks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS;
+
+    vkDestroyCommandPool(vkDevice, commandPool, nullptr);
+    if(!isCalibrated)
+    {
+        std::cout << "error: vulkan: failed to calibrate gpu timestamps!";
+        return false;
+    }
+
+    calibrationTicks = ticks;
+    calibrationUs = submitUs + (completeUs - submitUs) / 2;
+    lastCalibrationUs = completeUs;
+    return true;
+}
+
+/// @brief converts the queries of the slot into the frame timings
+/// @brief zones that were not ended (or began after MAX_ZONES) have no available end and are skipped
+void VulkanGpuProfiler::readResults(FrameSlot& slot)
+{
+    // read timestamps with availability
+    // >> no wait bit: the frame completed, unwritten queries are reported as unavailable instead of blocking
+    std::array<uint64_t, TIMESTAMP_QUERY_COUNT * 2> timestamps{};
+    VkResult result = vkGetQueryPoolResults(
+        vkDevice, slot.timestampPool, 0, TIMESTAMP_QUERY_COUNT,
+        sizeof(timestamps), timestamps.data(), 2 * sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if(result != VK_SUCCESS && result != VK_NOT_READY)
+        return;
+
+    auto getTicks = [&timestamps](uint32_t query) { return timestamps[2 * query]; };
+    auto isAvailable = [&timestamps](uint32_t query) { return timestamps[2 * query + 1] != 0; };
+    if(!isAvailable(0) || !isAvailable(1))
+        return;
+
+    // convert to the cpu clock
+    // >> always from the calibration anchor, rounding does not add up over frames
+    // >> the frame may begin before the anchor (renewed after it was recorded), differences are signed modulo the mask
+    uint64_t frameBeginTicks = getTicks(0);
+    uint64_t aheadTicks = (frameBeginTicks - calibrationTicks) & timestampMask;
+    double offsetMs = aheadTicks <= timestampMask / 2 ? ticksToMs(calibrationTicks, frameBeginTicks) : -ticksToMs(frameBeginTicks, calibrationTicks);
+    int64_t startUs = calibrationUs + std::llround(offsetMs * 1000.0);
+
+    GpuFrameTimings timings{};
+    timings.frameValue = slot.frameValue;
+    timings.startUs = startUs;
+    timings.frameMs = ticksToMs(frameBeginTicks, getTicks(1));
+
+    uint32_t zoneCount = std::min<uint32_t>(slot.zoneCount, MAX_ZONES);
+    timings.zones.reserve(zoneCount);
+    for(uint32_t i = 0; i < zoneCount; ++i)
+    {
+        const Zone& zone = slot.zones[i];
+        if(!isAvailable(zone.beginQuery) || !isAvailable(zone.endQuery))
+            continue;
+
+        GpuZoneTiming zoneTiming{};
+        zoneTiming.name = zone.name;
+        zoneTiming.startMs = ticksToMs(frameBeginTicks, getTicks(zone.beginQuery));
+        zoneTiming.durationMs = ticksToMs(getTicks(zone.beginQuery), getTicks(zone.endQuery));
+        timings.zones.push_back(zoneTiming);
+    }
+
+    // read pipeline statistics
+    // >> values are written in the bit order of the flags
+    if(slot.hasStatistics)
+    {
+        std::array<uint64_t, STATISTICS_COUNT> statistics{};
+        if(vkGetQueryPoolResults(vkDevice, slot.statisticsPool, 0, 1, sizeof(statistics), statistics.data(), sizeof(statistics), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            timings.hasStatistics = true;
+            timings.statistics.inputAssemblyVertices = statistics[0];
+            timings.statistics.inputAssemblyPrimitives = statistics[1];
+            timings.statistics.vertexShaderInvocations = statistics[2];
+            timings.statistics.clippingInvocations = statistics[3];
+            timings.statistics.clippingPrimitives = statistics[4];
+            timings.statistics.fragmentShaderInvocations = statistics[5];
+        }
+    }
+
+    frameTimings = std::move(timings);
+}
+
+/// @brief milliseconds from begin to end, ticks are compared modulo the valid bits
+double VulkanGpuProfiler::ticksToMs(uint64_t beginTicks, uint64_t endTicks) const
+{
+    uint64_t ticks = (endTicks - beginTicks) & timestampMask;
+    return static_cast<double>(ticks) * timestampPeriodNs / 1000000.0;
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include "arctic/graphics/rhi/gpu_timings.h"
+
+class VulkanMemoryHandler;
+
+/// @brief Times passes and draw groups of a frame with timestamp queries (vkCmdWriteTimestamp) and counts the work
+/// @brief of the render graph passes with a pipeline statistics query.
+/// @brief Every frame slot owns its query pools, the results of a slot are read when the slot is recorded again: the
+/// @brief frame timeline wait already guarantees the frame completed, so reading never stalls.
+/// @brief Timestamps are converted to the steady clock of the cpu from a calibration anchor, cpu and gpu zones line up
+/// @brief in one trace. The anchor is renewed periodically so the zones do not drift apart from the cpu track.
+class VulkanGpuProfiler
+{
+public:
+    bool Create(
+        VkDevice vkDevice,
+        std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+        VkQueue graphicsQueue,
+        uint32_t graphicsFamilyIndex,
+        uint32_t frameSlotCount,
+        bool isCalibratedTimestampsEnabled = false);
+    void CleanUp();
+
+    bool IsSupported() const;
+
+    // frame: reads the results of the previous use of the slot, resets its queries and opens the frame zone
+    // >> BeginFrame must be recorded first, outside of rendering
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameSlot, uint64_t frameValue);
+    void EndFrame(VkCommandBuffer commandBuffer);
+
+    // zones: callable from recording threads between BeginFrame and EndFrame, also in secondary command buffers
+    // >> name must outlive the frame (string literal), zones beyond MAX_ZONES are not timed
+    uint32_t BeginZone(VkCommandBuffer commandBuffer, const char* name);
+    void EndZone(VkCommandBuffer commandBuffer, uint32_t zone);
+
+    // pipeline statistics: recorded in the primary command buffer outside of rendering
+    // >> secondary command buffers executed inside the query inherit it with GetInheritedStatistics
+    void BeginStatistics(VkCommandBuffer commandBuffer, bool isExecutingSecondaries);
+    void EndStatistics(VkCommandBuffer commandBuffer);
+    VkQueryPipelineStatisticFlags GetInheritedStatistics() const;
+
+    // timings of the latest completed frame
+    const GpuFrameTimings& GetFrameTimings() const;
+
+private:
+    struct Zone
+    {
+        const char* name = nullptr;
+        uint32_t beginQuery = 0;
+        uint32_t endQuery = 0;
+    };
+
+    struct FrameSlot
+    {
+        VkQueryPool timestampPool = VK_NULL_HANDLE;
+        VkQueryPool statisticsPool = VK_NULL_HANDLE;
+
+        uint64_t frameValue = 0;    // frame recorded with the queries, 0 when there are no results to read
+        bool hasStatistics = false;
+        std::vector<Zone> zones;
+        std::atomic<uint32_t> zoneCount = 0;
+    };
+
+    // timestamps: frame begin and end, then a begin and end per zone
+    static constexpr uint32_t MAX_ZONES = 63;
+    static constexpr uint32_t TIMESTAMP_QUERY_COUNT = 2 + 2 * MAX_ZONES;
+
+    const VkQueryPipelineStatisticFlags STATISTICS_FLAGS =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+    static constexpr uint32_t STATISTICS_COUNT = 6;
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+    bool isSupported = false;
+    bool isStatisticsSupported = false;
+    bool isStatisticsInheritable = false;
+
+    // timestamp conversion
+    // >> ticks wrap after timestampValidBits, differences are taken modulo the mask
+    double timestampPeriodNs = 1.0;
+    uint64_t timestampMask = UINT64_MAX;
+    uint64_t calibrationTicks = 0;
+    int64_t calibrationUs = 0;
+
+    // calibration: VK_EXT_calibrated_timestamps reads the gpu clock without a submit, every second
+    // >> without it a timestamp is written in a one time submit that drains the queue, once a minute
+    // >> both well within a wrap of the gpu counter
+    static constexpr int64_t CALIBRATED_INTERVAL_US = 1000000;
+    static constexpr int64_t SUBMIT_INTERVAL_US = 60000000;
+    PFN_vkGetCalibratedTimestampsEXT pGetCalibratedTimestamps = nullptr;
+    VkQueue vkGraphicsQueue = VK_NULL_HANDLE;
+    uint32_t graphicsFamilyIndex = 0;
+    VkQueryPool calibrationPool = VK_NULL_HANDLE;
+    int64_t calibrationIntervalUs = SUBMIT_INTERVAL_US;
+    int64_t lastCalibrationUs = 0;
+
+    std::vector<std::unique_ptr<FrameSlot>> frameSlots;
+    FrameSlot* pCurrentSlot = nullptr;
+
+    GpuFrameTimings frameTimings;
+
+    bool calibrate();
+    bool calibrateWithSubmit();
+    bool calibrateWithDeviceClock();
+    void readResults(FrameSlot& slot);
+    double ticksToMs(uint64_t beginTicks, uint64_t endTicks) const;
+};
+
+/// @brief times the commands recorded into the command buffer while in scope
+class VulkanGpuZone
+{
+public:
+    VulkanGpuZone(VulkanGpuProfiler& profiler, VkCommandBuffer commandBuffer, const char* name)
+        : profiler(profiler), commandBuffer(commandBuffer), zone(profiler.BeginZone(commandBuffer, name)) {}
+    ~VulkanGpuZone() { profiler.EndZone(commandBuffer, zone); }
+
+    VulkanGpuZone(const VulkanGpuZone&) = delete;
+    VulkanGpuZone& operator=(const VulkanGpuZone&) = delete;
+
+private:
+    VulkanGpuProfiler& profiler;
+    VkCommandBuffer commandBuffer;
+    uint32_t zone;
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "vk_layout_cache.h"
+
+#include <iostream>
+
+/// @return true when creation was successful
+bool VulkanLayoutCache::Create(VkDevice vkDevice)
+{
+    this->vkDevice = vkDevice;
+    return true;
+}
+
+void VulkanLayoutCache::CleanUp()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto& [key, pipelineLayout] : pipelineLayouts)
+        vkDestroyPipelineLayout(vkDevice, pipelineLayout, nullptr);
+    for(auto& [key, setLayout] : descriptorSetLayouts)
+        vkDestroyDescriptorSetLayout(vkDevice, setLayout, nullptr);
+
+    pipelineLayouts.clear();
+    descriptorSetLayouts.clear();
+    reflections.clear();
+}
+
+bool VulkanLayoutCache::Reflect(const std::vector<char>& code, ShaderReflection& reflection)
+{
+    std::string key(code.begin(), code.end());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = reflections.find(key);
+        if(it != reflections.end())
+        {
+            reflection = it->second;
+            return true;
+        }
+    }
+
+    // reflect outside the lock, a concurrent reflection of the same code yields the same result
+    if(!VulkanShaderReflection::Reflect(code, reflection))
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    reflections.emplace(std::move(key), reflection);
+    return true;
+}
+
+/// @param bindings sorted by binding number
+/// @return VK_NULL_HANDLE when creation failed
+VkDescriptorSetLayout VulkanLayoutCache::GetDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+{
+    // key: binding, type, count, stages of every binding
+    std::vector<uint64_t> key;
+    key.reserve(bindings.size() * 4);
+    for(const auto& binding : bindings)
+    {
+        key.push_back(binding.binding);
+        key.push_back(static_cast<uint64_t>(binding.descriptorType));
+        key.push_back(binding.descriptorCount);
+        key.push_back(binding.stageFlags);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = descriptorSetLayouts.find(key);
+    if(it != descriptorSetLayouts.end())
+        return it->second;
+
+    // create info: descriptor set layout
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    if(vkCreateDescriptorSetLayout(vkDevice, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create descriptor set layout!";
+        return VK_NULL_HANDLE;
+    }
+
+    descriptorSetLayouts.emplace(std::move(key), setLayout);
+    return setLayout;
+}
+
+/// @return VK_NULL_HANDLE when creation failed
+VkPipelineLayout VulkanLayoutCache::GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges)
+{
+    // key: set layout handles (deduplicated, equal handles mean equal layouts), then the push constant ranges
+    std::vector<uint64_t> key;
+    key.reserve(setLayouts.size() + pushConstantRanges.size() * 3 + 1);
+    for(const auto& setLayout : setLayouts)
+        key.push_back(reinterpret_cast<uint64_t>(setLayout));
+    key.push_back(UINT64_MAX);
+    for(const auto& range : pushConstantRanges)
+    {
+        key.push_back(range.stageFlags);
+        key.push_back(range.offset);
+        key.push_back(range.size);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pipelineLayouts.find(key);
+    if(it != pipelineLayouts.end())
+        return it->second;
+
+    // create info: pipeline layout
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    if(vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create pipeline layout!";
+        return VK_NULL_HANDLE;
+    }
+
+    pipelineLayouts.emplace(std::move(key), pipelineLayout);
+    return pipelineLayout;
+}
+
+size_t VulkanLayoutCache::KeyHash::operator()(const std::vector<uint64_t>& key) const
+{
+    size_t hash = 0;
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+    for(uint64_t value : key)
+        combine(std::hash<uint64_t>()(value));
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include "vk_shader_reflection.h"
+
+/// @brief Deduplicates shader reflections, descriptor set layouts and pipeline layouts.
+/// @brief Equal binding lists share one VkDescriptorSetLayout and equal set layout / push constant lists share one
+/// @brief VkPipelineLayout, pipelines created from shaders with the same interface get the same layout handle.
+/// @brief Thread safe, pipelines are compiled on worker threads.
+class VulkanLayoutCache
+{
+public:
+    bool Create(VkDevice vkDevice);
+    void CleanUp();
+
+    // reflection of the spir-v code, reflected once per distinct code
+    bool Reflect(const std::vector<char>& code, ShaderReflection& reflection);
+
+    VkDescriptorSetLayout GetDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+    VkPipelineLayout GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges);
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const std::vector<uint64_t>& key) const;
+    };
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, ShaderReflection> reflections;
+    std::unordered_map<std::vector<uint64_t>, VkDescriptorSetLayout, KeyHash> descriptorSetLayouts;
+    std::unordered_map<std::vector<uint64_t>, VkPipelineLayout, KeyHash> pipelineLayouts;
+};
\ No newline at end of file
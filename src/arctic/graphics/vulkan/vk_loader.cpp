@@ -4,6 +4,8 @@
 #include "arctic/core/utilities/application.h"
 
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 #include <fmt/core.h>
 
 #include "arctic/graphics/vulkan/vk_window.h"
@@ -11,24 +13,33 @@
 #include "vk_renderloop.h"
 #include "vk_swapchain.h"
 #include "vk_memory_handler.h"
+#include "vk_pipeline_cache.h"
 
 std::shared_ptr<VulkanRenderLoop> VulkanLoader::GetRenderLoop()
 {
     return pRenderLoop;
 }
 
-void VulkanLoader::ReloadSwapChain()
+std::shared_ptr<VulkanMemoryHandler> VulkanLoader::GetMemoryHandler()
 {
-    // re-create swapchain and re-load dependencies on swapchain data
-    pSwapchain->CleanUp(vkDevice);
-    pSwapchain->CreateSwapChain();
+    return pMemoryHandler;
+}
+
+/// @return false when the swapchain cannot be recreated yet (minimized window), no frame can be rendered
+bool VulkanLoader::ReloadSwapChain()
+{
+    // re-create swapchain
+    // >> no device idle: the old swapchain is destroyed once the last submitted frame completed
+    // >> dynamic rendering: no framebuffers to rebuild, pipelines only depend on the image format
+    if(!pSwapchain->Recreate(pRenderLoop->GetSubmittedFrameValue()))
+        return false;
 
-    pRenderPipeline->Load(
-        pSwapchain->GetData(), 
-        pSwapchain->GetImageViews());
+    if(pSwapchain->GetData().imageFormat != pRenderPipeline->GetColorFormat())
+        std::cout << "error: vulkan: swapchain format changed, pipelines do not match the images!";
+    return true;
 }
 
-VulkanLoader::VulkanLoader(std::shared_ptr<VulkanWindow> vulkanWindow)
+VulkanLoader::VulkanLoader(std::shared_ptr<VulkanWindow> vulkanWindow, const PresentSettings& presentSettings, const MemoryPoolSizes& memoryPoolSizes)
 {
     // check validation layers
     if(enableValidationLayers && !vulkanFoundValidationLayers())
@@ -37,45 +48,81 @@ VulkanLoader::VulkanLoader(std::shared_ptr<VulkanWindow> vulkanWindow)
         return;
     }
 
+    // headless: no surface, so no swapchain extension is needed
+    this->isHeadless = vulkanWindow->IsHeadless();
+    if(!isHeadless)
+        requiredDeviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
     vulkanCreateInstance(*vulkanWindow.get());
     vulkanLoadDebugMessenger();
 
-    vulkanWindow->CreateSurface(vkInstance, vkSurface);
+    if(!isHeadless)
+        vulkanWindow->CreateSurface(vkInstance, vkSurface);
 
     pSwapchain = std::make_shared<VulkanSwapChain>();
 
     vulkanLoadPhysicalDevice(vkInstance, vkSurface, *pSwapchain);
+
+    // optional device extensions
+    // >> memory budget: heap budgets reported by the driver, without it vma estimates them from the heap sizes
+    isMemoryBudgetSupported = vkPhysicalDevice != VK_NULL_HANDLE && isDeviceExtensionSupported(vkPhysicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if(isMemoryBudgetSupported)
+        requiredDeviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    // >> calibrated timestamps: the gpu profiler reads the device clock to keep gpu zones aligned with the cpu clock
+    isCalibratedTimestampsSupported = vkPhysicalDevice != VK_NULL_HANDLE && isDeviceClockCalibrateable(vkPhysicalDevice);
+    if(isCalibratedTimestampsSupported)
+        requiredDeviceExtensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
     
     QueueFamilyIndices queueFamilyIndices = findQueueFamilies(vkPhysicalDevice, vkSurface);
     vulkanCreateLogicalDevice(vkPhysicalDevice, queueFamilyIndices);
+
+    // create vulkan memory handler
+    // >> created before the swapchain, headless offscreen images are allocated through it
+    pMemoryHandler = std::shared_ptr<VulkanMemoryHandler>(new VulkanMemoryHandler(
+        vkDevice,
+        vkPhysicalDevice,
+        vkInstance,
+        vkGraphicsQueue,
+        vkTransferQueue,
+        memoryPoolSizes,
+        isMemoryBudgetSupported
+    ));
     
+    // validate frames in flight
+    // >> the swapchain needs them too, headless images are reused once their frame slot is free
+    PresentSettings settings = presentSettings;
+    settings.framesInFlight = std::clamp<uint32_t>(settings.framesInFlight, 1, VulkanRenderLoop::MAX_FRAMES_IN_FLIGHT);
+    if(settings.framesInFlight != presentSettings.framesInFlight)
+        std::cout << "info: vulkan: " << presentSettings.framesInFlight << " frames in flight not supported, using " << settings.framesInFlight << std::endl;
+
     // create swapchain
     pSwapchain->Configure(
         vkDevice,
         vkPhysicalDevice,
         vkSurface,
-        vulkanWindow);
+        vulkanWindow,
+        pMemoryHandler,
+        settings);
 
     pSwapchain->CreateSwapChain();
 
-    // create vulkan memory handler
-    pMemoryHandler = std::shared_ptr<VulkanMemoryHandler>(new VulkanMemoryHandler(
-        vkDevice,
-        vkPhysicalDevice,
-        vkInstance,
-        vkGraphicsQueue,
-        vkTransferQueue
-    ));
+    SwapChainData swapChainData = pSwapchain->GetData();
+    std::cout << "info: vulkan: present mode " << swapChainData.presentMode << ", " << swapChainData.imageCount << " images, " << settings.framesInFlight << " frames in flight" << std::endl;
+
+    // create pipeline cache
+    // >> loaded from disk, pipelines compiled by an earlier run are not compiled again
+    pPipelineCache = std::make_shared<VulkanPipelineCache>();
+    pPipelineCache->Create(vkDevice, vkPhysicalDevice);
 
     // create render pipeline
     pRenderPipeline = std::shared_ptr<VulkanRenderPipeline>(new VulkanRenderPipeline(
         vkDevice,
         queueFamilyIndices.graphicsFamily.value(),
-        queueFamilyIndices.transferFamily.value()));
+        queueFamilyIndices.transferFamily.value(),
+        pPipelineCache));
 
-    pRenderPipeline->Load(
-        pSwapchain->GetData(), 
-        pSwapchain->GetImageViews());
+    pRenderPipeline->Load(pSwapchain->GetData());
     
     // create render loop
     pRenderLoop = std::shared_ptr<VulkanRenderLoop>(new VulkanRenderLoop(
@@ -83,9 +130,12 @@ VulkanLoader::VulkanLoader(std::shared_ptr<VulkanWindow> vulkanWindow)
         pSwapchain, 
         pRenderPipeline, 
         pMemoryHandler,
+        pPipelineCache,
+        settings.framesInFlight,
         vkGraphicsQueue, 
         vkTransferQueue, 
-        vkPresentQueue));
+        vkPresentQueue,
+        isCalibratedTimestampsSupported));
 }
 
 void VulkanLoader::Cleanup()
@@ -105,6 +155,11 @@ void VulkanLoader::Cleanup()
     pSwapchain->CleanUp(vkDevice);
     pSwapchain.reset();
 
+    // pipeline cache
+    // >> written back to disk before the device is destroyed
+    pPipelineCache->CleanUp();
+    pPipelineCache.reset();
+
     // memory
     pMemoryHandler->Cleanup();
     pMemoryHandler.reset();
@@ -116,7 +171,8 @@ void VulkanLoader::Cleanup()
     vulkanDestroyDebugMessenger();
 
     // surface
-    vkDestroySurfaceKHR(vkInstance, vkSurface, nullptr);
+    if(vkSurface != VK_NULL_HANDLE)
+        vkDestroySurfaceKHR(vkInstance, vkSurface, nullptr);
 
     //instance
     vkDestroyInstance(vkInstance, nullptr);
@@ -274,12 +330,31 @@ void VulkanLoader::vulkanCreateLogicalDevice(const VkPhysicalDevice& physicalDev
     }
 
     // create device features
-    // >> currently empty
+    // >> anisotropic filtering when supported, samplers fall back to plain trilinear filtering otherwise
+    // >> pipeline statistics (inherited by secondary command buffers) when supported, for the gpu profiler
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
     VkPhysicalDeviceFeatures deviceFeatures{};
+    deviceFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+    deviceFeatures.inheritedQueries = supportedFeatures.inheritedQueries;
+
+    // >> vulkan 1.3: dynamic rendering, pipelines are created against attachment formats instead of render passes
+    VkPhysicalDeviceVulkan13Features deviceFeatures13{};
+    deviceFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    deviceFeatures13.dynamicRendering = VK_TRUE;
+
+    // >> vulkan 1.2: timeline semaphores drive frame pacing
+    VkPhysicalDeviceVulkan12Features deviceFeatures12{};
+    deviceFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    deviceFeatures12.pNext = &deviceFeatures13;
+    deviceFeatures12.timelineSemaphore = VK_TRUE;
 
     // create device info
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &deviceFeatures12;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
@@ -313,22 +388,46 @@ bool VulkanLoader::isVkDeviceSuitable(
         QueueFamilyIndices queueFamilyIndices) const
 {
     // check device properties
-    if(deviceProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+    // >> headless also accepts integrated, virtual and cpu devices (server gpus, lavapipe)
+    if(!isHeadless && deviceProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
         return false;
 
     // check device features
-    if(!deviceFeatures.geometryShader)
+    if(!isHeadless && !deviceFeatures.geometryShader)
         return false;
 
     // check if queue families are complete
     if(!queueFamilyIndices.IsComplete())
         return false;
 
+    // check vulkan 1.2 and 1.3 features
+    if(deviceProperties.apiVersion < VK_API_VERSION_1_3)
+        return false;
+
+    VkPhysicalDeviceVulkan13Features deviceFeatures13{};
+    deviceFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+    VkPhysicalDeviceVulkan12Features deviceFeatures12{};
+    deviceFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    deviceFeatures12.pNext = &deviceFeatures13;
+
+    VkPhysicalDeviceFeatures2 deviceFeatures2{};
+    deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures2.pNext = &deviceFeatures12;
+    vkGetPhysicalDeviceFeatures2(device, &deviceFeatures2);
+
+    if(!deviceFeatures12.timelineSemaphore || !deviceFeatures13.dynamicRendering)
+        return false;
+
     // try find device extensions
     bool foundDeviceExtensions = findRequiredDeviceExtensions(device);
     if(!foundDeviceExtensions)
         return false;
 
+    // headless: nothing is presented, no swap chain support required
+    if(isHeadless)
+        return true;
+
     // check if swap chain is valid
     // >> see device & surface
     SwapChainDeviceSupport swapChainSupport = swapChain.QuerySwapChainSupport(device, surface);
@@ -365,13 +464,24 @@ VulkanLoader::QueueFamilyIndices VulkanLoader::findQueueFamilies(const VkPhysica
             queueFamilyIndices.transferFamily = familyIndex;
 
         // set present family
+        // >> headless: there is no surface to query
         VkBool32 isPresentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, familyIndex, surface, &isPresentSupport);
+        if(surface != VK_NULL_HANDLE)
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, familyIndex, surface, &isPresentSupport);
         if(isPresentSupport)
             queueFamilyIndices.presentFamily = familyIndex;
 
         ++familyIndex;
     }
+
+    // fall back to the graphics family when the device has no dedicated transfer family (lavapipe, some integrated gpus)
+    if(!queueFamilyIndices.transferFamily.has_value())
+        queueFamilyIndices.transferFamily = queueFamilyIndices.graphicsFamily;
+
+    // headless: presenting only advances the offscreen image ring, use the graphics queue
+    if(surface == VK_NULL_HANDLE)
+        queueFamilyIndices.presentFamily = queueFamilyIndices.graphicsFamily;
+
     return queueFamilyIndices;
 }
 
@@ -395,6 +505,40 @@ bool VulkanLoader::findRequiredDeviceExtensions(const VkPhysicalDevice & device)
     return requiredExtensions.empty();
 }
 
+bool VulkanLoader::isDeviceExtensionSupported(const VkPhysicalDevice& device, const char* extensionName) const
+{
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+    for(const auto& extension : availableExtensions)
+    {
+        if(std::strcmp(extension.extensionName, extensionName) == 0)
+            return true;
+    }
+    return false;
+}
+
+/// @return true when VK_EXT_calibrated_timestamps is available and can calibrate the device time domain
+bool VulkanLoader::isDeviceClockCalibrateable(const VkPhysicalDevice& device) const
+{
+    if(!isDeviceExtensionSupported(device, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+        return false;
+
+    auto func = (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT) vkGetInstanceProcAddr(vkInstance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT");
+    if(func == nullptr)
+        return false;
+
+    uint32_t timeDomainCount = 0;
+    func(device, &timeDomainCount, nullptr);
+    std::vector<VkTimeDomainEXT> timeDomains(timeDomainCount);
+    func(device, &timeDomainCount, timeDomains.data());
+
+    return std::find(timeDomains.begin(), timeDomains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != timeDomains.end();
+}
+
 #pragma endregion vk_devices
 
 #pragma region vk_pipeline
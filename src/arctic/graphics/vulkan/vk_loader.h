@@ -5,21 +5,25 @@
 #include <set>
 #include <vulkan/vulkan_core.h>
 #include <memory>
+#include "arctic/graphics/rhi/memory_pool_sizes.h"
+#include "arctic/graphics/rhi/present_settings.h"
 
 class VulkanWindow;
 class VulkanRenderPipeline;
 class VulkanSwapChain;
 class VulkanRenderLoop;
 class VulkanMemoryHandler;
+class VulkanPipelineCache;
 
 class VulkanLoader
 {
 public:
-    VulkanLoader(std::shared_ptr<VulkanWindow> vulkanWindow);
+    VulkanLoader(std::shared_ptr<VulkanWindow> vulkanWindow, const PresentSettings& presentSettings, const MemoryPoolSizes& memoryPoolSizes);
     void Cleanup();
 
     std::shared_ptr<VulkanRenderLoop> GetRenderLoop();
-    void ReloadSwapChain();
+    std::shared_ptr<VulkanMemoryHandler> GetMemoryHandler();
+    bool ReloadSwapChain();
 
 private:
 
@@ -33,9 +37,12 @@ private:
     VkQueue vkTransferQueue;
     VkQueue vkPresentQueue;
 
-    const std::vector<const char*> requiredDeviceExtensions = {
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME
-    };
+    // headless: no surface and no swapchain, rendering happens into offscreen images
+    bool isHeadless = false;
+
+    std::vector<const char*> requiredDeviceExtensions;
+    bool isMemoryBudgetSupported = false;
+    bool isCalibratedTimestampsSupported = false;
 
     struct QueueFamilyIndices
     {
@@ -51,11 +58,12 @@ private:
         }
     };
 
-    VkSurfaceKHR vkSurface;
+    VkSurfaceKHR vkSurface = VK_NULL_HANDLE;
     std::shared_ptr<VulkanSwapChain> pSwapchain;
     std::shared_ptr<VulkanRenderPipeline> pRenderPipeline;
     std::shared_ptr<VulkanRenderLoop> pRenderLoop;
     std::shared_ptr<VulkanMemoryHandler> pMemoryHandler;
+    std::shared_ptr<VulkanPipelineCache> pPipelineCache;
 
     void vulkanCreateInstance(const VulkanWindow & vulkanWindow);
     void vulkanLoadDebugMessenger();
@@ -77,6 +85,8 @@ private:
                             QueueFamilyIndices queueFamilyIndices) const;
     QueueFamilyIndices findQueueFamilies(const VkPhysicalDevice& device, const VkSurfaceKHR & surface);
     bool findRequiredDeviceExtensions(const VkPhysicalDevice& device) const;
+    bool isDeviceExtensionSupported(const VkPhysicalDevice& device, const char* extensionName) const;
+    bool isDeviceClockCalibrateable(const VkPhysicalDevice& device) const;
 
     // validation layers
     const bool enableValidationLayers = false;
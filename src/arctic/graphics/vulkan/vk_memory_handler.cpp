@@ -2,6 +2,8 @@
 #include <iostream>
 #include <vector>
 #include <cstring>
+#include <algorithm>
+#include <iterator>
 #include "vk_mem_alloc.h"
 
 VulkanMemoryHandler::VulkanMemoryHandler(
@@ -9,19 +11,23 @@ VulkanMemoryHandler::VulkanMemoryHandler(
     VkPhysicalDevice& vkPhysicalDevice,
     VkInstance& vkInstance,
     VkQueue& vkGraphicsQueue,
-    VkQueue& vkTransferQueue)
+    VkQueue& vkTransferQueue,
+    const MemoryPoolSizes& poolSizes,
+    bool isMemoryBudgetEnabled)
 :
 vkDevice(vkDevice),
 vkPhysicalDevice(vkPhysicalDevice),
 vkGraphicsQueue(vkGraphicsQueue),
-vkTransferQueue(vkTransferQueue)
+vkTransferQueue(vkTransferQueue),
+isBudgetEstimated(!isMemoryBudgetEnabled)
 {
     VmaVulkanFunctions vulkanFunctions = {};
     vulkanFunctions.vkGetInstanceProcAddr = &vkGetInstanceProcAddr;
     vulkanFunctions.vkGetDeviceProcAddr = &vkGetDeviceProcAddr;
     
+    // memory budget: only with VK_EXT_memory_budget enabled on the device, otherwise vma estimates the budgets
     VmaAllocatorCreateInfo allocatorCreateInfo = {};
-    allocatorCreateInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    allocatorCreateInfo.flags = isMemoryBudgetEnabled ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0;
     allocatorCreateInfo.vulkanApiVersion = VK_API_VERSION_1_3;
     allocatorCreateInfo.physicalDevice = vkPhysicalDevice;
     allocatorCreateInfo.device = vkDevice;
@@ -29,202 +35,455 @@ vkTransferQueue(vkTransferQueue)
     allocatorCreateInfo.pVulkanFunctions = &vulkanFunctions;
     
     vmaCreateAllocator(&allocatorCreateInfo, &vmaAllocator);
+
+    // cache device properties (limits, alignments, ...)
+    vkGetPhysicalDeviceProperties(vkPhysicalDevice, &vkPhysicalDeviceProperties);
+
+    // create one pool per resource class
+    createPools(poolSizes);
 }
 
 void VulkanMemoryHandler::Cleanup()
 {
+    for(auto& pool : vmaPools)
+    {
+        if(pool != VK_NULL_HANDLE)
+            vmaDestroyPool(this->vmaAllocator, pool);
+        pool = VK_NULL_HANDLE;
+    }
+
     vmaDestroyAllocator(this->vmaAllocator);
 }
 
-/// @brief creates a buffer and device memory for the buffer
-/// @param size defines the size of the buffer 
+/// @brief creates a buffer and binds it to memory allocated through vma
+/// @param bufferSize size of the buffer in bytes
 /// @param usage defines how the buffer can be used using bit flags (src / dst / vertex / ...)
-/// @param properties defines the memory properties of the buffer
-/// @param buffer reference to the actual buffer
-/// @param bufferMemory reference to the actual memory the buffer will be using
-/// @return 
-bool VulkanMemoryHandler::CreateBuffer(
-    VkDeviceSize size, 
-    VkBufferUsageFlags usage, 
-    VkMemoryPropertyFlags properties, 
-    VkBuffer& buffer, 
-    VkDeviceMemory& bufferMemory)
+/// @param vmaFlags vma allocation flags (host access, mapped, ...)
+/// @param memoryClass selects the pool the memory is allocated from
+/// @param pBuffer the created buffer
+/// @param pBufferAllocation the allocation backing the buffer
+/// @return true when creation was successful
+bool VulkanMemoryHandler::CreateBufferVMA(VkDeviceSize bufferSize, VkBufferUsageFlags usage, VmaAllocationCreateFlags vmaFlags, MemoryClass memoryClass, VkBuffer *pBuffer, VmaAllocation *pBufferAllocation)
 {
     // create buffer info
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = size;
+    bufferInfo.size = bufferSize;
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    // the following may be needed when using CONCURRENT sharing mode
-    //bufferInfo.queueFamilyIndexCount = 2;
-    //std::vector<uint32_t> allowedQueueIndices { 0, 1};
-    //bufferInfo.pQueueFamilyIndices = allowedQueueIndices.data();
 
-    // create buffer
-    VkResult result = vkCreateBuffer(vkDevice, &bufferInfo, nullptr, &buffer);
-    if (result != VK_SUCCESS)
+    // create allocation info
+    VmaAllocationCreateInfo allocCreateInfo{};
+    allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocCreateInfo.flags = vmaFlags;
+    allocCreateInfo.pool = GetPool(memoryClass);
+    allocCreateInfo.pUserData = reinterpret_cast<void*>(static_cast<uintptr_t>(memoryClass)); // owner tag for statistics
+
+    // buffers larger than a block of the pool never fit, allocate them on their own
+    if (isLargerThanBlock(memoryClass, bufferSize))
+        useDedicatedMemory(allocCreateInfo);
+
+    // create buffer vma
+    VkResult result = vmaCreateBuffer(this->vmaAllocator, &bufferInfo, &allocCreateInfo, pBuffer, pBufferAllocation, nullptr);
+
+    // the pool's memory type may not be allowed for this usage, fall back to the vma default pools
+    if (result == VK_ERROR_FEATURE_NOT_PRESENT && allocCreateInfo.pool != VK_NULL_HANDLE)
     {
-        std::cout << "error: vulkan: failed to create buffer!";
-        return false;
+        allocCreateInfo.pool = VK_NULL_HANDLE;
+        result = vmaCreateBuffer(this->vmaAllocator, &bufferInfo, &allocCreateInfo, pBuffer, pBufferAllocation, nullptr);
     }
 
-    // create memory allocation info (for the buffer)
-    VkMemoryRequirements vbMemoryRequirements;
-    vkGetBufferMemoryRequirements(vkDevice, buffer, &vbMemoryRequirements);
+    // the pool could not place the buffer in a new block, retry with a dedicated allocation
+    if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY && allocCreateInfo.pool != VK_NULL_HANDLE)
+    {
+        useDedicatedMemory(allocCreateInfo);
+        result = vmaCreateBuffer(this->vmaAllocator, &bufferInfo, &allocCreateInfo, pBuffer, pBufferAllocation, nullptr);
+    }
+    if (result != VK_SUCCESS)
+        return false;
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = vbMemoryRequirements.size;
+    trackAllocation(memoryClass, *pBufferAllocation);
+    return true;
+}
 
-    uint32_t memoryTypeIndex;
-    if(!FindMemoryType(vbMemoryRequirements.memoryTypeBits, properties, memoryTypeIndex))
-    {
-        std::cout << "error: vulkan: failed to allocate memory!";
+bool VulkanMemoryHandler::CopyDataToBufferVMA(void* pDataToCopy, VkDeviceSize bufferSize, VmaAllocation &bufferAllocation)
+{
+    void* data;
+    if(vmaMapMemory(this->vmaAllocator, bufferAllocation, &data) != VK_SUCCESS)
         return false;
+    memcpy(data, pDataToCopy, bufferSize);
+    vmaUnmapMemory(this->vmaAllocator, bufferAllocation);
+    return true;
+}
+
+/// @brief destroys the buffer and frees its allocation, resets both handles
+void VulkanMemoryHandler::DestroyBuffer(VkBuffer& buffer, VmaAllocation& allocation)
+{
+    trackFree(allocation);
+    vmaDestroyBuffer(this->vmaAllocator, buffer, allocation);
+    buffer = VK_NULL_HANDLE;
+    allocation = VK_NULL_HANDLE;
+}
+
+/// @brief creates an image and binds it to memory allocated through vma
+/// @param imageInfo describes the image (format, extent, usage, ...)
+/// @param vmaFlags vma allocation flags
+/// @param memoryClass selects the pool the memory is allocated from
+/// @param pImage the created image
+/// @param pImageAllocation the allocation backing the image
+/// @return true when creation was successful
+bool VulkanMemoryHandler::CreateImageVMA(const VkImageCreateInfo& imageInfo, VmaAllocationCreateFlags vmaFlags, MemoryClass memoryClass, VkImage *pImage, VmaAllocation *pImageAllocation)
+{
+    // create allocation info
+    VmaAllocationCreateInfo allocCreateInfo{};
+    allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocCreateInfo.flags = vmaFlags;
+    allocCreateInfo.pool = GetPool(memoryClass);
+    allocCreateInfo.pUserData = reinterpret_cast<void*>(static_cast<uintptr_t>(memoryClass)); // owner tag for statistics
+
+    // create image vma
+    VkResult result = vmaCreateImage(this->vmaAllocator, &imageInfo, &allocCreateInfo, pImage, pImageAllocation, nullptr);
+
+    // the pool's memory type may not be allowed for this format / usage, fall back to the vma default pools
+    if (result == VK_ERROR_FEATURE_NOT_PRESENT && allocCreateInfo.pool != VK_NULL_HANDLE)
+    {
+        allocCreateInfo.pool = VK_NULL_HANDLE;
+        result = vmaCreateImage(this->vmaAllocator, &imageInfo, &allocCreateInfo, pImage, pImageAllocation, nullptr);
     }
-    allocInfo.memoryTypeIndex = memoryTypeIndex;
-    
-    // create buffer memory
-    result = vkAllocateMemory(this->vkDevice, &allocInfo, nullptr, &bufferMemory);
-    if (result != VK_SUCCESS)
+
+    // the image is larger than a block of the pool (or the pool cannot grow), retry with a dedicated allocation
+    // >> the size of an image is only known from its memory requirements, vma reports it as out of memory
+    if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY && allocCreateInfo.pool != VK_NULL_HANDLE)
     {
-        std::cout << "error: vulkan: failed to allocate memory!";
-        return false;
+        useDedicatedMemory(allocCreateInfo);
+        result = vmaCreateImage(this->vmaAllocator, &imageInfo, &allocCreateInfo, pImage, pImageAllocation, nullptr);
     }
+    if (result != VK_SUCCESS)
+        return false;
 
-    // bind the memory to the buffer
-    vkBindBufferMemory(this->vkDevice, buffer, bufferMemory, 0);
+    trackAllocation(memoryClass, *pImageAllocation);
     return true;
 }
 
-/// @brief copies buffer data from source to dest
-/// @param srcBuffer 
-/// @param dstBuffer 
-/// @param size 
-bool VulkanMemoryHandler::CopyBufferToBuffer(
-    VkBuffer srcBuffer, 
-    VkBuffer dstBuffer, 
-    VkDeviceSize size,
-    VkCommandPool& commandPool)
-{
-    // create info: command buffer allocation
-    VkCommandBufferAllocateInfo allocInfo {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = commandPool;
-    allocInfo.commandBufferCount = 1;
-
-    // create command buffer
-    VkCommandBuffer commandBuffer;
-    VkResult result = vkAllocateCommandBuffers(this->vkDevice, &allocInfo, &commandBuffer);
-    if (result != VK_SUCCESS)
+/// @brief destroys the image and frees its allocation, resets both handles
+void VulkanMemoryHandler::DestroyImage(VkImage& image, VmaAllocation& allocation)
+{
+    trackFree(allocation);
+    vmaDestroyImage(this->vmaAllocator, image, allocation);
+    image = VK_NULL_HANDLE;
+    allocation = VK_NULL_HANDLE;
+}
+
+/// @brief allocates device local memory for the requirements without creating a resource
+/// @param memoryRequirements combined requirements of every image that will be bound to the memory
+/// @param memoryClass owner of the allocation for statistics
+/// @param pAllocation the allocated memory
+/// @return true when allocation was successful
+bool VulkanMemoryHandler::AllocateMemoryVMA(const VkMemoryRequirements& memoryRequirements, MemoryClass memoryClass, VmaAllocation *pAllocation)
+{
+    // create allocation info
+    // >> no resource to deduce the usage from, the memory type is picked by its property flags
+    VmaAllocationCreateInfo allocCreateInfo{};
+    allocCreateInfo.usage = VMA_MEMORY_USAGE_UNKNOWN;
+    allocCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    allocCreateInfo.pool = GetPool(memoryClass);
+    allocCreateInfo.pUserData = reinterpret_cast<void*>(static_cast<uintptr_t>(memoryClass)); // owner tag for statistics
+
+    // memory larger than a block of the pool never fits, allocate it on its own
+    if (isLargerThanBlock(memoryClass, memoryRequirements.size))
+        useDedicatedMemory(allocCreateInfo);
+
+    // allocate memory vma
+    VkResult result = vmaAllocateMemory(this->vmaAllocator, &memoryRequirements, &allocCreateInfo, pAllocation, nullptr);
+
+    // the pool's memory type may not be allowed for these requirements, fall back to the vma default pools
+    if (result == VK_ERROR_FEATURE_NOT_PRESENT && allocCreateInfo.pool != VK_NULL_HANDLE)
     {
-        std::cout << "error: vulkan: failed to create command buffer!";
-        return false;
+        allocCreateInfo.pool = VK_NULL_HANDLE;
+        result = vmaAllocateMemory(this->vmaAllocator, &memoryRequirements, &allocCreateInfo, pAllocation, nullptr);
     }
 
-    // command buffer: start executing commands
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    // the pool could not place the memory in a new block, retry with a dedicated allocation
+    if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY && allocCreateInfo.pool != VK_NULL_HANDLE)
+    {
+        useDedicatedMemory(allocCreateInfo);
+        result = vmaAllocateMemory(this->vmaAllocator, &memoryRequirements, &allocCreateInfo, pAllocation, nullptr);
+    }
+    if (result != VK_SUCCESS)
+        return false;
 
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    trackAllocation(memoryClass, *pAllocation);
+    return true;
+}
 
-    // command: copy the buffers src >> dst
-    VkBufferCopy copyRegion{};
-    copyRegion.srcOffset = 0; // Optional
-    copyRegion.dstOffset = 0; // Optional
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+/// @brief binds the image to the start of the allocation
+bool VulkanMemoryHandler::BindImageMemoryVMA(VmaAllocation allocation, VkImage image)
+{
+    return vmaBindImageMemory(this->vmaAllocator, allocation, image) == VK_SUCCESS;
+}
 
-    // command buffer: end executing commands
-    vkEndCommandBuffer(commandBuffer);
+/// @brief frees memory of AllocateMemoryVMA, images bound to it must be destroyed first, resets the handle
+void VulkanMemoryHandler::FreeMemory(VmaAllocation& allocation)
+{
+    if(allocation == VK_NULL_HANDLE)
+        return;
 
-    // execute the command buffer
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
+    trackFree(allocation);
+    vmaFreeMemory(this->vmaAllocator, allocation);
+    allocation = VK_NULL_HANDLE;
+}
 
-    vkQueueSubmit(this->vkTransferQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(this->vkTransferQueue);
+VmaAllocator &VulkanMemoryHandler::GetAllocator()
+{
+    return this->vmaAllocator;
+}
 
-    // cleanup
-    vkFreeCommandBuffers(this->vkDevice, commandPool, 1, &commandBuffer);
-    return true;
+/// @brief returns the pool of a resource class, VK_NULL_HANDLE for the vma default pools
+VmaPool VulkanMemoryHandler::GetPool(MemoryClass memoryClass) const
+{
+    return this->vmaPools[static_cast<size_t>(memoryClass)];
+}
+
+const VkPhysicalDeviceProperties& VulkanMemoryHandler::GetPhysicalDeviceProperties() const
+{
+    return this->vkPhysicalDeviceProperties;
+}
+
+const VkPhysicalDevice& VulkanMemoryHandler::GetPhysicalDevice() const
+{
+    return this->vkPhysicalDevice;
 }
 
-/// @brief 
-/// @param typeFilter used to specify the bit field of memory types that are suitable
-/// @param properties 
-/// @param memoryType 
-/// @return 
-bool VulkanMemoryHandler::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& memoryTypeIndex)
+/// @brief advances the vma frame index, vma refreshes the heap budgets once per frame
+/// @param frameIndex index of the frame that is being recorded
+void VulkanMemoryHandler::BeginFrame(uint32_t frameIndex)
 {
-    // get memory properties of physical device
-    // >> has memory types: distinct memory resources like dedicated VRAM
-    // >> has memory heaps: the different types of memory exist within these heaps
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice, &memProperties);
+    vmaSetCurrentFrameIndex(this->vmaAllocator, frameIndex);
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(this->vmaAllocator, budgets);
+    updateHeapPeaks(budgets);
+}
+
+/// @brief collects usage against budget per heap, live allocations per memory type and per owner
+/// @brief >> calculating the per type statistics walks all blocks, meant for periodic reporting and not for every frame
+MemoryStats VulkanMemoryHandler::GetMemoryStats()
+{
+    MemoryStats stats{};
+    stats.isBudgetEstimated = isBudgetEstimated;
+
+    const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+    vmaGetMemoryProperties(this->vmaAllocator, &pMemoryProperties);
 
-    // loop over all properties
-    // >> try find matching memorty index
-    for (uint32_t i=0; i < memProperties.memoryTypeCount; i++) 
+    // heaps
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(this->vmaAllocator, budgets);
+    updateHeapPeaks(budgets);
+
+    for(uint32_t i = 0; i < pMemoryProperties->memoryHeapCount; ++i)
     {
-        // typeFilter: we can find the index of a suitable memory by checking if the corresponding bit is set to 1
-        // 
-        if ((typeFilter & (1 << i)) && 
-            (memProperties.memoryTypes[i].propertyFlags & properties) == properties) 
-        {
-            memoryTypeIndex = i;
-            return true;
-        }
+        HeapStats heap{};
+        heap.heapIndex = i;
+        heap.isDeviceLocal = (pMemoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        heap.budgetBytes = budgets[i].budget;
+        heap.usageBytes = budgets[i].usage;
+        heap.peakUsageBytes = heapPeakUsage[i];
+        heap.blockBytes = budgets[i].statistics.blockBytes;
+        heap.allocationBytes = budgets[i].statistics.allocationBytes;
+        stats.heaps.push_back(heap);
     }
-    return false;
+
+    // memory types
+    VmaTotalStatistics totalStatistics{};
+    vmaCalculateStatistics(this->vmaAllocator, &totalStatistics);
+
+    for(uint32_t i = 0; i < pMemoryProperties->memoryTypeCount; ++i)
+    {
+        const VmaStatistics& statistics = totalStatistics.memoryType[i].statistics;
+        if(statistics.blockCount == 0)
+            continue;
+
+        MemoryTypeStats memoryType{};
+        memoryType.memoryTypeIndex = i;
+        memoryType.heapIndex = pMemoryProperties->memoryTypes[i].heapIndex;
+        memoryType.blockCount = statistics.blockCount;
+        memoryType.allocationCount = statistics.allocationCount;
+        memoryType.blockBytes = statistics.blockBytes;
+        memoryType.allocationBytes = statistics.allocationBytes;
+        stats.memoryTypes.push_back(memoryType);
+    }
+
+    // owners
+    const char* ownerNames[] = { "other", "mesh", "uniform", "staging", "texture" };
+    static_assert(std::size(ownerNames) == static_cast<size_t>(MemoryClass::Count), "missing owner name of memory class");
+
+    for(size_t i = 0; i < ownerCounters.size(); ++i)
+    {
+        OwnerStats owner{};
+        owner.owner = ownerNames[i];
+        owner.allocationCount = ownerCounters[i].allocationCount.load(std::memory_order_relaxed);
+        owner.allocationBytes = ownerCounters[i].allocationBytes.load(std::memory_order_relaxed);
+        owner.peakAllocationBytes = ownerCounters[i].peakAllocationBytes.load(std::memory_order_relaxed);
+        stats.owners.push_back(owner);
+    }
+    return stats;
 }
 
-bool VulkanMemoryHandler::CopyDataToBuffer(void *pDataToCopy, VkDeviceSize bufferSize, VkDeviceMemory memory)
+void VulkanMemoryHandler::trackAllocation(MemoryClass memoryClass, VmaAllocation allocation)
 {
-    void* data;
-    if(vkMapMemory(this->vkDevice, memory, 0, bufferSize, 0, &data) != VK_SUCCESS)
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(this->vmaAllocator, allocation, &allocationInfo);
+
+    OwnerCounters& counters = ownerCounters[static_cast<size_t>(memoryClass)];
+    counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+    uint64_t bytes = counters.allocationBytes.fetch_add(allocationInfo.size, std::memory_order_relaxed) + allocationInfo.size;
+
+    // peak: raise to bytes unless another thread already raised it further
+    uint64_t peak = counters.peakAllocationBytes.load(std::memory_order_relaxed);
+    while(peak < bytes && !counters.peakAllocationBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+void VulkanMemoryHandler::trackFree(VmaAllocation allocation)
+{
+    if(allocation == VK_NULL_HANDLE)
+        return;
+
+    // owner is stored in the user data of the allocation
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(this->vmaAllocator, allocation, &allocationInfo);
+    size_t memoryClass = static_cast<size_t>(reinterpret_cast<uintptr_t>(allocationInfo.pUserData));
+    if(memoryClass >= ownerCounters.size())
+        return;
+
+    OwnerCounters& counters = ownerCounters[memoryClass];
+    counters.allocationCount.fetch_sub(1, std::memory_order_relaxed);
+    counters.allocationBytes.fetch_sub(allocationInfo.size, std::memory_order_relaxed);
+}
+
+/// @brief pools with an explicit block size never allocate dedicated memory, larger resources cannot be placed in them
+bool VulkanMemoryHandler::isLargerThanBlock(MemoryClass memoryClass, VkDeviceSize size) const
+{
+    if(GetPool(memoryClass) == VK_NULL_HANDLE)
         return false;
-    memcpy(data, pDataToCopy, bufferSize);
-    vkUnmapMemory(this->vkDevice, memory);
-    return true;
+
+    VkDeviceSize blockSize = this->poolBlockSizes[static_cast<size_t>(memoryClass)];
+    return blockSize != 0 && size > blockSize;
 }
 
-bool VulkanMemoryHandler::CreateBufferVMA(VkDeviceSize bufferSize, VkBufferUsageFlags usage, VmaAllocationCreateFlags vmaFlags, VkBuffer *pBuffer, VmaAllocation *pBufferAllocation)
+/// @brief moves the allocation out of its pool into its own device memory, the owner tag (user data) is kept
+void VulkanMemoryHandler::useDedicatedMemory(VmaAllocationCreateInfo& allocCreateInfo) const
 {
-    // create buffer info
+    allocCreateInfo.pool = VK_NULL_HANDLE;
+    allocCreateInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+}
+
+void VulkanMemoryHandler::updateHeapPeaks(const VmaBudget* pBudgets)
+{
+    const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+    vmaGetMemoryProperties(this->vmaAllocator, &pMemoryProperties);
+
+    for(uint32_t i = 0; i < pMemoryProperties->memoryHeapCount; ++i)
+        heapPeakUsage[i] = std::max(heapPeakUsage[i], pBudgets[i].usage);
+}
+
+/// @brief creates the custom pools
+/// @brief >> the memory type of each pool is selected with a representative resource of the class
+bool VulkanMemoryHandler::createPools(const MemoryPoolSizes& poolSizes)
+{
+    VmaAllocationCreateFlags hostWriteFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    bool isSuccess = true;
+    isSuccess &= createBufferPool(
+        MemoryClass::Geometry, 
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 
+        0, 
+        poolSizes.geometryBlockSize);
+    isSuccess &= createBufferPool(
+        MemoryClass::Uniform, 
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 
+        hostWriteFlags, 
+        poolSizes.uniformBlockSize);
+    isSuccess &= createBufferPool(
+        MemoryClass::Staging, 
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
+        hostWriteFlags, 
+        poolSizes.stagingBlockSize);
+    isSuccess &= createImagePool(
+        MemoryClass::Texture, 
+        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, 
+        poolSizes.textureBlockSize);
+    return isSuccess;
+}
+
+bool VulkanMemoryHandler::createBufferPool(MemoryClass memoryClass, VkBufferUsageFlags usage, VmaAllocationCreateFlags vmaFlags, VkDeviceSize blockSize)
+{
+    // representative buffer of the class
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = bufferSize;
+    bufferInfo.size = 1024;
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    // create buffer vma
     VmaAllocationCreateInfo allocCreateInfo{};
     allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
     allocCreateInfo.flags = vmaFlags;
 
-    // create buffer vma
-    if (vmaCreateBuffer(this->vmaAllocator, &bufferInfo, &allocCreateInfo, pBuffer, pBufferAllocation, nullptr) != VK_SUCCESS)
+    uint32_t memoryTypeIndex = 0;
+    if (vmaFindMemoryTypeIndexForBufferInfo(this->vmaAllocator, &bufferInfo, &allocCreateInfo, &memoryTypeIndex) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to find memory type for buffer pool!";
         return false;
-    return true;
+    }
+    return createPool(memoryClass, memoryTypeIndex, blockSize);
 }
 
-bool VulkanMemoryHandler::CopyDataToBufferVMA(void* pDataToCopy, VkDeviceSize bufferSize, VmaAllocation &bufferAllocation)
+bool VulkanMemoryHandler::createImagePool(MemoryClass memoryClass, VkImageUsageFlags usage, VkDeviceSize blockSize)
 {
-    void* data;
-    if(vmaMapMemory(this->vmaAllocator, bufferAllocation, &data) != VK_SUCCESS)
+    // representative image of the class
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {256, 256, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+    VmaAllocationCreateInfo allocCreateInfo{};
+    allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+    uint32_t memoryTypeIndex = 0;
+    if (vmaFindMemoryTypeIndexForImageInfo(this->vmaAllocator, &imageInfo, &allocCreateInfo, &memoryTypeIndex) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to find memory type for image pool!";
         return false;
-    memcpy(data, pDataToCopy, bufferSize);
-    vmaUnmapMemory(this->vmaAllocator, bufferAllocation);
-    return true;
+    }
+    return createPool(memoryClass, memoryTypeIndex, blockSize);
 }
 
-VmaAllocator &VulkanMemoryHandler::GetAllocator()
+bool VulkanMemoryHandler::createPool(MemoryClass memoryClass, uint32_t memoryTypeIndex, VkDeviceSize blockSize)
 {
-    return this->vmaAllocator;
-}
+    // create info: pool
+    // >> blocks are allocated on demand (minBlockCount 0) and without upper limit (maxBlockCount 0)
+    VmaPoolCreateInfo poolInfo{};
+    poolInfo.memoryTypeIndex = memoryTypeIndex;
+    poolInfo.blockSize = blockSize;
+    poolInfo.minBlockCount = 0;
+    poolInfo.maxBlockCount = 0;
+
+    VmaPool& pool = this->vmaPools[static_cast<size_t>(memoryClass)];
+    if (vmaCreatePool(this->vmaAllocator, &poolInfo, &pool) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create memory pool!";
+        pool = VK_NULL_HANDLE;
+        return false;
+    }
+    this->poolBlockSizes[static_cast<size_t>(memoryClass)] = blockSize;
+    return true;
+}
\ No newline at end of file
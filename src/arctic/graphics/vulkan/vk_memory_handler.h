@@ -1,27 +1,89 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <vulkan/vulkan_core.h>
 #include "vk_mem_alloc.h"
+#include "arctic/graphics/rhi/memory_pool_sizes.h"
+#include "arctic/graphics/rhi/memory_stats.h"
+
+/// @brief resource classes, every class except Default is allocated from its own vma pool
+/// @brief >> resources of one class have similar sizes and lifetimes, keeping them together limits fragmentation
+enum class MemoryClass : uint32_t
+{
+    Default = 0,    // vma default pools (render targets, one-off resources)
+    Geometry,       // vertex / index buffers, device local
+    Uniform,        // uniform buffers, host visible and persistently mapped
+    Staging,        // transfer source buffers, host visible and persistently mapped
+    Texture,        // sampled images, device local
+    Count
+};
 
 class VulkanMemoryHandler
 {
 public:
-    VulkanMemoryHandler(VkDevice& vkDevice, VkPhysicalDevice& vkPhysicalDevice, VkInstance& vkInstance, VkQueue& vkGraphicsQueue, VkQueue& vkTransferQueue);
+    VulkanMemoryHandler(
+        VkDevice& vkDevice, 
+        VkPhysicalDevice& vkPhysicalDevice, 
+        VkInstance& vkInstance, 
+        VkQueue& vkGraphicsQueue, 
+        VkQueue& vkTransferQueue,
+        const MemoryPoolSizes& poolSizes = MemoryPoolSizes(),
+        bool isMemoryBudgetEnabled = false);
     void Cleanup();
-    
-    bool CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
-    bool CopyBufferToBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkCommandPool& commandPool);
-    bool FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& memoryTypeIndex);
-    bool CopyDataToBuffer(void* pDataToCopy, VkDeviceSize bufferSize, VkDeviceMemory memory);
 
-    bool CreateBufferVMA(VkDeviceSize bufferSize, VkBufferUsageFlags usage, VmaAllocationCreateFlags vmaFlags, VkBuffer *pBuffer, VmaAllocation *pBufferAllocation);
+    bool CreateBufferVMA(VkDeviceSize bufferSize, VkBufferUsageFlags usage, VmaAllocationCreateFlags vmaFlags, MemoryClass memoryClass, VkBuffer *pBuffer, VmaAllocation *pBufferAllocation);
     bool CopyDataToBufferVMA(void* pDataToCopy, VkDeviceSize bufferSize, VmaAllocation &bufferAllocation);
+    void DestroyBuffer(VkBuffer& buffer, VmaAllocation& allocation);
+
+    bool CreateImageVMA(const VkImageCreateInfo& imageInfo, VmaAllocationCreateFlags vmaFlags, MemoryClass memoryClass, VkImage *pImage, VmaAllocation *pImageAllocation);
+    void DestroyImage(VkImage& image, VmaAllocation& allocation);
+
+    // raw memory: bound to images created by the caller, several images can share (alias) one allocation
+    bool AllocateMemoryVMA(const VkMemoryRequirements& memoryRequirements, MemoryClass memoryClass, VmaAllocation *pAllocation);
+    bool BindImageMemoryVMA(VmaAllocation allocation, VkImage image);
+    void FreeMemory(VmaAllocation& allocation);
 
     VmaAllocator& GetAllocator();
+    VmaPool GetPool(MemoryClass memoryClass) const;
+    const VkPhysicalDeviceProperties& GetPhysicalDeviceProperties() const;
+    const VkPhysicalDevice& GetPhysicalDevice() const;
+
+    // statistics
+    void BeginFrame(uint32_t frameIndex);
+    MemoryStats GetMemoryStats();
 private:
     VkDevice vkDevice;
     VkPhysicalDevice vkPhysicalDevice;
+    VkPhysicalDeviceProperties vkPhysicalDeviceProperties;
     VkQueue vkGraphicsQueue;
     VkQueue vkTransferQueue;
     VmaAllocator vmaAllocator;
+
+    std::array<VmaPool, static_cast<size_t>(MemoryClass::Count)> vmaPools{};
+    std::array<VkDeviceSize, static_cast<size_t>(MemoryClass::Count)> poolBlockSizes{};
+
+    // statistics: live allocations per class (owner), updated from any thread creating resources
+    struct OwnerCounters
+    {
+        std::atomic<uint64_t> allocationCount = 0;
+        std::atomic<uint64_t> allocationBytes = 0;
+        std::atomic<uint64_t> peakAllocationBytes = 0;
+    };
+    std::array<OwnerCounters, static_cast<size_t>(MemoryClass::Count)> ownerCounters;
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> heapPeakUsage{};
+    bool isBudgetEstimated = true;
+
+    void trackAllocation(MemoryClass memoryClass, VmaAllocation allocation);
+    void trackFree(VmaAllocation allocation);
+    void updateHeapPeaks(const VmaBudget* pBudgets);
+
+    // resources that do not fit the blocks of their pool
+    bool isLargerThanBlock(MemoryClass memoryClass, VkDeviceSize size) const;
+    void useDedicatedMemory(VmaAllocationCreateInfo& allocCreateInfo) const;
+
+    bool createPools(const MemoryPoolSizes& poolSizes);
+    bool createBufferPool(MemoryClass memoryClass, VkBufferUsageFlags usage, VmaAllocationCreateFlags vmaFlags, VkDeviceSize blockSize);
+    bool createImagePool(MemoryClass memoryClass, VkImageUsageFlags usage, VkDeviceSize blockSize);
+    bool createPool(MemoryClass memoryClass, uint32_t memoryTypeIndex, VkDeviceSize blockSize);
 };
\ No newline at end of file
@@ -0,0 +1,598 @@
+#include "vk_mip_generator.h"
+#include "vk_memory_handler.h"
+#include "vk_pipeline_cache.h"
+#include "arctic/core/utilities/file_utility.h"
+#include "arctic/core/utilities/application.h"
+#include "arctic/core/utilities/profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <fmt/core.h>
+
+// push constants of the downsample shader
+struct MipConstants
+{
+    int32_t dstWidth;
+    int32_t dstHeight;
+    uint32_t isSrgb; // encode the result to srgb, the storage view of srgb images is unorm
+};
+
+/// @brief creates the sampler and compute pipeline of the fallback path
+/// @return true when creation was successful, a missing compute fallback only disables mips of formats that cannot be blitted
+bool VulkanMipGenerator::Create(VkDevice vkDevice, std::shared_ptr<VulkanMemoryHandler> memoryHandler, std::shared_ptr<VulkanPipelineCache> pipelineCache)
+{
+    this->vkDevice = vkDevice;
+    this->vkPhysicalDevice = memoryHandler->GetPhysicalDevice();
+
+    // create sampler
+    // >> linear + clamp: one tap at the center of a 2x2 block averages it
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = 0.0f;
+
+    if(vkCreateSampler(vkDevice, &samplerInfo, nullptr, &vkSampler) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create mip sampler!";
+        return false;
+    }
+
+    if(!createComputePipeline(*pipelineCache))
+        std::cout << "error: vulkan: mip compute fallback is unavailable!";
+
+    return true;
+}
+
+void VulkanMipGenerator::CleanUp()
+{
+    CollectGarbage(UINT64_MAX);
+    destroyRetired(recordedObjects);
+    requests.clear();
+
+    vkDestroyPipeline(vkDevice, vkPipeline, nullptr);
+    vkDestroyPipelineLayout(vkDevice, vkPipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout, nullptr);
+    vkDestroySampler(vkDevice, vkSampler, nullptr);
+    vkPipeline = VK_NULL_HANDLE;
+    vkPipelineLayout = VK_NULL_HANDLE;
+    vkDescriptorSetLayout = VK_NULL_HANDLE;
+    vkSampler = VK_NULL_HANDLE;
+}
+
+/// @brief number of levels of a full mip chain down to 1x1
+uint32_t VulkanMipGenerator::GetMipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    for(uint32_t size = std::max(width, height); size > 1; size /= 2)
+        ++levels;
+    return levels;
+}
+
+/// @brief true when mips of the format can be generated by either path
+bool VulkanMipGenerator::IsSupported(VkFormat format) const
+{
+    return isBlitSupported(format) || isComputeSupported(format);
+}
+
+/// @brief image usage the texture has to be created with for its mips to be generated
+VkImageUsageFlags VulkanMipGenerator::GetRequiredUsage(VkFormat format) const
+{
+    if(isBlitSupported(format))
+        return VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    return VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+}
+
+/// @brief image create flags the texture has to be created with for its mips to be generated
+/// @brief the compute path writes srgb images through a unorm view, which the srgb format itself does not allow storage on
+VkImageCreateFlags VulkanMipGenerator::GetRequiredCreateFlags(VkFormat format) const
+{
+    if(isBlitSupported(format) || getStorageFormat(format) == format)
+        return 0;
+
+    return VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+}
+
+/// @brief queues the generation of levels 1..mipLevels-1 from level 0
+/// @param image image with all levels in TRANSFER_DST_OPTIMAL and owned by the graphics family when Record runs
+/// @param dstStageMask graphics stages that will read the image (e.g. VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+/// @param dstAccessMask graphics accesses that will read the image (e.g. VK_ACCESS_SHADER_READ_BIT)
+void VulkanMipGenerator::Queue(
+    VkImage image,
+    VkFormat format,
+    uint32_t width,
+    uint32_t height,
+    uint32_t mipLevels,
+    VkPipelineStageFlags dstStageMask,
+    VkAccessFlags dstAccessMask)
+{
+    Request request{};
+    request.image = image;
+    request.format = format;
+    request.width = width;
+    request.height = height;
+    request.mipLevels = mipLevels;
+    request.dstStageMask = dstStageMask;
+    request.dstAccessMask = dstAccessMask;
+    requests.push_back(request);
+}
+
+/// @brief records the generation of all queued mip chains
+/// @param graphicsCommandBuffer recorded after the acquire barriers of the uploads, outside a render pass
+/// @param frameValue frame timeline value signaled by the submit of the command buffer
+void VulkanMipGenerator::Record(VkCommandBuffer graphicsCommandBuffer, uint64_t frameValue)
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    // objects of a previous record that was not submitted, its command buffer is never executed
+    destroyRetired(recordedObjects);
+    for(auto& request : requests)
+        request.isRecorded = false;
+
+    if(requests.empty())
+        return;
+
+    // compute path: one descriptor set per generated level, the pool lives until the frame completed
+    uint32_t computeLevelCount = 0;
+    for(const auto& request : requests)
+    {
+        if(!isBlitSupported(request.format))
+            computeLevelCount += request.mipLevels - 1;
+    }
+
+    Retired retiredObjects{};
+    retiredObjects.frameValue = frameValue;
+    if(computeLevelCount > 0)
+    {
+        std::array<VkDescriptorPoolSize, 2> poolSizes{};
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes[0].descriptorCount = computeLevelCount;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        poolSizes[1].descriptorCount = computeLevelCount;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+        poolInfo.maxSets = computeLevelCount;
+
+        // >> without it the compute requests wait for the next frame, blits are still recorded
+        if(vkCreateDescriptorPool(vkDevice, &poolInfo, nullptr, &retiredObjects.descriptorPool) != VK_SUCCESS)
+        {
+            std::cout << "error: vulkan: failed to create mip descriptor pool!";
+            retiredObjects.descriptorPool = VK_NULL_HANDLE;
+        }
+    }
+
+    for(auto& request : requests)
+    {
+        if(isBlitSupported(request.format))
+            recordBlit(graphicsCommandBuffer, request);
+        else if(retiredObjects.descriptorPool != VK_NULL_HANDLE)
+            recordCompute(graphicsCommandBuffer, request, retiredObjects);
+        else
+            continue;
+        request.isRecorded = true;
+    }
+    recordedObjects = std::move(retiredObjects);
+}
+
+void VulkanMipGenerator::CommitRecorded()
+{
+    std::erase_if(requests, [](const Request& request) { return request.isRecorded; });
+
+    if(recordedObjects.descriptorPool != VK_NULL_HANDLE || !recordedObjects.imageViews.empty())
+        retired.push_back(std::move(recordedObjects));
+    recordedObjects = {};
+}
+
+/// @brief destroys compute path objects of completed frames
+void VulkanMipGenerator::CollectGarbage(uint64_t completedFrameValue)
+{
+    while(!retired.empty() && retired.front().frameValue <= completedFrameValue)
+    {
+        destroyRetired(retired.front());
+        retired.pop_front();
+    }
+}
+
+void VulkanMipGenerator::destroyRetired(Retired& retiredObjects)
+{
+    for(auto& imageView : retiredObjects.imageViews)
+        vkDestroyImageView(vkDevice, imageView, nullptr);
+    vkDestroyDescriptorPool(vkDevice, retiredObjects.descriptorPool, nullptr);
+    retiredObjects = {};
+}
+
+bool VulkanMipGenerator::isBlitSupported(VkFormat format) const
+{
+    VkFormatProperties formatProperties{};
+    vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice, format, &formatProperties);
+
+    VkFormatFeatureFlags requiredFeatures =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+        VK_FORMAT_FEATURE_BLIT_DST_BIT |
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (formatProperties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
+}
+
+bool VulkanMipGenerator::isComputeSupported(VkFormat format) const
+{
+    if(vkPipeline == VK_NULL_HANDLE)
+        return false;
+
+    VkFormat storageFormat = getStorageFormat(format);
+    if(storageFormat == VK_FORMAT_UNDEFINED)
+        return false;
+
+    VkFormatProperties formatProperties{};
+    vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice, format, &formatProperties);
+    if(!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+        return false;
+
+    VkFormatProperties storageFormatProperties{};
+    vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice, storageFormat, &storageFormatProperties);
+    return (storageFormatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+}
+
+/// @brief format of the storage view the compute path writes with, matches the rgba8 layout qualifier of the shader
+/// @return VK_FORMAT_UNDEFINED when the format has no compute path
+VkFormat VulkanMipGenerator::getStorageFormat(VkFormat format)
+{
+    switch(format)
+    {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        default:
+            return VK_FORMAT_UNDEFINED;
+    }
+}
+
+bool VulkanMipGenerator::isSrgb(VkFormat format)
+{
+    return format == VK_FORMAT_R8G8B8A8_SRGB;
+}
+
+/// @brief downsamples level by level with linear blits, each level is the source of the next
+void VulkanMipGenerator::recordBlit(VkCommandBuffer commandBuffer, const Request& request)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = request.image;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.levelCount = 1;
+
+    int32_t mipWidth = static_cast<int32_t>(request.width);
+    int32_t mipHeight = static_cast<int32_t>(request.height);
+    for(uint32_t level = 1; level < request.mipLevels; ++level)
+    {
+        // command: previous level TRANSFER_DST >> TRANSFER_SRC, waits for its upload or blit
+        barrier.subresourceRange.baseMipLevel = level - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        // command: blit previous level >> level at half the size
+        int32_t nextWidth = std::max(mipWidth / 2, 1);
+        int32_t nextHeight = std::max(mipHeight / 2, 1);
+
+        VkImageBlit blit{};
+        blit.srcOffsets[0] = {0, 0, 0};
+        blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = level - 1;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount = 1;
+        blit.dstOffsets[0] = {0, 0, 0};
+        blit.dstOffsets[1] = {nextWidth, nextHeight, 1};
+        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.dstSubresource.mipLevel = level;
+        blit.dstSubresource.baseArrayLayer = 0;
+        blit.dstSubresource.layerCount = 1;
+
+        vkCmdBlitImage(
+            commandBuffer,
+            request.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            request.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &blit,
+            VK_FILTER_LINEAR);
+
+        // command: previous level is done, TRANSFER_SRC >> SHADER_READ_ONLY
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = request.dstAccessMask;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, request.dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        mipWidth = nextWidth;
+        mipHeight = nextHeight;
+    }
+
+    // command: last level was only written, TRANSFER_DST >> SHADER_READ_ONLY
+    barrier.subresourceRange.baseMipLevel = request.mipLevels - 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = request.dstAccessMask;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, request.dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+/// @brief downsamples level by level in a compute shader, each level is sampled to write the next
+void VulkanMipGenerator::recordCompute(VkCommandBuffer commandBuffer, const Request& request, Retired& retiredObjects)
+{
+    VkPipelineStageFlags readStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | request.dstStageMask;
+    VkAccessFlags readAccessMask = VK_ACCESS_SHADER_READ_BIT | request.dstAccessMask;
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = request.image;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.levelCount = 1;
+
+    // command: uploaded level 0 TRANSFER_DST >> SHADER_READ_ONLY
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = readAccessMask;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, readStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, vkPipeline);
+
+    VkFormat storageFormat = getStorageFormat(request.format);
+    uint32_t mipWidth = request.width;
+    uint32_t mipHeight = request.height;
+    for(uint32_t level = 1; level < request.mipLevels; ++level)
+    {
+        uint32_t nextWidth = std::max(mipWidth / 2, 1u);
+        uint32_t nextHeight = std::max(mipHeight / 2, 1u);
+
+        // views: previous level is sampled, level is written
+        VkImageView srcView = VK_NULL_HANDLE;
+        VkImageView dstView = VK_NULL_HANDLE;
+        if(!createImageView(request.image, request.format, level - 1, 1, srcView) ||
+           !createImageView(request.image, storageFormat, level, 1, dstView))
+        {
+            if(srcView != VK_NULL_HANDLE)
+                vkDestroyImageView(vkDevice, srcView, nullptr);
+            recordMissingLevels(commandBuffer, request, level);
+            return;
+        }
+        retiredObjects.imageViews.push_back(srcView);
+        retiredObjects.imageViews.push_back(dstView);
+
+        // allocate and write descriptor set
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = retiredObjects.descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &vkDescriptorSetLayout;
+
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        if(vkAllocateDescriptorSets(vkDevice, &allocInfo, &descriptorSet) != VK_SUCCESS)
+        {
+            std::cout << "error: vulkan: failed to create mip descriptor set!";
+            recordMissingLevels(commandBuffer, request, level);
+            return;
+        }
+
+        VkDescriptorImageInfo srcInfo{};
+        srcInfo.sampler = vkSampler;
+        srcInfo.imageView = srcView;
+        srcInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkDescriptorImageInfo dstInfo{};
+        dstInfo.imageView = dstView;
+        dstInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[0].dstSet = descriptorSet;
+        descriptorWrites[0].dstBinding = 0;
+        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWrites[0].descriptorCount = 1;
+        descriptorWrites[0].pImageInfo = &srcInfo;
+        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[1].dstSet = descriptorSet;
+        descriptorWrites[1].dstBinding = 1;
+        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        descriptorWrites[1].descriptorCount = 1;
+        descriptorWrites[1].pImageInfo = &dstInfo;
+        vkUpdateDescriptorSets(vkDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+        // command: level UNDEFINED >> GENERAL, its content is overwritten
+        barrier.subresourceRange.baseMipLevel = level;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        // command: downsample
+        MipConstants constants{};
+        constants.dstWidth = static_cast<int32_t>(nextWidth);
+        constants.dstHeight = static_cast<int32_t>(nextHeight);
+        constants.isSrgb = isSrgb(request.format) ? 1 : 0;
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, vkPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+        vkCmdPushConstants(commandBuffer, vkPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(MipConstants), &constants);
+        vkCmdDispatch(
+            commandBuffer,
+            (nextWidth + COMPUTE_GROUP_SIZE - 1) / COMPUTE_GROUP_SIZE,
+            (nextHeight + COMPUTE_GROUP_SIZE - 1) / COMPUTE_GROUP_SIZE,
+            1);
+
+        // command: level GENERAL >> SHADER_READ_ONLY, source of the next level
+        barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = readAccessMask;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, readStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        mipWidth = nextWidth;
+        mipHeight = nextHeight;
+    }
+}
+
+/// @brief clears the levels from firstLevel on and moves them to SHADER_READ_ONLY with the generated levels
+/// @brief >> the image is sampled across all levels, levels that could not be generated must not stay in an undefined layout
+void VulkanMipGenerator::recordMissingLevels(VkCommandBuffer commandBuffer, const Request& request, uint32_t firstLevel)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = request.image;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = firstLevel;
+    barrier.subresourceRange.levelCount = request.mipLevels - firstLevel;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    // command: levels UNDEFINED >> TRANSFER_DST, their content is overwritten
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    // command: clear, defined content instead of the memory left by earlier resources
+    VkClearColorValue clearColor{};
+    vkCmdClearColorImage(commandBuffer, request.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &barrier.subresourceRange);
+
+    // command: levels TRANSFER_DST >> SHADER_READ_ONLY
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = request.dstAccessMask;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, request.dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+bool VulkanMipGenerator::createComputePipeline(VulkanPipelineCache& pipelineCache)
+{
+    // create descriptor set layout
+    // >> binding 0: previous level (sampled), binding 1: level to write (storage)
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo dslInfo{};
+    dslInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    dslInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    dslInfo.pBindings = bindings.data();
+
+    if(vkCreateDescriptorSetLayout(vkDevice, &dslInfo, nullptr, &vkDescriptorSetLayout) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create mip descriptor set layout!";
+        return false;
+    }
+
+    // create pipeline layout
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(MipConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &vkDescriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if(vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, nullptr, &vkPipelineLayout) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create mip pipeline layout!";
+        return false;
+    }
+
+    // read file: compute shader
+    std::vector<char> fileComp;
+    std::string pathComp = fmt::format("{}/shaders/{}", Application::AssetsPath, "mip_downsample.comp.spv");
+    if(!FileUtility::ReadBinaryFile(pathComp, fileComp))
+    {
+        std::cout << "error: vulkan: failed to read mip shader!";
+        return false;
+    }
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = fileComp.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(fileComp.data());
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    if(vkCreateShaderModule(vkDevice, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create shader module!";
+        return false;
+    }
+
+    // create pipeline
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = vkPipelineLayout;
+
+    VulkanPipelineCache::CreationFeedback feedback{};
+    pipelineInfo.pNext = pipelineCache.BeginFeedback(feedback);
+
+    VkResult result = vkCreateComputePipelines(vkDevice, pipelineCache.GetCache(), 1, &pipelineInfo, nullptr, &vkPipeline);
+    vkDestroyShaderModule(vkDevice, shaderModule, nullptr);
+    if(result != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create mip pipeline!";
+        return false;
+    }
+    pipelineCache.EndFeedback("mip_downsample", feedback);
+
+    return true;
+}
+
+bool VulkanMipGenerator::createImageView(VkImage image, VkFormat format, uint32_t baseMipLevel, uint32_t levelCount, VkImageView& imageView)
+{
+    // create info: image view
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = baseMipLevel;
+    viewInfo.subresourceRange.levelCount = levelCount;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if(vkCreateImageView(vkDevice, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create mip image view!";
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+class VulkanMemoryHandler;
+class VulkanPipelineCache;
+
+/// @brief Generates the mip chain of uploaded textures on the graphics queue.
+/// @brief Mip 0 is uploaded on the transfer queue, all levels are left in TRANSFER_DST_OPTIMAL and handed to the graphics family.
+/// @brief Queue registers the image, Record then downsamples level by level with vkCmdBlitImage into the graphics command buffer
+/// @brief right after the upload acquire barriers. Formats that cannot be blitted with linear filtering are downsampled by a
+/// @brief compute shader instead (rgba8 only). All levels end in SHADER_READ_ONLY_OPTIMAL.
+class VulkanMipGenerator
+{
+public:
+    bool Create(VkDevice vkDevice, std::shared_ptr<VulkanMemoryHandler> memoryHandler, std::shared_ptr<VulkanPipelineCache> pipelineCache);
+    void CleanUp();
+
+    static uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+    bool IsSupported(VkFormat format) const;
+    VkImageUsageFlags GetRequiredUsage(VkFormat format) const;
+    VkImageCreateFlags GetRequiredCreateFlags(VkFormat format) const;
+
+    void Queue(
+        VkImage image,
+        VkFormat format,
+        uint32_t width,
+        uint32_t height,
+        uint32_t mipLevels,
+        VkPipelineStageFlags dstStageMask,
+        VkAccessFlags dstAccessMask);
+    void Record(VkCommandBuffer graphicsCommandBuffer, uint64_t frameValue);
+
+    // removes the recorded requests, called once the graphics command buffer was submitted
+    // >> without a submit they are recorded again by the next frame
+    void CommitRecorded();
+    void CollectGarbage(uint64_t completedFrameValue);
+
+private:
+    struct Request
+    {
+        VkImage image = VK_NULL_HANDLE;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipLevels = 1;
+        VkPipelineStageFlags dstStageMask = 0;
+        VkAccessFlags dstAccessMask = 0;
+        bool isRecorded = false;    // recorded into a graphics command buffer that was not submitted yet
+    };
+
+    // per-level objects of the compute path, destroyed once the frame that used them completed
+    struct Retired
+    {
+        uint64_t frameValue = 0;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        std::vector<VkImageView> imageViews;
+    };
+
+    const uint32_t COMPUTE_GROUP_SIZE = 8;
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+    VkPhysicalDevice vkPhysicalDevice = VK_NULL_HANDLE;
+
+    // compute path
+    VkDescriptorSetLayout vkDescriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout vkPipelineLayout = VK_NULL_HANDLE;
+    VkPipeline vkPipeline = VK_NULL_HANDLE;
+    VkSampler vkSampler = VK_NULL_HANDLE;
+
+    std::vector<Request> requests;
+    std::deque<Retired> retired;
+
+    // objects of the recorded requests, retired once their command buffer was submitted
+    Retired recordedObjects;
+
+    bool isBlitSupported(VkFormat format) const;
+    bool isComputeSupported(VkFormat format) const;
+    static VkFormat getStorageFormat(VkFormat format);
+    static bool isSrgb(VkFormat format);
+
+    void recordBlit(VkCommandBuffer commandBuffer, const Request& request);
+    void recordCompute(VkCommandBuffer commandBuffer, const Request& request, Retired& retiredObjects);
+    void recordMissingLevels(VkCommandBuffer commandBuffer, const Request& request, uint32_t firstLevel);
+
+    bool createComputePipeline(VulkanPipelineCache& pipelineCache);
+    bool createImageView(VkImage image, VkFormat format, uint32_t baseMipLevel, uint32_t levelCount, VkImageView& imageView);
+    void destroyRetired(Retired& retiredObjects);
+};
\ No newline at end of file
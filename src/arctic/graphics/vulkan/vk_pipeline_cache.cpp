@@ -0,0 +1,261 @@
+#include "vk_pipeline_cache.h"
+#include "arctic/core/utilities/file_utility.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+bool VulkanPipelineCache::Create(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice)
+{
+    this->vkDevice = vkDevice;
+
+    // query device identity
+    // >> the device uuid names the file, the remaining properties are validated against the file header
+    VkPhysicalDeviceIDProperties idProperties{};
+    idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &idProperties;
+    vkGetPhysicalDeviceProperties2(vkPhysicalDevice, &properties2);
+    this->deviceProperties = properties2.properties;
+
+    // creation feedback is core in vulkan 1.3
+    this->isFeedbackSupported = deviceProperties.apiVersion >= VK_API_VERSION_1_3;
+
+    std::ostringstream fileName;
+    fileName << "pipelines_";
+    for(uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+        fileName << std::hex << std::setw(2) << std::setfill('0') << static_cast<uint32_t>(idProperties.deviceUUID[i]);
+    fileName << ".bin";
+    this->path = (std::filesystem::path(getCacheDirectory()) / fileName.str()).string();
+
+    // load file
+    // >> any mismatch starts an empty cache, the driver would otherwise have to reject the data itself
+    auto start = std::chrono::steady_clock::now();
+    std::vector<char> data;
+    bool isLoaded = loadFile(data);
+
+    // create info: pipeline cache
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = isLoaded ? data.size() : 0;
+    cacheInfo.pInitialData = isLoaded ? data.data() : nullptr;
+
+    VkResult result = vkCreatePipelineCache(vkDevice, &cacheInfo, nullptr, &vkPipelineCache);
+    if(result != VK_SUCCESS && isLoaded)
+    {
+        // the driver rejected the data, retry empty
+        std::cout << "info: vulkan: pipeline cache: driver rejected " << path << ", starting empty" << std::endl;
+        isLoaded = false;
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(vkDevice, &cacheInfo, nullptr, &vkPipelineCache);
+    }
+    if(result != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create pipeline cache!";
+        vkPipelineCache = VK_NULL_HANDLE;
+        return false;
+    }
+
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(2);
+    if(isLoaded)
+        std::cout << "info: vulkan: pipeline cache: loaded " << data.size() << " bytes from " << path << " (" << milliseconds << " ms)" << std::endl;
+    else
+        std::cout << "info: vulkan: pipeline cache: starting empty, written to " << path << " on shutdown" << std::endl;
+    return true;
+}
+
+void VulkanPipelineCache::CleanUp()
+{
+    if(vkPipelineCache == VK_NULL_HANDLE)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "info: vulkan: pipeline cache: " << hitCount << " hits, " << missCount << " misses, "
+                  << creationMilliseconds << " ms creating pipelines" << std::endl;
+    }
+
+    Save();
+
+    vkDestroyPipelineCache(vkDevice, vkPipelineCache, nullptr);
+    vkPipelineCache = VK_NULL_HANDLE;
+}
+
+/// @brief writes the cache data to disk, the previous file is replaced atomically
+bool VulkanPipelineCache::Save()
+{
+    if(vkPipelineCache == VK_NULL_HANDLE)
+        return false;
+
+    // get data size, then data
+    size_t dataSize = 0;
+    if(vkGetPipelineCacheData(vkDevice, vkPipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+        return false;
+
+    std::vector<char> file(sizeof(FileHeader) + dataSize);
+    if(vkGetPipelineCacheData(vkDevice, vkPipelineCache, &dataSize, file.data() + sizeof(FileHeader)) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to get pipeline cache data!";
+        return false;
+    }
+    file.resize(sizeof(FileHeader) + dataSize);
+
+    FileHeader header = createHeader(file.data() + sizeof(FileHeader), dataSize);
+    memcpy(file.data(), &header, sizeof(FileHeader));
+
+    if(!FileUtility::WriteBinaryFileAtomic(path, file.data(), file.size()))
+    {
+        std::cout << "error: vulkan: failed to write pipeline cache to " << path << "!";
+        return false;
+    }
+    return true;
+}
+
+const VkPipelineCache& VulkanPipelineCache::GetCache() const
+{
+    return this->vkPipelineCache;
+}
+
+const std::string& VulkanPipelineCache::GetPath() const
+{
+    return this->path;
+}
+
+/// @brief starts timing a pipeline creation
+/// @param pNext chain of the pipeline create info
+/// @return chain to set as pNext of the pipeline create info, the feedback struct is prepended when supported
+const void* VulkanPipelineCache::BeginFeedback(CreationFeedback& feedback, const void* pNext) const
+{
+    feedback.start = std::chrono::steady_clock::now();
+    if(!isFeedbackSupported)
+        return pNext;
+
+    feedback.pipelineFeedback = {};
+    feedback.createInfo = {};
+    feedback.createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
+    feedback.createInfo.pNext = pNext;
+    feedback.createInfo.pPipelineCreationFeedback = &feedback.pipelineFeedback;
+    feedback.createInfo.pipelineStageCreationFeedbackCount = 0;
+    return &feedback.createInfo;
+}
+
+/// @brief reports whether the pipeline was found in the cache and how long its creation took
+void VulkanPipelineCache::EndFeedback(const char* pipelineName, const CreationFeedback& feedback)
+{
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - feedback.start).count();
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    creationMilliseconds += milliseconds;
+
+    // >> without valid feedback the result is unknown and not counted
+    const char* result = "unknown";
+    if(feedback.pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT)
+    {
+        bool isHit = feedback.pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT;
+        result = isHit ? "hit" : "miss";
+        if(isHit)
+            ++hitCount;
+        else
+            ++missCount;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "info: vulkan: pipeline cache: " << pipelineName << " " << result << " (" << milliseconds << " ms)" << std::endl;
+}
+
+bool VulkanPipelineCache::loadFile(std::vector<char>& data) const
+{
+    std::vector<char> file;
+    if(!FileUtility::ReadBinaryFile(path, file))
+        return false;
+
+    auto reject = [this](const char* reason)
+    {
+        std::cout << "info: vulkan: pipeline cache: ignoring " << path << " (" << reason << ")" << std::endl;
+        return false;
+    };
+
+    // validate file header
+    if(file.size() < sizeof(FileHeader))
+        return reject("truncated header");
+
+    FileHeader header{};
+    memcpy(&header, file.data(), sizeof(FileHeader));
+
+    FileHeader expected = createHeader(nullptr, 0);
+    if(header.magic != expected.magic || header.version != expected.version)
+        return reject("unknown format");
+    if(header.vendorID != expected.vendorID || header.deviceID != expected.deviceID || header.driverABI != expected.driverABI)
+        return reject("different device");
+    if(header.driverVersion != expected.driverVersion || memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        return reject("different driver");
+    if(header.dataSize != file.size() - sizeof(FileHeader))
+        return reject("truncated data");
+    if(header.dataHash != hashData(file.data() + sizeof(FileHeader), header.dataSize))
+        return reject("corrupted data");
+
+    // validate vulkan header
+    // >> drivers are expected to reject foreign data, but not all of them check every field
+    VkPipelineCacheHeaderVersionOne cacheHeader{};
+    if(header.dataSize < sizeof(cacheHeader))
+        return reject("truncated data");
+
+    memcpy(&cacheHeader, file.data() + sizeof(FileHeader), sizeof(cacheHeader));
+    if(cacheHeader.headerSize < sizeof(cacheHeader) || cacheHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+        return reject("unknown cache header");
+    if(cacheHeader.vendorID != deviceProperties.vendorID || cacheHeader.deviceID != deviceProperties.deviceID ||
+       memcmp(cacheHeader.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        return reject("cache header mismatch");
+
+    data.assign(file.begin() + sizeof(FileHeader), file.end());
+    return true;
+}
+
+VulkanPipelineCache::FileHeader VulkanPipelineCache::createHeader(const void* pData, size_t size) const
+{
+    FileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.vendorID = deviceProperties.vendorID;
+    header.deviceID = deviceProperties.deviceID;
+    header.driverVersion = deviceProperties.driverVersion;
+    header.driverABI = sizeof(void*);
+    memcpy(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+    header.dataSize = size;
+    header.dataHash = pData ? hashData(pData, size) : 0;
+    return header;
+}
+
+/// @brief per user cache directory: $XDG_CACHE_HOME/arctic, ~/.cache/arctic or %LOCALAPPDATA%/arctic
+/// @return a relative directory when none of the variables is set
+std::string VulkanPipelineCache::getCacheDirectory()
+{
+    if(const char* pCacheHome = std::getenv("XDG_CACHE_HOME"); pCacheHome && *pCacheHome)
+        return (std::filesystem::path(pCacheHome) / "arctic").string();
+    if(const char* pLocalAppData = std::getenv("LOCALAPPDATA"); pLocalAppData && *pLocalAppData)
+        return (std::filesystem::path(pLocalAppData) / "arctic").string();
+    if(const char* pHome = std::getenv("HOME"); pHome && *pHome)
+        return (std::filesystem::path(pHome) / ".cache" / "arctic").string();
+    return "cache";
+}
+
+/// @brief 64 bit fnv-1a
+uint64_t VulkanPipelineCache::hashData(const void* pData, size_t size)
+{
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for(size_t i = 0; i < size; ++i)
+    {
+        hash ^= pBytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/// @brief VkPipelineCache backed by a file, pipelines compiled by an earlier run are loaded instead of compiled again.
+/// @brief The file is named after the device UUID and its header is validated against the vendor, device, driver
+/// @brief version, pipeline cache UUID and a hash of the data, a stale or damaged file is ignored and the cache starts empty.
+/// @brief The data is written back on CleanUp through a temporary file, a crash while saving never leaves a torn file.
+class VulkanPipelineCache
+{
+public:
+    // creation feedback of one pipeline
+    // >> chain Begin into the pNext of the pipeline create info, call End once the pipeline is created
+    struct CreationFeedback
+    {
+        VkPipelineCreationFeedback pipelineFeedback{};
+        VkPipelineCreationFeedbackCreateInfo createInfo{};
+        std::chrono::steady_clock::time_point start;
+    };
+
+    bool Create(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice);
+    void CleanUp();
+
+    bool Save();
+
+    const VkPipelineCache& GetCache() const;
+    const std::string& GetPath() const;
+
+    const void* BeginFeedback(CreationFeedback& feedback, const void* pNext = nullptr) const;
+    void EndFeedback(const char* pipelineName, const CreationFeedback& feedback);
+
+private:
+    // file layout: header, then the data returned by vkGetPipelineCacheData
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint32_t driverABI; // pointer size, 32 and 64 bit builds of the driver do not share caches
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+        uint64_t dataHash;
+    };
+
+    const uint32_t FILE_MAGIC = 0x43505241; // "ARPC"
+    const uint32_t FILE_VERSION = 1;
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+    VkPipelineCache vkPipelineCache = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties deviceProperties{};
+
+    std::string path;
+    bool isFeedbackSupported = false;
+
+    // statistics of this run
+    // >> pipelines are created on worker threads as well
+    std::mutex statsMutex;
+    uint32_t hitCount = 0;
+    uint32_t missCount = 0;
+    double creationMilliseconds = 0.0;
+
+    bool loadFile(std::vector<char>& data) const;
+    FileHeader createHeader(const void* pData, size_t size) const;
+
+    static std::string getCacheDirectory();
+    static uint64_t hashData(const void* pData, size_t size);
+};
\ No newline at end of file
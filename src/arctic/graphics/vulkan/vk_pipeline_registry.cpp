@@ -0,0 +1,184 @@
+#include "vk_pipeline_registry.h"
+#include "arctic/core/utilities/thread_pool.h"
+#include "arctic/core/utilities/profiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+/// @return true when creation was successful
+bool VulkanPipelineRegistry::Create(VkDevice vkDevice, std::shared_ptr<VulkanRenderPipeline> renderPipeline)
+{
+    this->vkDevice = vkDevice;
+    this->pRenderPipeline = renderPipeline;
+    this->pCompileThreadPool = std::make_unique<ThreadPool>(COMPILE_THREAD_COUNT);
+
+    // the default pipeline is compiled by the render pipeline and always registered
+    // >> owned by the render pipeline until a reload replaces it
+    auto pDefault = std::make_unique<Entry>();
+    pDefault->compiled = renderPipeline->GetDefaultPipeline();
+    pDefault->isOwned = false;
+    entries.push_back(std::move(pDefault));
+    handles.emplace(PipelineDesc{}, 0);
+    return true;
+}
+
+void VulkanPipelineRegistry::CleanUp()
+{
+    // wait for running compiles, then destroy
+    pCompileThreadPool.reset();
+
+    // >> layouts belong to the layout cache of the render pipeline
+    for(auto& entry : entries)
+    {
+        if(entry->isOwned)
+            pRenderPipeline->DestroyPipeline(entry->compiled);
+        pRenderPipeline->DestroyPipeline(entry->pending);
+    }
+    for(auto& retired : retiredPipelines)
+        pRenderPipeline->DestroyPipeline(retired.compiled);
+
+    retiredPipelines.clear();
+    entries.clear();
+    handles.clear();
+}
+
+/// @brief returns the handle of the pipeline, the first request of a description starts compiling it
+PipelineHandle VulkanPipelineRegistry::Request(const PipelineDesc& desc)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = handles.find(desc);
+    if(it != handles.end())
+        return it->second;
+
+    auto pEntry = std::make_unique<Entry>();
+    pEntry->desc = desc;
+    Entry& entry = *pEntry;
+
+    entries.push_back(std::move(pEntry));
+    PipelineHandle handle = static_cast<PipelineHandle>(entries.size() - 1);
+    handles.emplace(desc, handle);
+
+    submitCompile(entry);
+    return handle;
+}
+
+/// @return true when the pipeline of the handle is used by the next snapshot
+bool VulkanPipelineRegistry::IsReady(PipelineHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(handle >= entries.size())
+        return false;
+
+    const Entry& entry = *entries[handle];
+    return entry.compiled.pipeline != VK_NULL_HANDLE || entry.pending.pipeline != VK_NULL_HANDLE;
+}
+
+void VulkanPipelineRegistry::Reload(const std::string& shaderName)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!pCompileThreadPool)
+        return;
+
+    uint32_t count = 0;
+    for(auto& entry : entries)
+    {
+        if(entry->desc.vertexShader == shaderName || entry->desc.fragmentShader == shaderName)
+        {
+            submitCompile(*entry);
+            ++count;
+        }
+    }
+
+    if(count > 0)
+        std::cout << "info: vulkan: " << shaderName << " changed, rebuilding " << count << " pipelines" << std::endl;
+}
+
+void VulkanPipelineRegistry::Snapshot(std::vector<CompiledPipeline>& pipelines, uint64_t submittedFrameValue, uint64_t completedFrameValue)
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // swap in compiled pipelines
+    // >> frames up to submittedFrameValue were recorded with the replaced pipeline
+    for(auto& entry : entries)
+    {
+        if(entry->pending.pipeline == VK_NULL_HANDLE)
+            continue;
+
+        if(entry->isOwned && entry->compiled.pipeline != VK_NULL_HANDLE)
+            retiredPipelines.push_back({ entry->compiled, submittedFrameValue });
+
+        entry->compiled = entry->pending;
+        entry->pending = {};
+        entry->isOwned = true;
+    }
+
+    // destroy replaced pipelines of completed frames
+    auto itRetired = std::remove_if(retiredPipelines.begin(), retiredPipelines.end(), [this, completedFrameValue](const RetiredPipeline& retired)
+    {
+        if(retired.frameValue > completedFrameValue)
+            return false;
+        pRenderPipeline->DestroyPipeline(retired.compiled);
+        return true;
+    });
+    retiredPipelines.erase(itRetired, retiredPipelines.end());
+
+    // resolve handles
+    const CompiledPipeline& defaultPipeline = entries[0]->compiled;
+    pipelines.resize(entries.size());
+    for(size_t i = 0; i < entries.size(); ++i)
+    {
+        const Entry& entry = *entries[i];
+        pipelines[i] = entry.compiled.pipeline != VK_NULL_HANDLE ? entry.compiled : defaultPipeline;
+    }
+}
+
+/// @brief queues a compile of the entry, requires the lock
+void VulkanPipelineRegistry::submitCompile(Entry& entry)
+{
+    // entries are never removed before CleanUp, the reference stays valid while compiling
+    uint32_t generation = ++entry.requestedGeneration;
+    pCompileThreadPool->Submit([this, &entry, generation]() { compile(entry, generation); });
+}
+
+/// @brief runs on a compile thread
+void VulkanPipelineRegistry::compile(Entry& entry, uint32_t generation)
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    CompiledPipeline compiled{};
+    if(!pRenderPipeline->CreatePipeline(entry.desc, compiled))
+    {
+        // draws keep using the previous or the default pipeline
+        std::cout << "error: vulkan: failed to compile pipeline " << entry.desc.vertexShader << " + " << entry.desc.fragmentShader << "!";
+        return;
+    }
+
+    // publish for the next snapshot
+    // >> an older compile finishing last is dropped, a pending pipeline was never recorded and is destroyed at once
+    std::lock_guard<std::mutex> lock(mutex);
+    if(generation < entry.pendingGeneration)
+    {
+        pRenderPipeline->DestroyPipeline(compiled);
+        return;
+    }
+
+    pRenderPipeline->DestroyPipeline(entry.pending);
+    entry.pending = compiled;
+    entry.pendingGeneration = generation;
+}
+
+size_t VulkanPipelineRegistry::PipelineDescHash::operator()(const PipelineDesc& desc) const
+{
+    size_t hash = 0;
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+    combine(std::hash<std::string>()(desc.vertexShader));
+    combine(std::hash<std::string>()(desc.fragmentShader));
+    combine(static_cast<size_t>(desc.topology));
+    combine(static_cast<size_t>(desc.cullMode));
+    combine(static_cast<size_t>(desc.isFrontFaceClockwise));
+    combine(static_cast<size_t>(desc.blendMode));
+    return hash;
+}
\ No newline at end of file
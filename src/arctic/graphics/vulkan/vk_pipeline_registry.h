@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include "arctic/graphics/rhi/pipeline_desc.h"
+#include "vk_renderpipeline.h"
+
+class ThreadPool;
+
+/// @brief Owns the pipelines requested by materials, keyed by a hash of their PipelineDesc.
+/// @brief Request returns a handle at once and compiles the pipeline on a worker thread. Draws resolve their handle
+/// @brief through the frame snapshot and use the default pipeline until their own pipeline is ready (or failed),
+/// @brief so a new material never stalls the frame that introduces it.
+/// @brief Reload rebuilds the pipelines using a changed shader the same way, the rebuilt pipelines are swapped in by the
+/// @brief next snapshot and the replaced ones destroyed once the frames recorded with them completed.
+class VulkanPipelineRegistry
+{
+public:
+    bool Create(VkDevice vkDevice, std::shared_ptr<VulkanRenderPipeline> renderPipeline);
+    void CleanUp();
+
+    PipelineHandle Request(const PipelineDesc& desc);
+    bool IsReady(PipelineHandle handle) const;
+
+    // rebuilds the pipelines using the shader binary, callable from any thread
+    void Reload(const std::string& shaderName);
+
+    // resolves every handle once per frame, the frame boundary: rebuilt pipelines are swapped in here
+    // >> pipelines[handle] is the compiled pipeline or the default pipeline, recording threads only read the snapshot
+    // >> replaced pipelines were last used by submittedFrameValue, they are destroyed once completedFrameValue reaches it
+    void Snapshot(std::vector<CompiledPipeline>& pipelines, uint64_t submittedFrameValue, uint64_t completedFrameValue);
+
+private:
+    struct Entry
+    {
+        PipelineDesc desc;
+        CompiledPipeline compiled; // used by recorded frames
+        CompiledPipeline pending;  // compiled, swapped in by the next snapshot
+        bool isOwned = true;       // false: default pipeline of the render pipeline
+
+        // compiles of one entry may overlap (edit while compiling), only a newer one replaces the pending pipeline
+        uint32_t requestedGeneration = 0;
+        uint32_t pendingGeneration = 0;
+    };
+
+    struct RetiredPipeline
+    {
+        CompiledPipeline compiled;
+        uint64_t frameValue = 0;
+    };
+
+    struct PipelineDescHash
+    {
+        size_t operator()(const PipelineDesc& desc) const;
+    };
+
+    // compiles run next to the recording workers, two threads keep them from competing for every core
+    const uint32_t COMPILE_THREAD_COUNT = 2;
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+    std::shared_ptr<VulkanRenderPipeline> pRenderPipeline;
+    std::unique_ptr<ThreadPool> pCompileThreadPool;
+
+    // entries[handle], handle 0 is the default pipeline of the render pipeline
+    mutable std::mutex mutex;
+    std::unordered_map<PipelineDesc, PipelineHandle, PipelineDescHash> handles;
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::vector<RetiredPipeline> retiredPipelines;
+
+    void submitCompile(Entry& entry);
+    void compile(Entry& entry, uint32_t generation);
+};
\ No newline at end of file
@@ -0,0 +1,745 @@
+#include "vk_render_graph.h"
+#include "vk_memory_handler.h"
+#include "vk_gpu_profiler.h"
+#include "arctic/core/utilities/profiler.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+// access bits that make a use a write, the rest of a use's access mask only needs to be made visible
+static const VkAccessFlags WRITE_ACCESS_MASK =
+    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_SHADER_WRITE_BIT |
+    VK_ACCESS_TRANSFER_WRITE_BIT;
+
+// layout, stages, access and image usage of an access kind
+struct AccessInfo
+{
+    VkImageLayout layout;
+    VkPipelineStageFlags stageMask;
+    VkAccessFlags readAccessMask;
+    VkAccessFlags writeAccessMask;
+    VkImageUsageFlags usage;
+};
+
+static AccessInfo getAccessInfo(RenderGraphAccess access)
+{
+    const VkPipelineStageFlags fragmentTestStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    const VkPipelineStageFlags shaderStages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    switch(access)
+    {
+    case RenderGraphAccess::ColorAttachmentWrite:
+        return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                 VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
+    case RenderGraphAccess::DepthAttachmentWrite:
+        // >> the depth test reads the attachment even when it is cleared
+        return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, fragmentTestStages,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                 VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+    case RenderGraphAccess::DepthAttachmentRead:
+        return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, fragmentTestStages,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, 0, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+    case RenderGraphAccess::ShaderSampledRead:
+        return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, shaderStages, VK_ACCESS_SHADER_READ_BIT, 0, VK_IMAGE_USAGE_SAMPLED_BIT };
+    case RenderGraphAccess::StorageWrite:
+        return { VK_IMAGE_LAYOUT_GENERAL, shaderStages, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_USAGE_STORAGE_BIT };
+    case RenderGraphAccess::TransferSrc:
+        return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0, VK_IMAGE_USAGE_TRANSFER_SRC_BIT };
+    case RenderGraphAccess::TransferDst:
+    default:
+        return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+    }
+}
+
+bool VulkanRenderGraph::TransientKey::operator==(const TransientKey& other) const
+{
+    return format == other.format &&
+        extent.width == other.extent.width &&
+        extent.height == other.extent.height &&
+        usage == other.usage &&
+        firstPass == other.firstPass &&
+        lastPass == other.lastPass;
+}
+
+bool VulkanRenderGraph::Create(VkDevice vkDevice, std::shared_ptr<VulkanMemoryHandler> memoryHandler)
+{
+    this->vkDevice = vkDevice;
+    this->memoryHandler = memoryHandler;
+    return true;
+}
+
+void VulkanRenderGraph::CleanUp()
+{
+    retireTransients();
+    CollectGarbage(UINT64_MAX);
+    Reset();
+}
+
+/// @brief destroys transient images and memory of previous layouts of completed frames
+void VulkanRenderGraph::CollectGarbage(uint64_t completedFrameValue)
+{
+    while(!retired.empty() && retired.front().frameValue <= completedFrameValue)
+    {
+        auto& retiredObjects = retired.front();
+        for(auto& transientImage : retiredObjects.images)
+        {
+            vkDestroyImageView(vkDevice, transientImage.imageView, nullptr);
+            vkDestroyImage(vkDevice, transientImage.image, nullptr);
+        }
+        for(auto& allocation : retiredObjects.allocations)
+            memoryHandler->FreeMemory(allocation);
+        retired.pop_front();
+    }
+}
+
+void VulkanRenderGraph::Reset()
+{
+    passes.clear();
+    resources.clear();
+    alivePasses.clear();
+}
+
+/// @brief adds an image owned by the caller
+/// @param initialState layout and last access before the graph, the first use waits on it
+/// @param finalState layout and access the image is handed back with after the last pass
+RenderGraphResource VulkanRenderGraph::ImportImage(
+    const char* name,
+    VkImage image,
+    VkImageView imageView,
+    VkFormat format,
+    VkExtent2D extent,
+    const RenderGraphImageState& initialState,
+    const RenderGraphImageState& finalState)
+{
+    Resource resource{};
+    resource.name = name;
+    resource.format = format;
+    resource.extent = extent;
+    resource.aspectMask = getAspectMask(format);
+    resource.isImported = true;
+    resource.image = image;
+    resource.imageView = imageView;
+    resource.initialState = initialState;
+    resource.finalState = finalState;
+
+    resources.push_back(resource);
+    return static_cast<RenderGraphResource>(resources.size() - 1);
+}
+
+/// @brief adds an image created by the graph, its content is undefined before the first pass writing it
+RenderGraphResource VulkanRenderGraph::CreateImage(const char* name, const RenderGraphImageDesc& desc)
+{
+    Resource resource{};
+    resource.name = name;
+    resource.format = desc.format;
+    resource.extent = desc.extent;
+    resource.aspectMask = getAspectMask(desc.format);
+
+    resources.push_back(resource);
+    return static_cast<RenderGraphResource>(resources.size() - 1);
+}
+
+RenderGraphPass VulkanRenderGraph::AddPass(const char* name, std::function<void(VkCommandBuffer)> execute)
+{
+    Pass pass{};
+    pass.name = name;
+    pass.execute = std::move(execute);
+
+    passes.push_back(std::move(pass));
+    return static_cast<RenderGraphPass>(passes.size() - 1);
+}
+
+/// @brief renders into the image, LOAD reads the previous content
+void VulkanRenderGraph::AddColorAttachment(RenderGraphPass pass, RenderGraphResource resource, VkAttachmentLoadOp loadOp, VkClearValue clearValue)
+{
+    addUse(pass, resource, RenderGraphAccess::ColorAttachmentWrite, loadOp == VK_ATTACHMENT_LOAD_OP_LOAD, true);
+    passes[pass].colorAttachments.push_back({ resource, loadOp, clearValue });
+}
+
+/// @brief depth tests against the image, read only depth keeps the content of an earlier pass (depth prepass)
+void VulkanRenderGraph::SetDepthAttachment(RenderGraphPass pass, RenderGraphResource resource, VkAttachmentLoadOp loadOp, VkClearValue clearValue, bool isReadOnly)
+{
+    RenderGraphAccess access = isReadOnly ? RenderGraphAccess::DepthAttachmentRead : RenderGraphAccess::DepthAttachmentWrite;
+    addUse(pass, resource, access, isReadOnly || loadOp == VK_ATTACHMENT_LOAD_OP_LOAD, !isReadOnly);
+
+    Pass& renderPass = passes[pass];
+    renderPass.hasDepthAttachment = true;
+    renderPass.depthAttachment = { resource, loadOp, clearValue };
+    renderPass.depthLayout = getAccessInfo(access).layout;
+}
+
+void VulkanRenderGraph::AddRead(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access)
+{
+    addUse(pass, resource, access, true, false);
+}
+
+void VulkanRenderGraph::AddWrite(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access)
+{
+    addUse(pass, resource, access, false, true);
+}
+
+void VulkanRenderGraph::SetRenderingFlags(RenderGraphPass pass, VkRenderingFlags flags)
+{
+    passes[pass].renderingFlags = flags;
+}
+
+void VulkanRenderGraph::SetSideEffect(RenderGraphPass pass)
+{
+    passes[pass].hasSideEffect = true;
+}
+
+/// @brief culls unused passes, creates the transient images and records the passes with their barriers
+/// @return true when all transient images could be created
+bool VulkanRenderGraph::Execute(VkCommandBuffer commandBuffer, uint64_t frameValue, VulkanGpuProfiler* pGpuProfiler)
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    // compile
+    cullPasses();
+    computeLifetimes();
+    resetImportedStates();
+
+    // no passes without their images
+    // >> imported images are still moved to their final layout, the acquired swapchain image can be submitted and presented
+    if(!realizeTransients())
+    {
+        std::cout << "error: vulkan: failed to create render graph images!";
+        recordFinalBarriers(commandBuffer);
+        return false;
+    }
+
+    // record passes in declaration order
+    for(uint32_t alivePass = 0; alivePass < alivePasses.size(); ++alivePass)
+    {
+        const Pass& pass = passes[alivePasses[alivePass]];
+        recordBarriers(commandBuffer, pass, alivePass);
+        recordPass(commandBuffer, pass, alivePass, pGpuProfiler);
+    }
+
+    // hand imported images back
+    recordFinalBarriers(commandBuffer);
+
+    lastFrameValue = frameValue;
+    return true;
+}
+
+/// @brief imported images start in the state given by the caller
+/// @brief >> transient images start at their first pass, in the state the previous image of their memory slot left
+void VulkanRenderGraph::resetImportedStates()
+{
+    for(auto& resource : resources)
+    {
+        if(!resource.isImported)
+            continue;
+
+        resource.layout = resource.initialState.layout;
+        resource.writeStageMask = resource.initialState.stageMask;
+        resource.writeAccessMask = resource.initialState.accessMask;
+        resource.readStageMask = 0;
+        resource.syncedStageMask = 0;
+    }
+}
+
+VkImageView VulkanRenderGraph::GetImageView(RenderGraphResource resource) const
+{
+    return resources[resource].imageView;
+}
+
+/// @brief adds a use of the image to the pass, uses of one image in one pass are merged
+void VulkanRenderGraph::addUse(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access, bool isRead, bool isWrite)
+{
+    AccessInfo info = getAccessInfo(access);
+
+    Use use{};
+    use.resource = resource;
+    use.layout = info.layout;
+    use.stageMask = info.stageMask;
+    use.accessMask = (isRead ? info.readAccessMask : 0) | (isWrite ? info.writeAccessMask : 0);
+    use.usage = info.usage;
+    use.isRead = isRead;
+    use.isWrite = isWrite;
+
+    auto& uses = passes[pass].uses;
+    auto existing = std::find_if(uses.begin(), uses.end(), [resource](const Use& other) { return other.resource == resource; });
+    if(existing == uses.end())
+    {
+        uses.push_back(use);
+        return;
+    }
+
+    // >> one image has one layout during a pass
+    if(existing->layout != use.layout)
+    {
+        std::cout << "error: vulkan: render graph pass " << passes[pass].name << " uses " << resources[resource].name << " in two layouts!";
+        return;
+    }
+    existing->stageMask |= use.stageMask;
+    existing->accessMask |= use.accessMask;
+    existing->usage |= use.usage;
+    existing->isRead |= use.isRead;
+    existing->isWrite |= use.isWrite;
+}
+
+/// @brief keeps passes contributing to an imported image or with side effects
+/// @brief >> walks the passes backwards: a pass is needed when it writes an image a later needed pass reads
+void VulkanRenderGraph::cullPasses()
+{
+    std::vector<bool> isNeeded(resources.size());
+    for(size_t i = 0; i < resources.size(); ++i)
+        isNeeded[i] = resources[i].isImported;
+
+    for(auto pass = passes.rbegin(); pass != passes.rend(); ++pass)
+    {
+        pass->isAlive = pass->hasSideEffect || std::any_of(pass->uses.begin(), pass->uses.end(), [&isNeeded](const Use& use)
+        {
+            return use.isWrite && isNeeded[use.resource];
+        });
+        if(!pass->isAlive)
+            continue;
+
+        // >> the content before a write is only needed when the pass reads it too (load)
+        for(const auto& use : pass->uses)
+        {
+            if(use.isWrite && !use.isRead)
+                isNeeded[use.resource] = false;
+        }
+        for(const auto& use : pass->uses)
+        {
+            if(use.isRead)
+                isNeeded[use.resource] = true;
+        }
+    }
+
+    alivePasses.clear();
+    for(uint32_t i = 0; i < passes.size(); ++i)
+    {
+        if(passes[i].isAlive)
+            alivePasses.push_back(i);
+    }
+}
+
+/// @brief first and last alive pass and the usage of every image
+void VulkanRenderGraph::computeLifetimes()
+{
+    for(uint32_t alivePass = 0; alivePass < alivePasses.size(); ++alivePass)
+    {
+        for(const auto& use : passes[alivePasses[alivePass]].uses)
+        {
+            Resource& resource = resources[use.resource];
+            resource.firstPass = std::min(resource.firstPass, alivePass);
+            resource.lastPass = std::max(resource.lastPass, alivePass);
+            resource.usage |= use.usage;
+        }
+    }
+}
+
+/// @brief creates the transient images and their memory, reused while the layout of the graph stays the same
+/// @brief >> images are assigned largest first to the first memory slot none of whose images lives at the same time
+bool VulkanRenderGraph::realizeTransients()
+{
+    // transient images used by alive passes, in declaration order
+    std::vector<RenderGraphResource> transients;
+    std::vector<TransientKey> keys;
+    for(uint32_t i = 0; i < resources.size(); ++i)
+    {
+        const Resource& resource = resources[i];
+        if(resource.isImported || resource.firstPass == UINT32_MAX)
+            continue;
+
+        transients.push_back(i);
+        keys.push_back({ resource.format, resource.extent, resource.usage, resource.firstPass, resource.lastPass });
+    }
+
+    // layout changed: create the images again
+    if(keys != transientKeys)
+    {
+        ARCTIC_PROFILE_ZONE("render graph realize");
+        retireTransients();
+        transientKeys = keys;
+
+        // create images
+        std::vector<VkMemoryRequirements> memoryRequirements(transients.size());
+        transientImages.resize(transients.size());
+        for(size_t i = 0; i < transients.size(); ++i)
+        {
+            if(!createTransientImage(resources[transients[i]], transientImages[i].image))
+            {
+                transientImages.resize(i);
+                retireTransients();
+                return false;
+            }
+            vkGetImageMemoryRequirements(vkDevice, transientImages[i].image, &memoryRequirements[i]);
+        }
+
+        // assign memory slots, largest images first
+        std::vector<size_t> order(transients.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&memoryRequirements](size_t a, size_t b)
+        {
+            return memoryRequirements[a].size > memoryRequirements[b].size;
+        });
+
+        VkDeviceSize requiredBytes = 0;
+        for(size_t i : order)
+        {
+            const VkMemoryRequirements& requirements = memoryRequirements[i];
+            const TransientKey& key = transientKeys[i];
+            requiredBytes += requirements.size;
+
+            auto slot = std::find_if(memorySlots.begin(), memorySlots.end(), [&](const MemorySlot& memorySlot)
+            {
+                if((memorySlot.memoryRequirements.memoryTypeBits & requirements.memoryTypeBits) == 0)
+                    return false;
+                return std::none_of(memorySlot.lifetimes.begin(), memorySlot.lifetimes.end(), [&key](const std::pair<uint32_t, uint32_t>& lifetime)
+                {
+                    return key.firstPass <= lifetime.second && lifetime.first <= key.lastPass;
+                });
+            });
+
+            if(slot == memorySlots.end())
+            {
+                memorySlots.emplace_back();
+                slot = memorySlots.end() - 1;
+                slot->memoryRequirements = requirements;
+            }
+            else
+            {
+                slot->memoryRequirements.size = std::max(slot->memoryRequirements.size, requirements.size);
+                slot->memoryRequirements.alignment = std::max(slot->memoryRequirements.alignment, requirements.alignment);
+                slot->memoryRequirements.memoryTypeBits &= requirements.memoryTypeBits;
+            }
+            slot->lifetimes.push_back({ key.firstPass, key.lastPass });
+            transientImages[i].slot = static_cast<uint32_t>(slot - memorySlots.begin());
+        }
+
+        // allocate slots
+        // >> fresh memory has no previous image to wait on
+        VkDeviceSize allocatedBytes = 0;
+        for(auto& slot : memorySlots)
+        {
+            if(!memoryHandler->AllocateMemoryVMA(slot.memoryRequirements, MemoryClass::Default, &slot.allocation))
+            {
+                retireTransients();
+                return false;
+            }
+            allocatedBytes += slot.memoryRequirements.size;
+        }
+
+        // bind images to their slot and create views
+        for(size_t i = 0; i < transients.size(); ++i)
+        {
+            TransientImage& transientImage = transientImages[i];
+            const Resource& resource = resources[transients[i]];
+            if(!memoryHandler->BindImageMemoryVMA(memorySlots[transientImage.slot].allocation, transientImage.image) ||
+               !createImageView(transientImage.image, resource.format, resource.aspectMask, transientImage.imageView))
+            {
+                retireTransients();
+                return false;
+            }
+        }
+
+        std::cout << "info: vulkan: render graph: " << transients.size() << " transient images in " << memorySlots.size()
+                  << " memory slots, " << allocatedBytes << " bytes (" << requiredBytes << " without aliasing)" << std::endl;
+    }
+
+    // hand the images to the resources of this frame
+    for(size_t i = 0; i < transients.size(); ++i)
+    {
+        Resource& resource = resources[transients[i]];
+        resource.image = transientImages[i].image;
+        resource.imageView = transientImages[i].imageView;
+        resource.slot = transientImages[i].slot;
+    }
+    return true;
+}
+
+bool VulkanRenderGraph::createTransientImage(const Resource& resource, VkImage& image)
+{
+    // create info: image
+    // >> no memory yet, bound to its memory slot once all images are created
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = resource.format;
+    imageInfo.extent = { resource.extent.width, resource.extent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = resource.usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if(vkCreateImage(vkDevice, &imageInfo, nullptr, &image) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create render graph image " << resource.name << "!";
+        return false;
+    }
+
+    return true;
+}
+
+bool VulkanRenderGraph::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectMask, VkImageView& imageView)
+{
+    // create info: image view
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = aspectMask;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if(vkCreateImageView(vkDevice, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create render graph image view!";
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief moves the transient images and memory of the current layout to the garbage of the last frame using them
+void VulkanRenderGraph::retireTransients()
+{
+    if(!transientImages.empty() || !memorySlots.empty())
+    {
+        Retired retiredObjects{};
+        retiredObjects.frameValue = lastFrameValue;
+        retiredObjects.images = std::move(transientImages);
+        for(auto& slot : memorySlots)
+        {
+            if(slot.allocation != VK_NULL_HANDLE)
+                retiredObjects.allocations.push_back(slot.allocation);
+        }
+        retired.push_back(std::move(retiredObjects));
+    }
+
+    transientImages.clear();
+    memorySlots.clear();
+    transientKeys.clear();
+}
+
+/// @brief one barrier for all images of the pass
+/// @brief >> a write waits on every earlier use, a read on the last write, a layout change is treated as a write
+void VulkanRenderGraph::recordBarriers(VkCommandBuffer commandBuffer, const Pass& pass, uint32_t alivePass)
+{
+    std::vector<VkImageMemoryBarrier> barriers;
+    VkPipelineStageFlags srcStageMask = 0;
+    VkPipelineStageFlags dstStageMask = 0;
+
+    for(const auto& use : pass.uses)
+    {
+        Resource& resource = resources[use.resource];
+
+        // transient: the content is discarded, the previous image of the memory slot must be done with it
+        if(!resource.isImported && resource.firstPass == alivePass)
+        {
+            const MemorySlot& slot = memorySlots[resource.slot];
+            resource.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            resource.writeStageMask = slot.stageMask;
+            resource.writeAccessMask = slot.accessMask;
+            resource.readStageMask = 0;
+            resource.syncedStageMask = 0;
+        }
+
+        bool isLayoutChange = resource.layout != use.layout;
+        bool isBarrierNeeded = false;
+        VkPipelineStageFlags waitStageMask = 0;
+        if(use.isWrite || isLayoutChange)
+        {
+            // >> write after read only needs the reads to finish, write after write the write to be available
+            waitStageMask = resource.writeStageMask | resource.readStageMask;
+            isBarrierNeeded = isLayoutChange || waitStageMask != 0;
+        }
+        else if(resource.writeStageMask != 0 && (use.stageMask & ~resource.syncedStageMask) != 0)
+        {
+            waitStageMask = resource.writeStageMask;
+            isBarrierNeeded = true;
+        }
+
+        if(isBarrierNeeded)
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = resource.layout;
+            barrier.newLayout = use.layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = resource.image;
+            barrier.subresourceRange.aspectMask = resource.aspectMask;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+            barrier.srcAccessMask = resource.writeAccessMask;
+            barrier.dstAccessMask = use.accessMask;
+            barriers.push_back(barrier);
+
+            srcStageMask |= waitStageMask != 0 ? waitStageMask : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+            dstStageMask |= use.stageMask;
+        }
+
+        // state after the use
+        resource.layout = use.layout;
+        if(use.isWrite || isLayoutChange)
+        {
+            resource.writeStageMask = use.stageMask;
+            resource.writeAccessMask = use.accessMask & WRITE_ACCESS_MASK;
+            resource.readStageMask = use.isWrite ? 0 : use.stageMask;
+            resource.syncedStageMask = use.stageMask;
+        }
+        else
+        {
+            resource.readStageMask |= use.stageMask;
+            resource.syncedStageMask |= isBarrierNeeded ? use.stageMask : 0;
+        }
+
+        // the next image of the memory slot waits on the latest use of this one
+        if(!resource.isImported)
+        {
+            MemorySlot& slot = memorySlots[resource.slot];
+            slot.stageMask = resource.writeStageMask | resource.readStageMask;
+            slot.accessMask = resource.writeAccessMask;
+        }
+    }
+
+    if(!barriers.empty())
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+}
+
+/// @brief one barrier moving all imported images to their final layout
+void VulkanRenderGraph::recordFinalBarriers(VkCommandBuffer commandBuffer)
+{
+    std::vector<VkImageMemoryBarrier> barriers;
+    VkPipelineStageFlags srcStageMask = 0;
+    VkPipelineStageFlags dstStageMask = 0;
+
+    for(const auto& resource : resources)
+    {
+        if(!resource.isImported)
+            continue;
+
+        VkPipelineStageFlags waitStageMask = resource.writeStageMask | resource.readStageMask;
+        if(resource.layout == resource.finalState.layout && resource.writeAccessMask == 0)
+            continue;
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = resource.layout;
+        barrier.newLayout = resource.finalState.layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = resource.image;
+        barrier.subresourceRange.aspectMask = resource.aspectMask;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        barrier.srcAccessMask = resource.writeAccessMask;
+        barrier.dstAccessMask = resource.finalState.accessMask;
+        barriers.push_back(barrier);
+
+        srcStageMask |= waitStageMask != 0 ? waitStageMask : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+        dstStageMask |= resource.finalState.stageMask;
+    }
+
+    if(!barriers.empty())
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+}
+
+/// @brief records the pass inside its rendering when it has attachments, timed as a gpu zone named after the pass
+void VulkanRenderGraph::recordPass(VkCommandBuffer commandBuffer, const Pass& pass, uint32_t alivePass, VulkanGpuProfiler* pGpuProfiler)
+{
+    uint32_t zone = pGpuProfiler != nullptr ? pGpuProfiler->BeginZone(commandBuffer, pass.name) : UINT32_MAX;
+
+    // attachments
+    // >> transient content not read by a later pass is not stored
+    auto getStoreOp = [this, alivePass](RenderGraphResource resource)
+    {
+        const Resource& attachment = resources[resource];
+        return attachment.isImported || attachment.lastPass > alivePass ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    };
+
+    std::vector<VkRenderingAttachmentInfo> colorAttachments;
+    colorAttachments.reserve(pass.colorAttachments.size());
+    for(const auto& attachment : pass.colorAttachments)
+    {
+        VkRenderingAttachmentInfo colorAttachment{};
+        colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        colorAttachment.imageView = resources[attachment.resource].imageView;
+        colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.loadOp = attachment.loadOp;
+        colorAttachment.storeOp = getStoreOp(attachment.resource);
+        colorAttachment.clearValue = attachment.clearValue;
+        colorAttachments.push_back(colorAttachment);
+    }
+
+    VkRenderingAttachmentInfo depthAttachment{};
+    if(pass.hasDepthAttachment)
+    {
+        depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        depthAttachment.imageView = resources[pass.depthAttachment.resource].imageView;
+        depthAttachment.imageLayout = pass.depthLayout;
+        depthAttachment.loadOp = pass.depthAttachment.loadOp;
+        depthAttachment.storeOp = getStoreOp(pass.depthAttachment.resource);
+        depthAttachment.clearValue = pass.depthAttachment.clearValue;
+    }
+
+    // command buffer: begin rendering
+    // >> the render area is the extent of the first attachment
+    bool isRendering = !colorAttachments.empty() || pass.hasDepthAttachment;
+    if(isRendering)
+    {
+        RenderGraphResource areaResource = !pass.colorAttachments.empty() ? pass.colorAttachments[0].resource : pass.depthAttachment.resource;
+
+        VkRenderingInfo renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        renderingInfo.flags = pass.renderingFlags;
+        renderingInfo.renderArea.offset = VkOffset2D {0, 0};
+        renderingInfo.renderArea.extent = resources[areaResource].extent;
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorAttachments.size());
+        renderingInfo.pColorAttachments = colorAttachments.data();
+        renderingInfo.pDepthAttachment = pass.hasDepthAttachment ? &depthAttachment : nullptr;
+        renderingInfo.pStencilAttachment = pass.hasDepthAttachment && (resources[pass.depthAttachment.resource].aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) ? &depthAttachment : nullptr;
+        vkCmdBeginRendering(commandBuffer, &renderingInfo);
+    }
+
+    if(pass.execute)
+        pass.execute(commandBuffer);
+
+    // command buffer: end rendering
+    if(isRendering)
+        vkCmdEndRendering(commandBuffer);
+
+    if(pGpuProfiler != nullptr)
+        pGpuProfiler->EndZone(commandBuffer, zone);
+}
+
+/// @brief aspects of the views and barriers of an image of the format
+VkImageAspectFlags VulkanRenderGraph::getAspectMask(VkFormat format)
+{
+    switch(format)
+    {
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+    case VK_FORMAT_D32_SFLOAT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    case VK_FORMAT_S8_UINT:
+        return VK_IMAGE_ASPECT_STENCIL_BIT;
+    default:
+        return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include "vk_mem_alloc.h"
+
+class VulkanMemoryHandler;
+class VulkanGpuProfiler;
+
+using RenderGraphResource = uint32_t;
+using RenderGraphPass = uint32_t;
+
+/// @brief how a pass uses an image, decides its layout, stages and access for the barriers
+enum class RenderGraphAccess : uint32_t
+{
+    ColorAttachmentWrite = 0,
+    DepthAttachmentWrite,
+    DepthAttachmentRead,    // depth test without depth writes
+    ShaderSampledRead,
+    StorageWrite,
+    TransferSrc,
+    TransferDst
+};
+
+/// @brief layout and last access of an image outside of the graph
+struct RenderGraphImageState
+{
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags stageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkAccessFlags accessMask = 0;
+};
+
+/// @brief image created by the graph, its usage is derived from the passes using it
+struct RenderGraphImageDesc
+{
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = {0, 0};
+};
+
+/// @brief Frame graph of the passes of one command buffer.
+/// @brief Passes declare the images they read and write, Execute then culls passes whose results are not used, records
+/// @brief one batched barrier per pass for the layout changes and hazards of its images, and begins / ends the rendering of
+/// @brief passes with attachments. Imported images (swapchain) are moved to their final layout after the last pass.
+/// @brief Transient images live from their first to their last pass, images with disjoint lifetimes share (alias) memory.
+/// @brief The graph is built again every frame, the transient images and their memory are kept while the passes and
+/// @brief image descriptions stay the same.
+class VulkanRenderGraph
+{
+public:
+    bool Create(VkDevice vkDevice, std::shared_ptr<VulkanMemoryHandler> memoryHandler);
+    void CleanUp();
+
+    // frees transient images of a previous layout of the graph once the frames using them completed
+    void CollectGarbage(uint64_t completedFrameValue);
+
+    // building: Reset, then images and passes in execution order
+    // >> names must outlive the frame (string literal), pass names are used as gpu zones
+    void Reset();
+    RenderGraphResource ImportImage(
+        const char* name,
+        VkImage image,
+        VkImageView imageView,
+        VkFormat format,
+        VkExtent2D extent,
+        const RenderGraphImageState& initialState,
+        const RenderGraphImageState& finalState);
+    RenderGraphResource CreateImage(const char* name, const RenderGraphImageDesc& desc);
+
+    RenderGraphPass AddPass(const char* name, std::function<void(VkCommandBuffer)> execute);
+    void AddColorAttachment(RenderGraphPass pass, RenderGraphResource resource, VkAttachmentLoadOp loadOp, VkClearValue clearValue = {});
+    void SetDepthAttachment(RenderGraphPass pass, RenderGraphResource resource, VkAttachmentLoadOp loadOp, VkClearValue clearValue = {}, bool isReadOnly = false);
+    void AddRead(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access);
+    void AddWrite(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access);
+
+    // rendering flags of a pass with attachments (secondary command buffer contents)
+    void SetRenderingFlags(RenderGraphPass pass, VkRenderingFlags flags);
+
+    // keeps a pass that writes no used image (queries, read back)
+    void SetSideEffect(RenderGraphPass pass);
+
+    // records the passes into the command buffer, frameValue is signaled by its submit
+    // >> false: no pass was recorded, only the transitions of the imported images to their final layout
+    bool Execute(VkCommandBuffer commandBuffer, uint64_t frameValue, VulkanGpuProfiler* pGpuProfiler = nullptr);
+
+    VkImageView GetImageView(RenderGraphResource resource) const;
+
+private:
+    struct Use
+    {
+        RenderGraphResource resource = 0;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags stageMask = 0;
+        VkAccessFlags accessMask = 0;
+        VkImageUsageFlags usage = 0;
+        bool isRead = false;
+        bool isWrite = false;
+    };
+
+    struct Attachment
+    {
+        RenderGraphResource resource = 0;
+        VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        VkClearValue clearValue = {};
+    };
+
+    struct Pass
+    {
+        const char* name = nullptr;
+        std::function<void(VkCommandBuffer)> execute;
+        std::vector<Use> uses;
+
+        std::vector<Attachment> colorAttachments;
+        bool hasDepthAttachment = false;
+        Attachment depthAttachment;
+        VkImageLayout depthLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkRenderingFlags renderingFlags = 0;
+
+        bool hasSideEffect = false;
+        bool isAlive = false;
+    };
+
+    struct Resource
+    {
+        const char* name = nullptr;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent = {0, 0};
+        VkImageAspectFlags aspectMask = 0;
+
+        // imported: given by the caller, transient: created by compile
+        bool isImported = false;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView imageView = VK_NULL_HANDLE;
+        RenderGraphImageState initialState;
+        RenderGraphImageState finalState;
+
+        // compile: lifetime in alive passes, usage of the transient image, memory slot
+        VkImageUsageFlags usage = 0;
+        uint32_t firstPass = UINT32_MAX;
+        uint32_t lastPass = 0;
+        uint32_t slot = UINT32_MAX;
+
+        // barriers: state after the latest use
+        // >> reads in syncedStageMask already wait on the last write (or layout change)
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStageMask = 0;
+        VkAccessFlags writeAccessMask = 0;
+        VkPipelineStageFlags readStageMask = 0;
+        VkPipelineStageFlags syncedStageMask = 0;
+    };
+
+    // transient image of the current layout of the graph
+    struct TransientKey
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent = {0, 0};
+        VkImageUsageFlags usage = 0;
+        uint32_t firstPass = 0;
+        uint32_t lastPass = 0;
+
+        bool operator==(const TransientKey& other) const;
+    };
+
+    struct TransientImage
+    {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView imageView = VK_NULL_HANDLE;
+        uint32_t slot = 0;
+    };
+
+    // memory shared by transient images with disjoint lifetimes
+    // >> the last use of the previous image (this or an earlier frame) is waited on by the first use of the next
+    struct MemorySlot
+    {
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        VkMemoryRequirements memoryRequirements{};
+        std::vector<std::pair<uint32_t, uint32_t>> lifetimes;
+
+        VkPipelineStageFlags stageMask = 0;
+        VkAccessFlags accessMask = 0;
+    };
+
+    // transient objects of a previous layout, destroyed once the last frame using them completed
+    struct Retired
+    {
+        uint64_t frameValue = 0;
+        std::vector<TransientImage> images;
+        std::vector<VmaAllocation> allocations;
+    };
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler;
+
+    // graph of the current frame
+    std::vector<Pass> passes;
+    std::vector<Resource> resources;
+    std::vector<uint32_t> alivePasses;
+
+    // transient images and memory of the current layout
+    std::vector<TransientKey> transientKeys;
+    std::vector<TransientImage> transientImages;
+    std::vector<MemorySlot> memorySlots;
+    uint64_t lastFrameValue = 0;
+
+    std::deque<Retired> retired;
+
+    void addUse(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access, bool isRead, bool isWrite);
+
+    // compile
+    void cullPasses();
+    void computeLifetimes();
+    bool realizeTransients();
+    bool createTransientImage(const Resource& resource, VkImage& image);
+    bool createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectMask, VkImageView& imageView);
+    void retireTransients();
+    void resetImportedStates();
+
+    // record
+    // >> alivePass is the position of the pass in alivePasses, lifetimes are given in it
+    void recordBarriers(VkCommandBuffer commandBuffer, const Pass& pass, uint32_t alivePass);
+    void recordFinalBarriers(VkCommandBuffer commandBuffer);
+    void recordPass(VkCommandBuffer commandBuffer, const Pass& pass, uint32_t alivePass, VulkanGpuProfiler* pGpuProfiler);
+
+    static VkImageAspectFlags getAspectMask(VkFormat format);
+};
\ No newline at end of file
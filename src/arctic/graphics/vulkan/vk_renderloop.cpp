@@ -4,6 +4,8 @@
 #include "vk_renderpipeline.h"
 #include "vk_memory_handler.h"
 #include "arctic/core/utilities/application.h"
+#include "arctic/core/utilities/thread_pool.h"
+#include "arctic/core/utilities/profiler.h"
 #include "arctic/graphics/rhi/vertex.h"
 #include "arctic/graphics/rhi/uniform_buffer_object.h"
 
@@ -14,19 +16,33 @@
 #include <iostream>
 #include <cstring>
 #include <chrono>
+#include <future>
+#include <algorithm>
+#include <array>
 #include <fmt/core.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+using TimingClock = std::chrono::steady_clock;
+
+/// @brief returns the milliseconds passed since start and restarts the measurement
+static double lapMs(TimingClock::time_point& start)
+{
+    auto now = TimingClock::now();
+    double ms = std::chrono::duration<double, std::milli>(now - start).count();
+    start = now;
+    return ms;
+}
 
 VulkanRenderLoop::VulkanRenderLoop(
     VkDevice vkDevice, 
     std::shared_ptr<VulkanSwapChain> swapChain, 
     std::shared_ptr<VulkanRenderPipeline> renderPipeline,
     std::shared_ptr<VulkanMemoryHandler> vkMemoryHandler, 
+    std::shared_ptr<VulkanPipelineCache> pipelineCache,
+    uint32_t framesInFlight,
     VkQueue graphicsQueue, 
     VkQueue transferQueue, 
-    VkQueue presentQueue)
+    VkQueue presentQueue,
+    bool isCalibratedTimestampsEnabled)
     :
     vkDevice(vkDevice),
     pSwapchain(swapChain),
@@ -34,28 +50,62 @@ VulkanRenderLoop::VulkanRenderLoop(
     vkMemoryHandler(vkMemoryHandler),
     vkGraphicsQueue(graphicsQueue),
     vkTransferQueue(transferQueue),
-    vkPresentQueue(presentQueue)
+    vkPresentQueue(presentQueue),
+    framesInFlight(framesInFlight)
 {
     // define frames to use
-    frames.resize(MAX_FRAMES_IN_FLIGHT);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    frames.resize(framesInFlight);
+    for (size_t i = 0; i < framesInFlight; i++)
     {
         this->frames[i] = std::unique_ptr<Frame>(new Frame());
     } 
         
+    // create worker threads for parallel command recording
+    pRecordThreadPool = std::make_unique<ThreadPool>();
+
     // create command pool and buffer
-    createCommandPool(renderPipeline->GetGraphicsFamilyIndex(), renderPipeline->GetTransferFamilyIndex());
+    createCommandPool(renderPipeline->GetGraphicsFamilyIndex());
     createCommandBuffers();
 
+    // create gpu profiler
+    // >> query pools per frame slot, profiling is disabled on devices without timestamps
+    // >> optional: when its queries cannot be created or calibrated, frames are rendered without gpu timings
+    if(!gpuProfiler.Create(vkDevice, vkMemoryHandler, graphicsQueue, renderPipeline->GetGraphicsFamilyIndex(), framesInFlight, isCalibratedTimestampsEnabled))
+    {
+        std::cout << "info: vulkan: gpu profiler could not be created, gpu profiling disabled" << std::endl;
+        gpuProfiler.CleanUp();
+    }
+
+    // create render graph
+    if(!renderGraph.Create(vkDevice, vkMemoryHandler))
+        return;
+
+    // create upload manager
+    // >> buffers are filled on the transfer queue, ownership is handed to the graphics family
+    if(!uploadManager.Create(vkDevice, vkMemoryHandler, transferQueue, renderPipeline->GetTransferFamilyIndex(), renderPipeline->GetGraphicsFamilyIndex(), STAGING_RING_CAPACITY))
+        return;
+
+    // create texture streamer
+    // >> decoded textures are queued on the upload manager, their mips on the mip generator
+    if(!mipGenerator.Create(vkDevice, vkMemoryHandler, pipelineCache) || !samplerCache.Create(vkDevice, vkMemoryHandler))
+        return;
+
+    if(!textureStreamer.Create(vkDevice, vkMemoryHandler, &uploadManager, &mipGenerator, &samplerCache))
+        return;
+
+    // create pipeline registry
+    if(!pipelineRegistry.Create(vkDevice, renderPipeline))
+        return;
+
     // syncing
     createSyncObjects();
 
     // create vertex buffer
     const std::vector<Vertex> vertices = {
-        {{-0.5f, -0.5f}, {1.0f, 0.0f, 1.0f}},
-        {{0.5f, -0.5f}, {0.0f, 1.0f, 1.0f}},
-        {{0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}},
-        {{-0.5f, 0.5f}, {0.0f, 1.0f, 0.25f}}
+        {{-0.5f, -0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
+        {{0.5f, -0.5f}, {0.0f, 1.0f, 1.0f}, {0.0f, 0.0f}},
+        {{0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
+        {{-0.5f, 0.5f}, {0.0f, 1.0f, 0.25f}, {1.0f, 1.0f}}
     };
 
     const std::vector<uint32_t> indices = {
@@ -74,12 +124,17 @@ VulkanRenderLoop::VulkanRenderLoop(
         return;
     }
 
+    // draw the quad
+    quadDraw.indexCount = static_cast<uint32_t>(indices.size());
+    drawList = { quadDraw };
+
     createUniformBuffers();
     createDescriptorPool();
     createDescriptorSets();
 
     // image loading
-    createTextureImage();
+    // >> decoded in the background, the quad shows the placeholder until the texture is resident
+    diffuseTexture = textureStreamer.Request(fmt::format("{}/images/{}", Application::AssetsPath, "texture.ktx2"));
 }
 
 void VulkanRenderLoop::CleanUp()
@@ -88,135 +143,360 @@ void VulkanRenderLoop::CleanUp()
     vkDeviceWaitIdle(vkDevice);
 
     // syncing
-    for(int i=0; i<MAX_FRAMES_IN_FLIGHT; ++i)
+    for(uint32_t i=0; i<framesInFlight; ++i)
     {
         auto& frame = this->frames[i];
 
         vkDestroySemaphore(vkDevice, frame->imageAvailableSemaphore, nullptr);
         vkDestroySemaphore(vkDevice, frame->renderFinishedSemaphore, nullptr);
-        vkDestroyFence(vkDevice, frame->isDoneRenderingFence, nullptr);
     }
+    frameTimeline.CleanUp();
+
+    // queries
+    gpuProfiler.CleanUp();
+
+    // transient images
+    renderGraph.CleanUp();
 
     // command pool & buffer
     vkDestroyCommandPool(vkDevice, vkCommandPoolGraphics, nullptr);
-    vkDestroyCommandPool(vkDevice, vkCommandPoolTransfer, nullptr);
-    
-    // buffers
-    vkDestroyBuffer(vkDevice, vertexBuffer, nullptr);
-    this->vertexBuffer = VK_NULL_HANDLE;
-    //vkFreeMemory(vkDevice, vertexBufferMemory, nullptr);
 
-    vmaDestroyBuffer(vkMemoryHandler->GetAllocator(), this->vertexBuffer, this->vertexBufferAllocation);
+    for(auto& frame : this->frames)
+    {
+        for(auto& commandPool : frame->sliceCommandPools)
+            vkDestroyCommandPool(vkDevice, commandPool, nullptr);
+        frame->sliceCommandPools.clear();
+        frame->sliceCommandBuffers.clear();
+    }
+    pRecordThreadPool.reset();
 
-    vkDestroyBuffer(vkDevice, indexBuffer, nullptr);
-    vkFreeMemory(vkDevice, indexBufferMemory, nullptr);
+    // pipelines
+    // >> the watcher first, it rebuilds pipelines through the registry
+    shaderWatcher.CleanUp();
+    pipelineRegistry.CleanUp();
+    
+    // textures
+    // >> before the upload manager, pending decodes are finished first
+    textureStreamer.CleanUp();
+    mipGenerator.CleanUp();
+    samplerCache.CleanUp();
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) 
-    {   
-        auto& frame = this->frames[i];
+    // uploads
+    uploadManager.CleanUp();
 
-        vkDestroyBuffer(vkDevice, frame->uniformBuffer, nullptr);
-        vkFreeMemory(vkDevice, frame->uniformBufferMemory, nullptr);
+    // buffers
+    vkMemoryHandler->DestroyBuffer(this->vertexBuffer, this->vertexBufferAllocation);
+    vkMemoryHandler->DestroyBuffer(this->indexBuffer, this->indexBufferAllocation);
+
+    uniformRing.CleanUp();
 
+    for (size_t i = 0; i < framesInFlight; i++) 
+    {   
         // destroy frame
-        frame.reset();
+        this->frames[i].reset();
     }
 
     vkDestroyDescriptorPool(vkDevice, vkDescriptorPool, nullptr);
 }
 
+void VulkanRenderLoop::SetDrawList(const std::vector<DrawItem>& drawList)
+{
+    this->drawList = drawList;
+}
+
+const DrawItem& VulkanRenderLoop::GetQuadDraw() const
+{
+    return this->quadDraw;
+}
+
+PipelineHandle VulkanRenderLoop::RequestPipeline(const PipelineDesc& desc)
+{
+    return pipelineRegistry.Request(desc);
+}
+
+void VulkanRenderLoop::SetShaderWatch(bool isEnabled)
+{
+    if(isEnabled == isWatchingShaders)
+        return;
+
+    // watch shader sources
+    // >> optional, without it shaders are only compiled by the build
+    if(isEnabled)
+    {
+        isWatchingShaders = shaderWatcher.Create(fmt::format("{}/shaders", Application::AssetsPath), [this](const std::string& binaryName)
+        {
+            pipelineRegistry.Reload(binaryName);
+        });
+        return;
+    }
+    shaderWatcher.CleanUp();
+    isWatchingShaders = false;
+}
+
+void VulkanRenderLoop::SetDepthPrepass(bool isEnabled)
+{
+    this->isDepthPrepassEnabled = isEnabled;
+}
+
 bool VulkanRenderLoop::IsSwapChainDirty() const
 {
     return this->isSwapChainDirty;
 }
 
+const FrameTimings& VulkanRenderLoop::GetFrameTimings() const
+{
+    return this->frameTimings;
+}
+
+const GpuFrameTimings& VulkanRenderLoop::GetGpuFrameTimings() const
+{
+    return this->gpuProfiler.GetFrameTimings();
+}
+
+uint32_t VulkanRenderLoop::GetFramesInFlight() const
+{
+    return this->framesInFlight;
+}
+
+const VkSemaphore& VulkanRenderLoop::GetFrameTimelineSemaphore() const
+{
+    return this->frameTimeline.GetSemaphore();
+}
+
+uint64_t VulkanRenderLoop::GetSubmittedFrameValue() const
+{
+    return this->submittedFrameValue;
+}
+
+uint64_t VulkanRenderLoop::GetCompletedFrameValue() const
+{
+    return this->frameTimeline.GetCompletedValue();
+}
+
+bool VulkanRenderLoop::WaitForFrame(uint64_t frameValue, uint64_t timeout) const
+{
+    return this->frameTimeline.Wait(frameValue, timeout);
+}
+
 void VulkanRenderLoop::Render()
 {
-    // wait until previous frame is finished
-    //// todo: implement multiple frames in flight. this avoids idle time (cpu waiting for gpu & vice versa)
-    //// https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Frames_in_flight
+    ARCTIC_PROFILE_FUNCTION();
+
+    // start timings
+    frameTimings = {};
+    auto frameStart = TimingClock::now();
+    auto lapStart = frameStart;
+
+    // wait until the gpu finished the previous frame that used this frame slot
+    // >> framesInFlight frames ago, so the cpu can record ahead while the gpu renders
     auto& frame = this->frames[currentFrameIndex];
-    vkWaitForFences(vkDevice, 1, &frame->isDoneRenderingFence, VK_TRUE, UINT64_MAX);
+    {
+        ARCTIC_PROFILE_ZONE("frame wait");
+        frameTimeline.Wait(frame->timelineValue);
+    }
+    frameTimings.waitMs = lapMs(lapStart);
+
+    // memory: refresh heap budgets once per frame
+    vkMemoryHandler->BeginFrame(static_cast<uint32_t>(submittedFrameValue + 1));
+
+    // free mip generation objects, replaced swapchains and replaced transient images of completed frames
+    mipGenerator.CollectGarbage(frameTimeline.GetCompletedValue());
+    pSwapchain->CollectGarbage(frameTimeline.GetCompletedValue());
+    renderGraph.CollectGarbage(frameTimeline.GetCompletedValue());
 
     // acquire next image from swap chain
 
     // try acquire next image
     uint32_t availableImageIndex = 0;
-    VkResult resultAcquireNextImage = vkAcquireNextImageKHR(vkDevice, pSwapchain->GetSwapChain(), UINT64_MAX, frame->imageAvailableSemaphore, VK_NULL_HANDLE, &availableImageIndex);
+    VkResult resultAcquireNextImage = VK_SUCCESS;
+    {
+        ARCTIC_PROFILE_ZONE("acquire");
+        resultAcquireNextImage = pSwapchain->AcquireNextImage(frame->imageAvailableSemaphore, availableImageIndex);
+    }
+    frameTimings.acquireMs = lapMs(lapStart);
 
     // check if swapchain still up-to-date
     // >> recreate when not (due to window resizing, ...)
+    // >> no device idle, frames in flight finish with the old swapchain while the new one is created
+    // >> suboptimal: the image was acquired (its semaphore will be signaled), render and present it, then recreate
     if (resultAcquireNextImage == VK_ERROR_OUT_OF_DATE_KHR)
     {   
-        // wait until idle
-        vkDeviceWaitIdle(vkDevice);
-
         // mark dirty
         this->isSwapChainDirty = true;
         return;
     }
-    else
-    {
-        this->isSwapChainDirty = false;
-    }   
+    this->isSwapChainDirty = resultAcquireNextImage == VK_SUBOPTIMAL_KHR;
+
+    // queue uploads of textures decoded since the last frame
+    // >> the frame slot is free, so its texture descriptors can be rewritten when textures became resident
+    textureStreamer.Update();
+    updateTextureDescriptors(*frame);
+
+    // submit queued uploads as one batch and free batches the gpu is done with
+    // >> the transfer queue works while this frame is recorded, the graphics submit waits for it on the upload timeline
+    uploadManager.Flush();
+    uploadManager.CollectGarbage();
+
+    // update uniform data shared by all draws
+    // >> uniform data of this frame slot is no longer read by the gpu after the timeline wait
+    // >> written before recording: without uniforms the frame is still recorded and submitted, cleared and without draws,
+    // >> so the acquired image is presented and the upload acquires and mip requests recorded into it are not lost
+    uniformRing.BeginFrame(currentFrameIndex);
+    bool hasFrameUniforms = updateFrameUniforms();
+    if(!hasFrameUniforms)
+        std::cout << "error: vulkan: failed to write frame uniforms, the frame is rendered without draws!";
 
-    // reset fence state to zero
-    // only reset the fence if we are submitting work
-    vkResetFences(vkDevice, 1, &frame->isDoneRenderingFence);
-    
     // record command buffer
     vkResetCommandBuffer(frame->commandBuffer, 0);
-    recordCommandBuffer(*frame, availableImageIndex);
+    bool isRecorded = recordCommandBuffer(*frame, availableImageIndex, hasFrameUniforms);
+    uniformRing.EndFrame();
+    frameTimings.recordMs = lapMs(lapStart);
+
+    // a command buffer that failed to begin or end cannot be submitted
+    if(!isRecorded)
+    {
+        releaseAcquiredImage(*frame);
+        return;
+    }
 
     // create info: command buffer submit 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
+    //> headless: offscreen images are not handed out by a presentation engine, so there are no semaphores to wait on or signal
+    bool isHeadless = pSwapchain->IsHeadless();
+
     //> specify semaphores to wait on before execution
-    VkSemaphore waitSemaphores[] = { frame->imageAvailableSemaphore};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    //> the upload timeline is waited on when this frame acquires uploaded buffers
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<VkPipelineStageFlags> waitStages;
+    std::vector<uint64_t> waitValues;
+    if(!isHeadless)
+    {
+        waitSemaphores.push_back(frame->imageAvailableSemaphore);
+        waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        waitValues.push_back(0); // value is ignored for binary semaphores
+    }
+    if(uploadWaitValue > 0)
+    {
+        waitSemaphores.push_back(uploadManager.GetTimelineSemaphore());
+        waitStages.push_back(uploadWaitStageMask);
+        waitValues.push_back(uploadWaitValue);
+    }
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
 
     //> specify command buffer
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &frame->commandBuffer;
 
     //> signal semaphores on finish execution
-    VkSemaphore signalSemaphores[] = { frame->renderFinishedSemaphore };
-    submitInfo.signalSemaphoreCount = 1;
+    //> the frame timeline is signaled with the next frame value, the binary semaphore is used for presenting
+    uint64_t frameValue = submittedFrameValue + 1;
+    VkSemaphore signalSemaphores[] = { frameTimeline.GetSemaphore(), frame->renderFinishedSemaphore };
+    uint64_t signalValues[] = { frameValue, 0 }; // value is ignored for binary semaphores
+    submitInfo.signalSemaphoreCount = isHeadless ? 1 : 2;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
+    //> timeline values
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = submitInfo.signalSemaphoreCount;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
+    submitInfo.pNext = &timelineInfo;
+
     // submit command buffer to graphics queue
-    VkResult resultQueueSubmit = vkQueueSubmit(vkGraphicsQueue, 1, &submitInfo, frame->isDoneRenderingFence);
+    // >> no fence: completion is tracked by the frame timeline
+    VkResult resultQueueSubmit = VK_SUCCESS;
+    {
+        ARCTIC_PROFILE_ZONE("submit");
+        resultQueueSubmit = vkQueueSubmit(vkGraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    }
     if(resultQueueSubmit != VK_SUCCESS)
     {
         std::cout << "error: vulkan: failed to submit command buffer to graphics queue!";
+        releaseAcquiredImage(*frame);
         return;
     }
+    submittedFrameValue = frameValue;
+    frame->timelineValue = frameValue;
+
+    // upload acquires and mip chains recorded into the command buffer are done once it was submitted
+    uploadManager.CommitAcquireBarriers();
+    mipGenerator.CommitRecorded();
+    frameTimings.submitMs = lapMs(lapStart);
+    frameTimings.frameValue = frameValue;
+
+    // present
+    VkResult resultPresent = VK_SUCCESS;
+    {
+        ARCTIC_PROFILE_ZONE("present");
+        resultPresent = pSwapchain->Present(vkPresentQueue, frame->renderFinishedSemaphore, availableImageIndex, frameValue);
+    }
+    if(resultPresent == VK_ERROR_OUT_OF_DATE_KHR || resultPresent == VK_SUBOPTIMAL_KHR)
+        this->isSwapChainDirty = true;
+    frameTimings.presentMs = lapMs(lapStart);
+    frameTimings.frameMs = lapMs(frameStart);
 
-    // create info: present khr
-    VkPresentInfoKHR presentInfo{};
-    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    // increase current image frame
+    currentFrameIndex = (currentFrameIndex + 1) % framesInFlight;
+}
 
-    presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
+/// @brief gives up the acquired image of a frame that could not be recorded or submitted
+/// @brief >> an empty submit waits on the image available semaphore, so it is unsignaled before the frame slot acquires with it again
+/// @brief >> the image is never presented, the swapchain is recreated to hand it back
+void VulkanRenderLoop::releaseAcquiredImage(Frame& frame)
+{
+    if(pSwapchain->IsHeadless())
+        return;
+    this->isSwapChainDirty = true;
 
-    VkSwapchainKHR swapChains[] = { pSwapchain->GetSwapChain() };
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = swapChains;
-    presentInfo.pImageIndices = &availableImageIndex;
-    presentInfo.pResults = nullptr; // Optional
+    // create info: empty submit
+    // >> signals the next frame value, the frame slot waits for it before it acquires again
+    uint64_t frameValue = submittedFrameValue + 1;
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    uint64_t waitValue = 0; // value is ignored for binary semaphores
 
-    // queue present khr
-    vkQueuePresentKHR(vkPresentQueue, &presentInfo);
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = 1;
+    timelineInfo.pWaitSemaphoreValues = &waitValue;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &frameValue;
 
-    // increase current image frame
-    currentFrameIndex = (currentFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &frame.imageAvailableSemaphore;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &frameTimeline.GetSemaphore();
+
+    if(vkQueueSubmit(vkGraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS)
+    {
+        submittedFrameValue = frameValue;
+        frame.timelineValue = frameValue;
+        return;
+    }
+
+    // the queue does not take submits anymore: replace the semaphore once the device is idle
+    // >> the pending signal of the acquire is dropped with the old semaphore
+    std::cout << "error: vulkan: failed to release acquired image, its semaphore is replaced!";
+    vkDeviceWaitIdle(vkDevice);
+    vkDestroySemaphore(vkDevice, frame.imageAvailableSemaphore, nullptr);
+    frame.imageAvailableSemaphore = VK_NULL_HANDLE;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    if(vkCreateSemaphore(vkDevice, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS)
+        std::cout << "error: vulkan: failed to create sync objects!";
 }
 
-void VulkanRenderLoop::createCommandPool(uint32_t graphicsFamilyIndex, uint32_t transferFamilyIndex)
+void VulkanRenderLoop::createCommandPool(uint32_t graphicsFamilyIndex)
 {
     // create info: command pool
     VkCommandPoolCreateInfo poolInfo{};
@@ -231,26 +511,12 @@ void VulkanRenderLoop::createCommandPool(uint32_t graphicsFamilyIndex, uint32_t
         std::cout << "error: vulkan: failed to create command pool!";
         return;
     }
-
-    // create info: command pool
-    VkCommandPoolCreateInfo poolInfo2{};
-    poolInfo2.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo2.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-    poolInfo2.queueFamilyIndex = transferFamilyIndex;
-
-    // create command pool
-    result = vkCreateCommandPool(vkDevice, &poolInfo2, nullptr, &vkCommandPoolTransfer);
-    if (result != VK_SUCCESS)
-    {
-        std::cout << "error: vulkan: failed to create command pool!";
-        return;
-    }
 }
 
 void VulkanRenderLoop::createCommandBuffers()
 {
     // create all buffers
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) 
+    for (size_t i = 0; i < framesInFlight; i++) 
     {   
         // get frame
         auto& frame = this->frames[i];
@@ -263,13 +529,44 @@ void VulkanRenderLoop::createCommandBuffers()
         allocInfo.commandBufferCount = 1;
 
         // create command buffers
-        //this->vkCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+        //this->vkCommandBuffers.resize(framesInFlight);
         VkResult result = vkAllocateCommandBuffers(vkDevice, &allocInfo, &frame->commandBuffer);
         if (result != VK_SUCCESS)
         {
             std::cout << "error: vulkan: failed to create command buffer!";
             return;
         }
+
+        // create slice pools and secondary command buffers
+        // >> one per worker thread, pools are reset as a whole every time the frame slot is recorded again
+        uint32_t sliceCount = pRecordThreadPool->GetThreadCount();
+        frame->sliceCommandPools.resize(sliceCount);
+        frame->sliceCommandBuffers.resize(sliceCount);
+        for(uint32_t slice = 0; slice < sliceCount; ++slice)
+        {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = pRenderPipeline->GetGraphicsFamilyIndex();
+
+            if (vkCreateCommandPool(vkDevice, &poolInfo, nullptr, &frame->sliceCommandPools[slice]) != VK_SUCCESS)
+            {
+                std::cout << "error: vulkan: failed to create command pool!";
+                return;
+            }
+
+            VkCommandBufferAllocateInfo sliceAllocInfo{};
+            sliceAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            sliceAllocInfo.commandPool = frame->sliceCommandPools[slice];
+            sliceAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY; // executed from the primary command buffer
+            sliceAllocInfo.commandBufferCount = 1;
+
+            if (vkAllocateCommandBuffers(vkDevice, &sliceAllocInfo, &frame->sliceCommandBuffers[slice]) != VK_SUCCESS)
+            {
+                std::cout << "error: vulkan: failed to create command buffer!";
+                return;
+            }
+        }
     }
 }
 
@@ -284,39 +581,24 @@ bool VulkanRenderLoop::createVertexBuffer(std::vector<Vertex> vertices)
     bool useStagingBuffer = true;
     if(useStagingBuffer)
     {
-        // create staging buffer (CPU-accessible)
-        // >> buffer will serve as the source for data transfer operations to the GPU
-        VkBuffer vertexBufferStaging;
-        VmaAllocation bufferAllocationStaging;
-        VkBufferUsageFlags bufferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        if(!vkMemoryHandler->CreateBufferVMA(bufferSize, bufferUsage, vmaFlags, &vertexBufferStaging, &bufferAllocationStaging))
-            return false;
-
-        // copy vertex data to staging buffer (CPU memory)
-        if(!vkMemoryHandler->CopyDataToBufferVMA(vertices.data(), bufferSize, bufferAllocationStaging))
-            return false;
-
         // create final vertex buffer (GPU-accessible)
         // >> buffer will be used as the destination for the data transfer and for rendering
         // >> allocated in device-local memory, not directly accessible by the CPU which generally means that we're not able to use vkMapMemory
-        bufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-        vmaFlags = 0;
-        if(!vkMemoryHandler->CreateBufferVMA(bufferSize, bufferUsage, vmaFlags, &this->vertexBuffer, &this->vertexBufferAllocation))
+        VkBufferUsageFlags bufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        if(!vkMemoryHandler->CreateBufferVMA(bufferSize, bufferUsage, 0, MemoryClass::Geometry, &this->vertexBuffer, &this->vertexBufferAllocation))
             return false;
 
-        // transfer vertex data from staging buffer to final vertex buffer (GPU memory)
-        if(!vkMemoryHandler->CopyBufferToBuffer(vertexBufferStaging, this->vertexBuffer, bufferSize, this->vkCommandPoolTransfer))
+        // queue transfer of the vertex data (staging buffer >> final vertex buffer)
+        // >> submitted with the next batch on the transfer queue, the first frame using it acquires it
+        if(!uploadManager.UploadBuffer(vertices.data(), bufferSize, this->vertexBuffer, 0, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT))
             return false;
-
-        // clean up staging buffer (no longer needed after data transfer)
-        vmaDestroyBuffer(vkMemoryHandler->GetAllocator(), vertexBufferStaging, bufferAllocationStaging);
     }
     else
     {
         // create vertex buffer (GPU interaction)
         // >> directly maps and copies vertex data into the GPU-accessible buffer
         VkBufferUsageFlags bufferUsage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-        if(!vkMemoryHandler->CreateBufferVMA(bufferSize, bufferUsage, vmaFlags, &vertexBuffer, &vertexBufferAllocation))
+        if(!vkMemoryHandler->CreateBufferVMA(bufferSize, bufferUsage, vmaFlags, MemoryClass::Default, &vertexBuffer, &vertexBufferAllocation))
             return false;
 
         // copy vertex data directly to the buffer (CPU memory)
@@ -328,132 +610,89 @@ bool VulkanRenderLoop::createVertexBuffer(std::vector<Vertex> vertices)
 
 bool VulkanRenderLoop::createIndexBuffer(std::vector<uint32_t> indices)
 {
-    VkDeviceSize bufferSize = sizeof(Vertex) * indices.size();
+    VkDeviceSize bufferSize = sizeof(uint32_t) * indices.size();
 
     bool useStagingBuffer = true;
     if(useStagingBuffer)
     {
-
-        VkBuffer indexBufferStaging;
-        VkDeviceMemory indexBufferMemoryStaging;
-
-        // create staging buffer (CPU-accessible)
-        // >> buffer will serve as the source for data transfer to the GPU
-        {
-            VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-            VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-            if(!vkMemoryHandler->CreateBuffer(bufferSize, usage, memoryProperties, indexBufferStaging, indexBufferMemoryStaging))
-                return false;
-        
-            // copy index data to staging buffer (CPU memory)
-            if(!vkMemoryHandler->CopyDataToBuffer(indices.data(), bufferSize, indexBufferMemoryStaging))
-                return false;
-        }
-
         // create final index buffer (GPU-accessible)
         // >> buffer will be the destination for the data transfer and used for rendering
         // >> allocated in device-local memory, meaning it's optimized for GPU but not CPU-accessible
-        {
-            VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-            VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-
-            if(!vkMemoryHandler->CreateBuffer(bufferSize, usage, memoryProperties, this->indexBuffer, this->indexBufferMemory))
-                return false;
-        }
-
-        // transfer index data from staging buffer to final index buffer (GPU memory)
-        vkMemoryHandler->CopyBufferToBuffer(indexBufferStaging, this->indexBuffer, bufferSize, this->vkCommandPoolTransfer);
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        if(!vkMemoryHandler->CreateBufferVMA(bufferSize, usage, 0, MemoryClass::Geometry, &this->indexBuffer, &this->indexBufferAllocation))
+            return false;
 
-        // cleanup staging buffer (no longer needed after data transfer)
-        vkDestroyBuffer(this->vkDevice, indexBufferStaging, nullptr);
-        vkFreeMemory(this->vkDevice, indexBufferMemoryStaging, nullptr);
+        // queue transfer of the index data (staging buffer >> final index buffer)
+        if(!uploadManager.UploadBuffer(indices.data(), bufferSize, this->indexBuffer, 0, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT))
+            return false;
     }
     else
     {
         // create index buffer (CPU-accessible)
         // >> this buffer will be directly used by both CPU and GPU
-        VkDeviceSize bufferSize = sizeof(Vertex) * indices.size();
         VkBufferUsageFlags usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-        VkMemoryPropertyFlags memoryPropeties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-        if(!vkMemoryHandler->CreateBuffer(bufferSize, usage, memoryPropeties, this->indexBuffer, this->indexBufferMemory))
+        VmaAllocationCreateFlags vmaFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        if(!vkMemoryHandler->CreateBufferVMA(bufferSize, usage, vmaFlags, MemoryClass::Default, &this->indexBuffer, &this->indexBufferAllocation))
             return false;
 
         // copy index data directly to buffer (CPU memory)
-        if(!vkMemoryHandler->CopyDataToBuffer(indices.data(), bufferSize, this->indexBufferMemory))
-                return false;
+        if(!vkMemoryHandler->CopyDataToBufferVMA(indices.data(), bufferSize, this->indexBufferAllocation))
+            return false;
     }
     return true;
 }
 
-/// @brief Create multiple uniform buffers.     
-/// @brief We're going to copy new data to the uniform buffer every frame, it doesn't really make any sense to have a staging buffer.       
-/// @brief We should have multiple buffers, because multiple frames may be in flight at the same time and we don't want to update       
-/// @brief the buffer in preparation of the next frame while a previous one is still reading from it. Thus, we need to have as many         
-/// @brief uniform buffers as we have frames in flight, and write to a uniform buffer that is not currently being read by the GPU
+/// @brief Creates the uniform ring.
+/// @brief We're going to write new uniform data every frame, it doesn't really make any sense to have a staging buffer.
+/// @brief The ring holds one region per frame in flight, so uniform data of the next frame never overwrites data
+/// @brief a previous frame is still reading.
 /// @return true when creation was successful 
 bool VulkanRenderLoop::createUniformBuffers()
 {   
-    // resize buffers
-    //uniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-    //uniformBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
-    //uniformBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
-
-    // create all buffers
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) 
-    {   
-        // get frame
-        auto& frame = this->frames[i];
-
-        // define buffer    
-        VkDeviceSize bufferSize = sizeof(UniformBufferObject);
-        VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-        VkMemoryPropertyFlags memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        
-        // create buffer
-        if(!vkMemoryHandler->CreateBuffer(bufferSize, usage, memoryFlags, frame->uniformBuffer, frame->uniformBufferMemory))
-            return false;
-
-        // map memory to buffer
-        vkMapMemory(this->vkDevice, frame->uniformBufferMemory, 0, bufferSize, 0, &frame->uniformBufferMapped);
-    }
-    return true;
+    return uniformRing.Create(vkMemoryHandler, UNIFORM_RING_FRAME_CAPACITY, framesInFlight);
 }
 
-void VulkanRenderLoop::updateUniformBuffer(const Frame& frame)
+/// @brief computes the uniform data shared by all draws of the frame and writes it into the ring
+/// @return false when the ring is out of space
+bool VulkanRenderLoop::updateFrameUniforms()
 {
     static auto startTime = std::chrono::high_resolution_clock::now();
 
     auto currentTime = std::chrono::high_resolution_clock::now();
     float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
 
+    // scene transform is applied to every draw's model matrix
+    this->sceneTransform = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+
     UniformBufferObject ubo{};
-    ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
 
     ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
 
     auto swapchainData = pSwapchain->GetData();
     auto swapchainExtent = swapchainData.extent;
 
-    ubo.proj = glm::perspective(glm::radians(45.0f), swapchainExtent.width / (float) swapchainExtent.height, 0.1f, 10.0f);
+    // reverse-z: near and far are swapped, the near plane maps to depth 1 and the far plane to depth 0
+    ubo.proj = glm::perspectiveRH_ZO(glm::radians(45.0f), swapchainExtent.width / (float) swapchainExtent.height, 10.0f, 0.1f);
 
     ubo.proj[1][1] *= -1;
 
-    memcpy(frame.uniformBufferMapped, &ubo, sizeof(ubo));
+    return uniformRing.Push(ubo, this->frameUniformOffset);
 }
 
 bool VulkanRenderLoop::createDescriptorPool()
 {
-    VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSize.descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    // one descriptor set per frame slot shared by all draws, the uniform block is selected with a dynamic offset
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = static_cast<uint32_t>(framesInFlight);
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = static_cast<uint32_t>(framesInFlight);
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = 1;
-    poolInfo.pPoolSizes = &poolSize;
-    poolInfo.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = static_cast<uint32_t>(framesInFlight);
 
     VkResult result = vkCreateDescriptorPool(this->vkDevice, &poolInfo, nullptr, &this->vkDescriptorPool);
     if (result != VK_SUCCESS)
@@ -468,29 +707,30 @@ bool VulkanRenderLoop::createDescriptorPool()
 bool VulkanRenderLoop::createDescriptorSets()
 {
     // allocate 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) 
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts(framesInFlight, this->pRenderPipeline->GetDescriptorSetLayout());
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = this->vkDescriptorPool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+    allocInfo.pSetLayouts = descriptorSetLayouts.data();
+
+    std::vector<VkDescriptorSet> descriptorSets(framesInFlight);
+    VkResult result = vkAllocateDescriptorSets(this->vkDevice, &allocInfo, descriptorSets.data());
+    if (result != VK_SUCCESS)
     {
-        // get frame
-        auto& frame = this->frames[i];
-
-        // create
-        auto descriptorSetLayout = this->pRenderPipeline->GetDescriptorSetLayout();
-        VkDescriptorSetAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = this->vkDescriptorPool;
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &descriptorSetLayout;
+        std::cout << "error: vulkan: failed to create descriptor sets!";
+        return false;
+    }
 
-        //this->vkDescriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
-        VkResult result = vkAllocateDescriptorSets(this->vkDevice, &allocInfo, &frame->descriptorSet);
-        if (result != VK_SUCCESS)
-        {
-            std::cout << "error: vulkan: failed to create descriptor sets!";
-            return false;
-        }
+    for (size_t i = 0; i < framesInFlight; i++)
+    {
+        auto& frame = this->frames[i];
+        frame->descriptorSet = descriptorSets[i];
 
+        // point the set at the ring buffer
+        // >> offset 0, the dynamic offset passed when binding selects the uniform block
         VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = frame->uniformBuffer;
+        bufferInfo.buffer = uniformRing.GetBuffer();
         bufferInfo.offset = 0;
         bufferInfo.range = sizeof(UniformBufferObject);
 
@@ -499,19 +739,51 @@ bool VulkanRenderLoop::createDescriptorSets()
         descriptorWrite.dstSet = frame->descriptorSet;
         descriptorWrite.dstBinding = 0;
         descriptorWrite.dstArrayElement = 0;
-        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         descriptorWrite.descriptorCount = 1;
         descriptorWrite.pBufferInfo = &bufferInfo;
         descriptorWrite.pImageInfo = nullptr; // Optional
         descriptorWrite.pTexelBufferView = nullptr; // Optional
 
         vkUpdateDescriptorSets(this->vkDevice, 1, &descriptorWrite, 0, nullptr);
+
+        // texture binding is written before the first use, see updateTextureDescriptors
+        frame->textureResidencyVersion = UINT64_MAX;
     }
     return true;
 }
 
-void VulkanRenderLoop::recordCommandBuffer(const Frame& frame, uint32_t imageIndex)
+/// @brief rewrites the texture binding of the frame's descriptor set when textures became resident since it was written
+/// @brief only called after the timeline wait of the frame slot, the gpu no longer reads the set
+void VulkanRenderLoop::updateTextureDescriptors(Frame& frame)
+{
+    uint64_t residencyVersion = textureStreamer.GetResidencyVersion();
+    if(frame.textureResidencyVersion == residencyVersion)
+        return;
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = textureStreamer.GetImageView(diffuseTexture);
+    imageInfo.sampler = textureStreamer.GetSampler(diffuseTexture);
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = frame.descriptorSet;
+    descriptorWrite.dstBinding = 1;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(this->vkDevice, 1, &descriptorWrite, 0, nullptr);
+    frame.textureResidencyVersion = residencyVersion;
+}
+
+/// @return false when the command buffer could not be begun or ended, it must not be submitted
+bool VulkanRenderLoop::recordCommandBuffer(const Frame& frame, uint32_t imageIndex, bool hasFrameUniforms)
 {
+    ARCTIC_PROFILE_FUNCTION();
+
     // get command buffer
     VkCommandBuffer commandBuffer = frame.commandBuffer;
 
@@ -525,29 +797,227 @@ void VulkanRenderLoop::recordCommandBuffer(const Frame& frame, uint32_t imageInd
     if (resultBeginCommandBuffer != VK_SUCCESS)
     {
         std::cout << "error: vulkan: failed to begin command buffer!";
-        return;
+        return false;
+    }
+
+    // command buffer: begin gpu profiling
+    // >> reads the timings of the previous frame of this slot, the frame timeline wait guarantees it completed
+    gpuProfiler.BeginFrame(commandBuffer, currentFrameIndex, submittedFrameValue + 1);
+
+    // command buffer: acquire buffers uploaded on the transfer queue
+    // >> must be outside the rendering, before the first draw reading them
+    {
+        VulkanGpuZone zone(gpuProfiler, commandBuffer, "upload acquire");
+        uploadManager.RecordAcquireBarriers(commandBuffer, uploadWaitValue, uploadWaitStageMask);
+    }
+
+    // command buffer: generate mip chains of the acquired textures
+    // >> the frame value is signaled by the submit of this command buffer
+    {
+        VulkanGpuZone zone(gpuProfiler, commandBuffer, "mip generation");
+        mipGenerator.Record(commandBuffer, submittedFrameValue + 1);
     }
  
     // get swapchain data
     SwapChainData swapChainData = pSwapchain->GetData();
 
-    // command buffer: begin render pass
-    VkRenderPassBeginInfo renderPassBeginInfo{};
-    renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassBeginInfo.renderPass = pRenderPipeline->GetRenderPass();
-    renderPassBeginInfo.framebuffer = pRenderPipeline->GetFrameBuffer(imageIndex);
+    // resolve pipelines of the draws
+    // >> pipelines still compiling resolve to the default pipeline, rebuilt pipelines are used from this frame on
+    pipelineRegistry.Snapshot(framePipelines, submittedFrameValue, frameTimeline.GetCompletedValue());
+
+    // render graph: passes of the frame
+    // >> barriers between the passes and the layout changes of the swapchain image follow from the declared reads and writes
+    renderGraph.Reset();
+
+    //> swapchain image: the previous content is discarded (cleared), the first write waits on the acquire semaphore at the color output stage
+    //> headless: offscreen images are never presented, they are handed back ready for read back instead
+    //> presenting: presentation is ordered by the render finished semaphore, no access to make visible
+    RenderGraphImageState acquiredState{ VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0 };
+    RenderGraphImageState finalState = swapChainData.isHeadless
+        ? RenderGraphImageState{ VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT }
+        : RenderGraphImageState{ VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0 };
+    RenderGraphResource backBuffer = renderGraph.ImportImage(
+        "swapchain",
+        pSwapchain->GetImages()[imageIndex],
+        pSwapchain->GetImageViews()[imageIndex],
+        pRenderPipeline->GetColorFormat(),
+        swapChainData.extent,
+        acquiredState,
+        finalState);
+
+    //> depth: transient, reverse-z so it is cleared to 0 (far)
+    RenderGraphResource depth = renderGraph.CreateImage("depth", { pRenderPipeline->GetDepthFormat(), swapChainData.extent });
+    VkClearValue depthClear{};
+    depthClear.depthStencil = { 0.0f, 0 };
+
+    //> frames without uniforms only clear, no pass draws
+    bool isDepthPrepass = isDepthPrepassEnabled && hasFrameUniforms;
+
+    //> depth prepass: draws the opaque draws depth only, recorded inline (no fragment shading, cheap to record)
+    if(isDepthPrepass)
+    {
+        RenderGraphPass depthPrepass = renderGraph.AddPass("depth prepass", [this, &frame](VkCommandBuffer commandBuffer)
+        {
+            recordDepthPrepass(commandBuffer, frame);
+        });
+        renderGraph.SetDepthAttachment(depthPrepass, depth, VK_ATTACHMENT_LOAD_OP_CLEAR, depthClear);
+    }
+
+    //> main pass: clears to black and draws the draw list
+    //> with the prepass the depth is read only, opaque draws only pass where their depth equals the prepass depth
+    //> large draw lists are recorded by worker threads into secondary command buffers executed inside the rendering
+    size_t drawCount = hasFrameUniforms ? drawList.size() : 0;
+    bool isParallelRecord = drawCount >= PARALLEL_RECORD_MIN_DRAWS && !frame.sliceCommandBuffers.empty();
+    RenderGraphPass mainPass = renderGraph.AddPass("main pass", [this, &frame, drawCount, isParallelRecord](VkCommandBuffer commandBuffer)
+    {
+        if(drawCount > 0)
+            recordMainPass(commandBuffer, frame, isParallelRecord);
+    });
+    renderGraph.AddColorAttachment(mainPass, backBuffer, VK_ATTACHMENT_LOAD_OP_CLEAR, {{{0.0f, 0.0f, 0.0f, 1.0f}}});
+    if(isDepthPrepass)
+        renderGraph.SetDepthAttachment(mainPass, depth, VK_ATTACHMENT_LOAD_OP_LOAD, {}, true);
+    else
+        renderGraph.SetDepthAttachment(mainPass, depth, VK_ATTACHMENT_LOAD_OP_CLEAR, depthClear);
+    if(isParallelRecord)
+        renderGraph.SetRenderingFlags(mainPass, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+
+    // command buffer: record the passes
+    // >> every pass is timed as a gpu zone, the statistics query is outside of their rendering (slices inherit it)
+    gpuProfiler.BeginStatistics(commandBuffer, isParallelRecord);
+    if(!renderGraph.Execute(commandBuffer, submittedFrameValue + 1, &gpuProfiler))
+        std::cout << "error: vulkan: failed to execute render graph, the frame is presented without its passes!";
+    gpuProfiler.EndStatistics(commandBuffer);
+
+    // command buffer: end gpu profiling
+    gpuProfiler.EndFrame(commandBuffer);
+
+    // command buffer: end
+    VkResult resultEndCommandBuffer = vkEndCommandBuffer(commandBuffer);
+    if (resultEndCommandBuffer != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to end command buffer!";
+        return false;
+    }
+    return true;
+}
+
+/// @brief Records a slice of the draw list into the secondary command buffer of the slice.
+/// @brief Runs on a worker thread, secondary command buffers do not inherit state so all draw state is bound again.
+void VulkanRenderLoop::recordSliceCommandBuffer(const Frame& frame, uint32_t sliceIndex, size_t firstDraw, size_t lastDraw)
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    // reset pool of the slice
+    // >> the frame timeline wait guarantees the gpu is done with the previous recording
+    vkResetCommandPool(vkDevice, frame.sliceCommandPools[sliceIndex], 0);
+    VkCommandBuffer commandBuffer = frame.sliceCommandBuffers[sliceIndex];
+
+    // inheritance: attachment formats of the rendering the slice is executed in
+    VkFormat colorFormat = pRenderPipeline->GetColorFormat();
+    VkCommandBufferInheritanceRenderingInfo inheritanceRenderingInfo{};
+    inheritanceRenderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+    inheritanceRenderingInfo.colorAttachmentCount = 1;
+    inheritanceRenderingInfo.pColorAttachmentFormats = &colorFormat;
+    inheritanceRenderingInfo.depthAttachmentFormat = pRenderPipeline->GetDepthFormat();
+    inheritanceRenderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    // inheritance: the slice executes inside the pipeline statistics query of the render graph passes
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.pNext = &inheritanceRenderingInfo;
+    inheritanceInfo.pipelineStatistics = gpuProfiler.GetInheritedStatistics();
+
+    // command buffer: begin
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to begin command buffer!";
+        return;
+    }
+
+    // draws of the slice are timed as one draw group
+    {
+        VulkanGpuZone zone(gpuProfiler, commandBuffer, "draw slice");
+        bindDrawState(commandBuffer, frame);
+        recordDraws(commandBuffer, frame, firstDraw, lastDraw);
+    }
+
+    // command buffer: end
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to end command buffer!";
+        return;
+    }
+}
+
+/// @brief Records the opaque draws with the depth only variant of their pipeline, called by the render graph inside the
+/// @brief rendering of the depth prepass.
+void VulkanRenderLoop::recordDepthPrepass(VkCommandBuffer commandBuffer, const Frame& frame)
+{
+    VulkanGpuZone zone(gpuProfiler, commandBuffer, "depth draws");
+    bindDrawState(commandBuffer, frame, true);
+    recordDraws(commandBuffer, frame, 0, drawList.size(), true);
+}
+
+/// @brief Records the draws of the main pass, called by the render graph inside the rendering of the pass.
+void VulkanRenderLoop::recordMainPass(VkCommandBuffer commandBuffer, const Frame& frame, bool isParallelRecord)
+{
+    size_t drawCount = drawList.size();
+
+    // small draw lists: record inline
+    if(!isParallelRecord)
+    {
+        VulkanGpuZone zone(gpuProfiler, commandBuffer, "draws");
+        bindDrawState(commandBuffer, frame);
+        recordDraws(commandBuffer, frame, 0, drawCount);
+        return;
+    }
+
+    // large draw lists: record slices on worker threads into secondary command buffers
+    size_t sliceCount = std::min(
+        frame.sliceCommandBuffers.size(),
+        (drawCount + PARALLEL_RECORD_MIN_DRAWS_PER_SLICE - 1) / PARALLEL_RECORD_MIN_DRAWS_PER_SLICE);
+    size_t drawsPerSlice = (drawCount + sliceCount - 1) / sliceCount;
+
+    // record slices
+    std::vector<std::future<void>> sliceTasks;
+    sliceTasks.reserve(sliceCount);
+    for(size_t slice = 0; slice < sliceCount; ++slice)
+    {
+        size_t firstDraw = slice * drawsPerSlice;
+        size_t lastDraw = std::min(firstDraw + drawsPerSlice, drawCount);
+        sliceTasks.push_back(pRecordThreadPool->Submit([this, &frame, slice, firstDraw, lastDraw]()
+        {
+            recordSliceCommandBuffer(frame, static_cast<uint32_t>(slice), firstDraw, lastDraw);
+        }));
+    }
+    for(auto& sliceTask : sliceTasks)
+        sliceTask.wait();
 
-    renderPassBeginInfo.renderArea.offset = VkOffset2D {0, 0};
-    renderPassBeginInfo.renderArea.extent = swapChainData.extent;
+    // execute slices in draw list order
+    vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(sliceCount), frame.sliceCommandBuffers.data());
+}
 
-    VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
-    renderPassBeginInfo.clearValueCount = 1;
-    renderPassBeginInfo.pClearValues = &clearColor;
+void VulkanRenderLoop::bindDrawState(VkCommandBuffer commandBuffer, const Frame& frame, bool isDepthOnly)
+{
+    // get swapchain data
+    SwapChainData swapChainData = pSwapchain->GetData();
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    // command buffer: bind to default pipeline
+    // >> depth only: a blended default pipeline has no depth variant, the first opaque draw binds its own
+    const CompiledPipeline& defaultPipeline = framePipelines[0];
+    VkPipeline pipeline = isDepthOnly ? defaultPipeline.depthPipeline : defaultPipeline.pipeline;
+    if(pipeline != VK_NULL_HANDLE)
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
-    // command buffer: bind to pipeline
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pRenderPipeline->GetPipeline());
+    // command buffer: set depth test of the default pipeline
+    // >> dynamic state, the depth only variants have theirs baked in
+    if(!isDepthOnly)
+        recordDepthState(commandBuffer, defaultPipeline.isOpaque);
 
     // command buffer: set viewport
     VkViewport viewport{};
@@ -573,126 +1043,105 @@ void VulkanRenderLoop::recordCommandBuffer(const Frame& frame, uint32_t imageInd
     // command buffer: bind index buffer
     vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-    // command buffer: bind descriptor sets
-    updateUniformBuffer(frame);
-    auto pipelineLayout = pRenderPipeline->GetPipelineLayout();
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &frame.descriptorSet, 0, nullptr);
+    // command buffer: bind descriptor set of the frame at its uniform block
+    // >> bound once per command buffer, draws only change push constants
+    auto pipelineLayout = framePipelines[0].layout;
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &frame.descriptorSet, 1, &frameUniformOffset);
+}
+
+void VulkanRenderLoop::recordDraws(VkCommandBuffer commandBuffer, const Frame& frame, size_t firstDraw, size_t lastDraw, bool isDepthOnly)
+{
+    const CompiledPipeline* pBound = &framePipelines[0];
+    for(size_t i = firstDraw; i < lastDraw; ++i)
+    {
+        const DrawItem& item = drawList[i];
+        const CompiledPipeline* pPipeline = item.pipeline < framePipelines.size() ? &framePipelines[item.pipeline] : &framePipelines[0];
+
+        // depth only: opaque draws with the depth variant of their pipeline, blended draws are skipped
+        VkPipeline pipeline = isDepthOnly ? pPipeline->depthPipeline : pPipeline->pipeline;
+        if(pipeline == VK_NULL_HANDLE)
+            continue;
+
+        // command buffer: bind pipeline of the draw when it changes
+        VkPipeline boundPipeline = isDepthOnly ? pBound->depthPipeline : pBound->pipeline;
+        if(pipeline != boundPipeline)
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+        // command buffer: set depth test when the draw switches between opaque and blended
+        if(!isDepthOnly && pPipeline->isOpaque != pBound->isOpaque)
+            recordDepthState(commandBuffer, pPipeline->isOpaque);
+
+        // command buffer: rebind the frame set when the layout changes
+        // >> equal shader interfaces share one layout handle, the bound set stays valid between their pipelines
+        if(pPipeline->layout != pBound->layout)
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pPipeline->layout, 0, 1, &frame.descriptorSet, 1, &frameUniformOffset);
+        pBound = pPipeline;
+
+        // command buffer: push model matrix of the draw
+        DrawConstants constants{};
+        constants.model = sceneTransform * item.model;
+        pushDrawConstants(commandBuffer, *pPipeline, constants);
+
+        // command buffer: draw
+        vkCmdDrawIndexed(commandBuffer, item.indexCount, item.instanceCount, item.firstIndex, item.vertexOffset, 0);
+    }
+}
 
-    // command buffer: draw
-    uint32_t vertexCount = 3;
-    //vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
+/// @brief sets the dynamic depth test of the main pass draws
+/// @brief reverse-z: the depth is cleared to 0, nearer fragments have greater depth
+/// @brief - opaque after the prepass: only the fragment that won the prepass passes (equal), the depth is final
+/// @brief - opaque without prepass: greater test and writes
+/// @brief - blended: tested against the opaque depth, never written so blended draws behind each other all blend
+void VulkanRenderLoop::recordDepthState(VkCommandBuffer commandBuffer, bool isOpaque)
+{
+    VkCompareOp compareOp = VK_COMPARE_OP_GREATER_OR_EQUAL;
+    if(isOpaque)
+        compareOp = isDepthPrepassEnabled ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_GREATER;
 
-    uint32_t indexCount = 6;
-    vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
-    
-    // command buffer: end render pass
-    vkCmdEndRenderPass(commandBuffer);
+    vkCmdSetDepthCompareOp(commandBuffer, compareOp);
+    vkCmdSetDepthWriteEnable(commandBuffer, isOpaque && !isDepthPrepassEnabled ? VK_TRUE : VK_FALSE);
+}
 
-    // command buffer: end
-    VkResult resultEndCommandBuffer = vkEndCommandBuffer(commandBuffer);
-    if (resultEndCommandBuffer != VK_SUCCESS)
-    {
-        std::cout << "error: vulkan: failed to end command buffer!";
+/// @brief sends per-draw data to the vertex stage as push constants
+/// @brief no memory write and no descriptor rebind, the values are recorded directly into the command buffer
+void VulkanRenderLoop::pushDrawConstants(VkCommandBuffer commandBuffer, const CompiledPipeline& pipeline, const DrawConstants& constants)
+{
+    // >> the stages and size come from the reflected push constant block of the pipeline
+    if(pipeline.pushConstantStages == 0)
         return;
-    }
+
+    vkCmdPushConstants(
+        commandBuffer, 
+        pipeline.layout, 
+        pipeline.pushConstantStages, 
+        0, 
+        pipeline.pushConstantSize, 
+        &constants);
 }
 
 void VulkanRenderLoop::createSyncObjects()
 {   
+    // create frame timeline
+    // >> starts at 0, every frame slot starts with timeline value 0 so the first wait returns immediately
+    if(!frameTimeline.Create(vkDevice, 0))
+        return;
+
     // create info
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // is signaled on start
-
-    // resize memory
-    //imageAvailableSemaphore.resize(MAX_FRAMES_IN_FLIGHT);
-    //renderFinishedSemaphore.resize(MAX_FRAMES_IN_FLIGHT);
-    //isDoneRenderingFence.resize(MAX_FRAMES_IN_FLIGHT);
-
-    for(int i=0; i<MAX_FRAMES_IN_FLIGHT; ++i)
+    for(uint32_t i=0; i<framesInFlight; ++i)
     {
         // get frame
         auto& frame = this->frames[i];
 
         // create objects
+        // >> binary semaphores are still required to synchronize with the presentation engine
         if (vkCreateSemaphore(vkDevice, &semaphoreInfo, nullptr, &frame->imageAvailableSemaphore) != VK_SUCCESS ||
-            vkCreateSemaphore(vkDevice, &semaphoreInfo, nullptr, &frame->renderFinishedSemaphore) != VK_SUCCESS ||
-            vkCreateFence(vkDevice, &fenceInfo, nullptr, &frame->isDoneRenderingFence) != VK_SUCCESS)
+            vkCreateSemaphore(vkDevice, &semaphoreInfo, nullptr, &frame->renderFinishedSemaphore) != VK_SUCCESS)
         {
             std::cout << "error: vulkan: failed to create sync objects!";
             return;
         }
     }
 }
-
-void VulkanRenderLoop::createTextureImage()
-{
-    // read image from path
-    int texWidth, texHeight, texChannels;
-    std::string pathTexture = fmt::format("{}/images/{}", Application::AssetsPath, "texture.jpg");
-    //std::cout << pathTexture << std::endl;
-    stbi_uc* pixels = stbi_load(pathTexture.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-    VkDeviceSize imageSize = texWidth * texHeight * 4;
-
-    if (!pixels) {
-        std::cout << "failed to load texture image!";
-        return;
-    }
-
-    // create vulkan buffers
-    VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-    if(!vkMemoryHandler->CreateBuffer(imageSize, usage, memoryProperties, this->stagingBuffer, this->stagingBufferMemory))
-        return;
-
-    // copy pixels to memory
-    void* data;
-    vkMapMemory(this->vkDevice, this->stagingBufferMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, (size_t) imageSize);
-    vkUnmapMemory(this->vkDevice, this->stagingBufferMemory);
-
-    // create image
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = static_cast<uint32_t>(texWidth);
-    imageInfo.extent.height = static_cast<uint32_t>(texHeight);
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.flags = 0; // Optional
-
-    if (vkCreateImage(this->vkDevice, &imageInfo, nullptr, &textureImage) != VK_SUCCESS) 
-    {
-        std::cout << "failed to create texture image!";
-        return;
-    }
-
-    // bind image to memory
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(this->vkDevice, textureImage, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    this->vkMemoryHandler->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, allocInfo.memoryTypeIndex);
-
-    if (vkAllocateMemory(this->vkDevice, &allocInfo, nullptr, &textureImageMemory) != VK_SUCCESS) {
-        throw std::runtime_error("failed to allocate image memory!");
-    }
-
-    vkBindImageMemory(this->vkDevice, textureImage, textureImageMemory, 0);
-
-    // cleanup
-    stbi_image_free(pixels);
-}
\ No newline at end of file
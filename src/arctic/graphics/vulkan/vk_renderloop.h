@@ -4,28 +4,81 @@
 #include <memory>
 #include <vulkan/vulkan_core.h>
 #include "vk_mem_alloc.h"
+#include "arctic/graphics/rhi/frame_timings.h"
+#include "arctic/graphics/rhi/draw_item.h"
+#include "vk_timeline.h"
+#include "vk_uniform_ring.h"
+#include "vk_upload_manager.h"
+#include "vk_texture_streamer.h"
+#include "vk_mip_generator.h"
+#include "vk_sampler_cache.h"
+#include "vk_pipeline_registry.h"
+#include "vk_shader_watcher.h"
+#include "vk_gpu_profiler.h"
+#include "vk_render_graph.h"
+#include "arctic/graphics/rhi/uniform_buffer_object.h"
+#include "arctic/graphics/rhi/draw_constants.h"
 
 class VulkanSwapChain;
 class VulkanRenderPipeline;
 class VulkanMemoryHandler;
+class VulkanPipelineCache;
+class ThreadPool;
 class Vertex;
 
 class VulkanRenderLoop
 {
 public:
+    // upper limit of the frames in flight setting
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
     VulkanRenderLoop(
         VkDevice vkDevice,
         std::shared_ptr<VulkanSwapChain> swapChain, 
         std::shared_ptr<VulkanRenderPipeline> renderPipeline,
         std::shared_ptr<VulkanMemoryHandler> vkMemoryHandler, 
+        std::shared_ptr<VulkanPipelineCache> pipelineCache,
+        uint32_t framesInFlight,
         VkQueue GraphicsQueue,
         VkQueue vkTransferQueue,
-        VkQueue vkPresentQueue);
+        VkQueue vkPresentQueue,
+        bool isCalibratedTimestampsEnabled = false);
     
     void Render();
     void CleanUp();
 
+    // draw list of the next frames
+    // >> the quad is the only mesh for now, draws of it are copies of the quad draw with their own model matrix
+    void SetDrawList(const std::vector<DrawItem>& drawList);
+    const DrawItem& GetQuadDraw() const;
+
+    // pipelines
+    // >> compiled in the background, draws use the default pipeline until theirs is ready
+    PipelineHandle RequestPipeline(const PipelineDesc& desc);
+
+    // shader hot reload: watches the shader sources, edited shaders are recompiled and their pipelines rebuilt
+    // >> off by default, a watcher thread and glslc processes would disturb measurements
+    void SetShaderWatch(bool isEnabled);
+
+    // depth prepass: opaque draws write depth first, the main pass then shades only the visible fragment of each pixel
+    void SetDepthPrepass(bool isEnabled);
+
     bool IsSwapChainDirty() const;
+    const FrameTimings& GetFrameTimings() const;
+
+    // gpu timings of the latest completed frame, framesInFlight frames behind the cpu
+    const GpuFrameTimings& GetGpuFrameTimings() const;
+
+    // frames in flight actually used, the requested count clamped to [1, MAX_FRAMES_IN_FLIGHT]
+    uint32_t GetFramesInFlight() const;
+
+    // frame timeline
+    // >> every submitted frame signals the next value of one monotonic counter
+    // >> other subsystems can wait for or poll "frame N done" without their own sync objects
+    const VkSemaphore& GetFrameTimelineSemaphore() const;
+    uint64_t GetSubmittedFrameValue() const;
+    uint64_t GetCompletedFrameValue() const;
+    bool WaitForFrame(uint64_t frameValue, uint64_t timeout = UINT64_MAX) const;
 
 private:
 
@@ -36,64 +89,120 @@ private:
 
     // commands
     VkCommandPool vkCommandPoolGraphics;
-    VkCommandPool vkCommandPoolTransfer;
 
     VkQueue vkGraphicsQueue;
     VkQueue vkTransferQueue;
     VkQueue vkPresentQueue;
 
     // syncing
-    const int MAX_FRAMES_IN_FLIGHT = 3;
+    // >> frames recorded ahead of the gpu, more hide cpu spikes, fewer reduce latency
+    uint32_t framesInFlight = 3;
 
     uint16_t currentFrameIndex = 0;
 
+    VulkanTimeline frameTimeline;
+    uint64_t submittedFrameValue = 0; // timeline value signaled by the last submitted frame
+
+    // parallel recording
+    // >> draw lists of at least PARALLEL_RECORD_MIN_DRAWS draws are split into slices
+    // >> each slice is recorded into its own secondary command buffer by a worker thread
+    const size_t PARALLEL_RECORD_MIN_DRAWS = 1024;
+    const size_t PARALLEL_RECORD_MIN_DRAWS_PER_SLICE = 256;
+    std::unique_ptr<ThreadPool> pRecordThreadPool;
+
     struct Frame
     {   
         // commands
         VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
 
+        // commands: one pool and secondary command buffer per slice
+        // >> command pools are externally synchronized, a pool is only touched by the worker recording its slice
+        std::vector<VkCommandPool> sliceCommandPools;
+        std::vector<VkCommandBuffer> sliceCommandBuffers;
+
         // syncing
         VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
         VkSemaphore renderFinishedSemaphore = VK_NULL_HANDLE;
-        VkFence isDoneRenderingFence = VK_NULL_HANDLE;
+        uint64_t timelineValue = 0; // frame slot is free once the frame timeline reaches this value
 
-        // memory
+        // descriptors: one set per frame slot, so texture bindings can be rewritten while other frames are in flight
         VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
-
-        VkBuffer uniformBuffer = VK_NULL_HANDLE;
-        VkDeviceMemory uniformBufferMemory = VK_NULL_HANDLE;
-        void* uniformBufferMapped = nullptr;
+        uint64_t textureResidencyVersion = UINT64_MAX; // streamer residency version the set was written with
     };
 
     std::vector<std::unique_ptr<Frame>> frames;
 
-    bool isSwapChainDirty;
+    // uploads
+    // >> batched on the transfer queue, the graphics submit waits on the upload timeline value of the acquired batches
+    const VkDeviceSize STAGING_RING_CAPACITY = 32 * 1024 * 1024;
+    VulkanUploadManager uploadManager;
+    uint64_t uploadWaitValue = 0;
+    VkPipelineStageFlags uploadWaitStageMask = 0;
+
+    // textures
+    // >> decoded on worker threads, uploaded with the upload batches, a placeholder is bound until resident
+    // >> mip chains are generated on the graphics queue by the frame acquiring the upload
+    VulkanMipGenerator mipGenerator;
+    VulkanSamplerCache samplerCache;
+    VulkanTextureStreamer textureStreamer;
+    TextureHandle diffuseTexture = 0;
+
+    bool isSwapChainDirty = false;
+
+    // pipelines
+    // >> resolved once per frame, recording threads read the snapshot only
+    // >> edited shaders are recompiled by the watcher, their pipelines rebuilt by the registry and swapped in by the snapshot
+    VulkanPipelineRegistry pipelineRegistry;
+    VulkanShaderWatcher shaderWatcher;
+    bool isWatchingShaders = false;
+    std::vector<CompiledPipeline> framePipelines;
+
+    // timings of the last rendered frame
+    FrameTimings frameTimings;
+
+    // gpu timings: passes and draw groups are recorded as zones, read back once their frame slot is reused
+    VulkanGpuProfiler gpuProfiler;
+
+    // passes: built every frame, barriers and transient images (aliased when their lifetimes are disjoint) come from the graph
+    VulkanRenderGraph renderGraph;
+    bool isDepthPrepassEnabled = true;
 
     // memory
     std::shared_ptr<VulkanMemoryHandler> vkMemoryHandler;
 
     VkDescriptorPool vkDescriptorPool;
 
+    // .. uniforms
+    // >> per-frame data (view, proj) is written once per frame into the ring and bound with a dynamic offset
+    // >> per-draw data (model) is sent as push constants, see pushDrawConstants
+    const VkDeviceSize UNIFORM_RING_FRAME_CAPACITY = 64 * 1024;
+    VulkanUniformRing uniformRing;
+    uint32_t frameUniformOffset = 0;
+    glm::mat4 sceneTransform = glm::mat4(1.0f);
+
     // .. mesh
+    std::vector<DrawItem> drawList;
+    DrawItem quadDraw;
+
     VkBuffer vertexBuffer;
     VmaAllocation vertexBufferAllocation;
 
     VkBuffer indexBuffer;
-    VkDeviceMemory indexBufferMemory;
-
-    // .. image
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    VkImage textureImage;
-    VkDeviceMemory textureImageMemory;
+    VmaAllocation indexBufferAllocation;
 
     // commands
-    void createCommandPool(uint32_t graphicsFamilyIndex, uint32_t transferFamilyIndex);
+    void createCommandPool(uint32_t graphicsFamilyIndex);
     void createCommandBuffers();
     
-    void recordCommandBuffer(const Frame& frame, uint32_t imageIndex);
-    void updateUniformBuffer(const Frame& frame);
+    bool recordCommandBuffer(const Frame& frame, uint32_t imageIndex, bool hasFrameUniforms);
+    void recordSliceCommandBuffer(const Frame& frame, uint32_t sliceIndex, size_t firstDraw, size_t lastDraw);
+    void recordDepthPrepass(VkCommandBuffer commandBuffer, const Frame& frame);
+    void recordMainPass(VkCommandBuffer commandBuffer, const Frame& frame, bool isParallelRecord);
+    void bindDrawState(VkCommandBuffer commandBuffer, const Frame& frame, bool isDepthOnly = false);
+    void recordDraws(VkCommandBuffer commandBuffer, const Frame& frame, size_t firstDraw, size_t lastDraw, bool isDepthOnly = false);
+    void recordDepthState(VkCommandBuffer commandBuffer, bool isOpaque);
+    void pushDrawConstants(VkCommandBuffer commandBuffer, const CompiledPipeline& pipeline, const DrawConstants& constants);
+    bool updateFrameUniforms();
 
     // memory
     bool createVertexBuffer(std::vector<Vertex> vertices);
@@ -102,10 +211,9 @@ private:
     bool createUniformBuffers();
     bool createDescriptorPool();
     bool createDescriptorSets();
+    void updateTextureDescriptors(Frame& frame);
 
     // syncing
     void createSyncObjects();
-
-    // images
-    void createTextureImage();
+    void releaseAcquiredImage(Frame& frame);
 };
\ No newline at end of file
@@ -1,48 +1,82 @@
 #include "vk_renderpipeline.h"
 #include <iostream>
+#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 
 #include <fmt/core.h>
 #include "arctic/core/utilities/file_utility.h"
 #include "arctic/core/utilities/application.h"
 
-#include "render_utils.h"
+#include "vk_pipeline_cache.h"
+#include "arctic/graphics/rhi/draw_constants.h"
+#include "arctic/graphics/rhi/vertex.h"
+
+// vertex buffer layout: location and format of every member of Vertex
+// >> vertex shaders read any subset of the locations, each with the format of its member
+struct VertexMember
+{
+    uint32_t location;
+    VkFormat format;
+    uint32_t offset;
+};
+
+static const VertexMember VERTEX_MEMBERS[] =
+{
+    { 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, pos) },
+    { 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color) },
+    { 2, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, texCoord) }
+};
+
+static VkPrimitiveTopology toVkTopology(PrimitiveTopology topology)
+{
+    switch(topology)
+    {
+        case PrimitiveTopology::TriangleStrip: return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+        case PrimitiveTopology::LineList: return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+        case PrimitiveTopology::PointList: return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+        default: return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    }
+}
+
+static VkCullModeFlags toVkCullMode(CullMode cullMode)
+{
+    switch(cullMode)
+    {
+        case CullMode::None: return VK_CULL_MODE_NONE;
+        case CullMode::Front: return VK_CULL_MODE_FRONT_BIT;
+        default: return VK_CULL_MODE_BACK_BIT;
+    }
+}
 
 VulkanRenderPipeline::VulkanRenderPipeline(
     const VkDevice& vkDevice, 
     uint32_t graphicsFamilyIndex,
-    uint32_t transferFamilyIndex)
+    uint32_t transferFamilyIndex,
+    std::shared_ptr<VulkanPipelineCache> pipelineCache)
     :
     vkDevice(vkDevice),
     graphicsFamilyIndex(graphicsFamilyIndex),
-    transferFamilyIndex(transferFamilyIndex)
+    transferFamilyIndex(transferFamilyIndex),
+    pPipelineCache(pipelineCache)
 {
+    layoutCache.Create(vkDevice);
 }
 
-void VulkanRenderPipeline::Load(
-    const SwapChainData & swapChainData, 
-    const std::vector<VkImageView> & swapChainImageViews)
+void VulkanRenderPipeline::Load(const SwapChainData & swapChainData)
 {
-    this->swapChainData=swapChainData;
-    this->swapChainImageViews=swapChainImageViews;
+    this->colorFormat = swapChainData.imageFormat;
 
-    createRenderPass();
     createPipeline();
-    createFramebuffers();
 }
 
 void VulkanRenderPipeline::CleanUp()
 {
-    // frame buffers
-    for (auto framebuffer : swapChainFramebuffers)
-    {
-        vkDestroyFramebuffer(vkDevice, framebuffer, nullptr);
-    }
-
     // pipeline
-    vkDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout, nullptr);
-    vkDestroyPipeline(vkDevice, vkPipeline, nullptr);
-    vkDestroyPipelineLayout(vkDevice, vkPipelineLayout, nullptr);
-    vkDestroyRenderPass(vkDevice, vkRenderPass, nullptr);
+    // >> descriptor set and pipeline layouts are owned by the layout cache
+    DestroyPipeline(defaultPipeline);
+    layoutCache.CleanUp();
 }
 
 uint32_t VulkanRenderPipeline::GetGraphicsFamilyIndex()
@@ -55,102 +89,71 @@ uint32_t VulkanRenderPipeline::GetTransferFamilyIndex()
     return this->transferFamilyIndex;
 }
 
-const VkRenderPass &VulkanRenderPipeline::GetRenderPass()
+VkFormat VulkanRenderPipeline::GetColorFormat() const
+{
+    return this->colorFormat;
+}
+
+VkFormat VulkanRenderPipeline::GetDepthFormat() const
 {
-    return this->vkRenderPass;
+    return this->depthFormat;
 }
 
 const VkPipeline &VulkanRenderPipeline::GetPipeline()
 {
-    return this->vkPipeline;
+    return this->defaultPipeline.pipeline;
 }
 
 const VkPipelineLayout &VulkanRenderPipeline::GetPipelineLayout()
 {
-    return this->vkPipelineLayout;
+    return this->defaultPipeline.layout;
 }
 
-const VkDescriptorSetLayout& VulkanRenderPipeline::GetDescriptorSetLayout()
+const CompiledPipeline& VulkanRenderPipeline::GetDefaultPipeline() const
 {
-    return this->vkDescriptorSetLayout;
+    return this->defaultPipeline;
 }
 
-const VkFramebuffer & VulkanRenderPipeline::GetFrameBuffer(uint32_t index)
+const VkDescriptorSetLayout& VulkanRenderPipeline::GetDescriptorSetLayout()
 {
-    return this->swapChainFramebuffers[index];
+    return this->vkDescriptorSetLayout;
 }
 
 /// <summary>
-/// Specify the render pass and subpass index that the pipeline is compatible with, 
-/// This determines the framebuffer attachments, their formats, and the load/store operations
+/// Creates the frame descriptor set layout (set 0) and the default pipeline.
+/// Set 0 is reflected from the default shaders, it holds the data bound once per frame (uniform ring block, textures).
+/// The default pipeline is compiled synchronously, draws fall back to it while their own pipeline compiles.
 /// </summary>
-void VulkanRenderPipeline::createRenderPass()
+void VulkanRenderPipeline::createPipeline()
 {
-    // create color attachment
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = swapChainData.imageFormat;
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-
-    // what to do before and after rendering
-    //> clear to black before rendering
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-
-    // currently application won't do anything with the stencil buffer
-    // todo later: set correct values when need to use the stencil
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-
-    // images need to be transitioned to specific layouts that are suitable
-    // for the operation that they're going to be involved in next
-    // for example: textures and framebuffers in Vulkan are represented by 'VkImage' objects
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    // create color attachment reference
-    // every subpass references one or more attachment rederences
-    //> only one is used
-    VkAttachmentReference colorAttachmentRef{};
-    colorAttachmentRef.attachment = 0;
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    // create sub pass
-    //> the index of the attachment in this array is directly referenced from the fragment shader with
-    //> "layout(location = 0) out vec4 outColor" directive
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-
-    // create info: render pass
-    VkRenderPassCreateInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-
-    //> set subpass dependencies to render pass
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.srcAccessMask = 0;
-
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
-
-    // create render pass
-    VkResult resultPipeline = vkCreateRenderPass(vkDevice, &renderPassInfo, nullptr, &vkRenderPass);
-    if (resultPipeline != VK_SUCCESS)
-    {
-        std::cout <<"error: vulkan: failed to create render pass!";
+    // reflect default shaders
+    PipelineDesc desc{};
+    ShaderReflection reflectionVert;
+    ShaderReflection reflectionFrag;
+    std::vector<char> code;
+    if(!readShader(desc.vertexShader, VK_SHADER_STAGE_VERTEX_BIT, code, reflectionVert) ||
+       !readShader(desc.fragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT, code, reflectionFrag))
+        return;
+
+    ShaderLayout layout;
+    if(!VulkanShaderReflection::Merge({ &reflectionVert, &reflectionFrag }, layout))
         return;
+
+    // create descriptor set layout: frame set
+    //> uniform blocks are sub-allocated from the uniform ring, selected with a dynamic offset when binding
+    frameSetBindings = layout.sets.empty() ? std::vector<VkDescriptorSetLayoutBinding>() : layout.sets[0];
+    for(auto& binding : frameSetBindings)
+    {
+        if(binding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+            binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     }
+
+    vkDescriptorSetLayout = layoutCache.GetDescriptorSetLayout(frameSetBindings);
+    if(vkDescriptorSetLayout == VK_NULL_HANDLE)
+        return;
+
+    // create default pipeline
+    CreatePipeline(desc, defaultPipeline);
 }
 
 /// <summary>
@@ -160,41 +163,57 @@ void VulkanRenderPipeline::createRenderPass()
 /// - inputAssembly (what kind of geometry/topology will be drawn from the vertices)
 /// - viewportState (description of the viewport)
 /// - pRasterizationState (takes the geometry that is shaped by the vertices from the vertex shader and turns it into colored fragments, also performs depth testing, face culling)
-/// - pDepthStencilState
+/// - pDepthStencilState (reverse-z depth test, compare op and writes are set when recording)
 /// - multisampling (ways to perform anti-aliasing)
 /// - colorBlending (define how the final color values are blended with the existing values in the framebuffer)
 /// - dynamicState (specify which pipeline states can be changed dynamically during command buffer recording without recreating the pipeline)
 /// - vkPipelineLayout (define descriptor set layouts that describe the resource bindings used by shaders (e.g., uniform buffers, textures, samplers))
+/// Opaque pipelines get a second, depth only variant (vertex stage, no color attachment) for the depth prepass.
+/// Only reads state that is fixed after Load, so it can run on worker threads (see VulkanPipelineRegistry).
 ///</summary>
-void VulkanRenderPipeline::createPipeline()
+bool VulkanRenderPipeline::CreatePipeline(const PipelineDesc& desc, CompiledPipeline& compiled) const
 {
-    // read file: vertex shader
+    // read and reflect file: vertex shader
     std::vector<char> fileVert;
-    std::string pathVert = fmt::format("{}/shaders/{}", Application::AssetsPath, "vert.spv");
-    FileUtility::ReadBinaryFile(pathVert, fileVert);
+    ShaderReflection reflectionVert;
     VkShaderModule shaderModuleVert;
-    createShaderModule(fileVert, shaderModuleVert);
+    if(!readShader(desc.vertexShader, VK_SHADER_STAGE_VERTEX_BIT, fileVert, reflectionVert) || !createShaderModule(fileVert, shaderModuleVert))
+        return false;
 
-    // read file: frag shader
+    // read and reflect file: frag shader
     std::vector<char> fileFrag;
-    std::string pathFrag= fmt::format("{}/shaders/{}",Application::AssetsPath, "frag.spv");
-    FileUtility::ReadBinaryFile(pathFrag, fileFrag);
+    ShaderReflection reflectionFrag;
     VkShaderModule shaderModuleFrag;
-    createShaderModule(fileFrag, shaderModuleFrag);
+    if(!readShader(desc.fragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT, fileFrag, reflectionFrag) || !createShaderModule(fileFrag, shaderModuleFrag))
+    {
+        vkDestroyShaderModule(vkDevice, shaderModuleVert, nullptr);
+        return false;
+    }
+
+    // get pipeline layout
+    //> shaders with the same interface share one layout, descriptor sets stay bound when switching between their pipelines
+    CompiledPipeline result{};
+    std::vector<VkVertexInputAttributeDescription> vertexAttributeDescs;
+    if(!createPipelineLayout(desc, reflectionVert, reflectionFrag, result) || !createVertexAttributes(desc, reflectionVert, vertexAttributeDescs))
+    {
+        vkDestroyShaderModule(vkDevice, shaderModuleVert, nullptr);
+        vkDestroyShaderModule(vkDevice, shaderModuleFrag, nullptr);
+        return false;
+    }
 
     // create vertex pipeline shader stage 
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
     vertShaderStageInfo.module = shaderModuleVert;
-    vertShaderStageInfo.pName = "main";
+    vertShaderStageInfo.pName = reflectionVert.entryPoint.c_str();
 
     // create frag pipeline shader stage 
     VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
     fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
     fragShaderStageInfo.module = shaderModuleFrag;
-    fragShaderStageInfo.pName = "main";
+    fragShaderStageInfo.pName = reflectionFrag.entryPoint.c_str();
 
     // combine pipeline shader stages
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
@@ -202,10 +221,13 @@ void VulkanRenderPipeline::createPipeline()
     // create info: dynamic states
     //> while most of the pipeline state needs to be baked into the pipeline state,
     //> a limited amount of the state can actually be changed without recreating the pipeline at draw time
+    //> depth compare and writes depend on whether the frame has a depth prepass, see VulkanRenderLoop::recordDepthState
     std::vector<VkDynamicState> dynamicStates =
     {
         VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR
+        VK_DYNAMIC_STATE_SCISSOR,
+        VK_DYNAMIC_STATE_DEPTH_COMPARE_OP,
+        VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE
     };
 
     VkPipelineDynamicStateCreateInfo dynamicState{};
@@ -217,12 +239,16 @@ void VulkanRenderPipeline::createPipeline()
     //> describes the format of the vertex data that will be passed to the vertex shader
     //> bindings: spacing between data and whether the data is per-vertex or per-instance
     //> attribute descriptions: type of the attributes passed to the vertex shader, which binding to load them from and at which offset
-    auto vertexBindingDesc = RenderUtils::GetBindingDescription();
-    auto vertexAttributeDescs = RenderUtils::GetAttributeDescriptions();
+    //> one interleaved binding of Vertex, the attributes are the inputs of the vertex shader at the offsets of their members
+    //> shaders without inputs (generated vertices) get no binding
+    VkVertexInputBindingDescription vertexBindingDesc{};
+    vertexBindingDesc.binding = 0;
+    vertexBindingDesc.stride = sizeof(Vertex);
+    vertexBindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.vertexBindingDescriptionCount = vertexAttributeDescs.empty() ? 0 : 1;
     vertexInputInfo.pVertexBindingDescriptions = &vertexBindingDesc; // optional
     vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributeDescs.size());
     vertexInputInfo.pVertexAttributeDescriptions = vertexAttributeDescs.data(); // optional
@@ -231,28 +257,17 @@ void VulkanRenderPipeline::createPipeline()
     //> what kind of geometry/topology will be drawn from the vertices
     VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.topology = toVkTopology(desc.topology);
     inputAssembly.primitiveRestartEnable = VK_FALSE; // no need for strips (for example terrain)
 
     // create viewport & scissor
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float) swapChainData.extent.width;
-    viewport.height = (float) swapChainData.extent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = swapChainData.extent;
-
+    //> both are dynamic states set when recording, the pipeline does not depend on the swapchain extent
     VkPipelineViewportStateCreateInfo viewportState{};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
+    viewportState.pViewports = nullptr;
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
+    viewportState.pScissors = nullptr;
 
     // create info: rasterizer
     //> the rasterizer takes the geometry that is shaped by the vertices from the vertex shader
@@ -267,8 +282,8 @@ void VulkanRenderPipeline::createPipeline()
 
     rasterizer.lineWidth = 1.0f;
 
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.cullMode = toVkCullMode(desc.cullMode);
+    rasterizer.frontFace = desc.isFrontFaceClockwise ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
     rasterizer.depthBiasEnable = VK_FALSE;
     rasterizer.depthBiasConstantFactor = 0.0f; // optional
@@ -287,8 +302,15 @@ void VulkanRenderPipeline::createPipeline()
     multisampling.alphaToOneEnable = VK_FALSE; // optional
 
     // create info: depth and stencil testing
-    // todo
-    //> for now pass a nullptr to be disabled
+    //> reverse-z: the depth buffer is cleared to 0 (far), nearer fragments have greater depth
+    //> compare op and writes are dynamic, the static values are used by the depth only variant
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = VK_TRUE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_GREATER;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
 
     // create color blend attachment state
     //> contains the configuration per attached framebuffer
@@ -302,9 +324,9 @@ void VulkanRenderPipeline::createPipeline()
 
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_TRUE;
+    colorBlendAttachment.blendEnable = desc.blendMode != BlendMode::Opaque;
     colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = desc.blendMode == BlendMode::Additive ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
     colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
     colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
@@ -324,24 +346,6 @@ void VulkanRenderPipeline::createPipeline()
     colorBlending.blendConstants[2] = 0.0f; // optional
     colorBlending.blendConstants[3] = 0.0f; // optional
 
-    // create descriptor set layout
-    createDescriptorSetLayout();
-
-    // create info: pipeline layout
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &this->vkDescriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 0; // optional
-    pipelineLayoutInfo.pPushConstantRanges = nullptr; // optional
-
-    VkResult resultPipelineLayout = vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, nullptr, &vkPipelineLayout);
-    if (resultPipelineLayout != VK_SUCCESS)
-    {
-        std::cout <<"error: vulkan: failed to create pipeline layout!";
-        return;
-    }
-
     // create info: graphics pipeline
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -353,91 +357,205 @@ void VulkanRenderPipeline::createPipeline()
     pipelineInfo.pViewportState = &viewportState;
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = nullptr; // optional
+    pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = &dynamicState;
 
-    pipelineInfo.layout = vkPipelineLayout;
+    pipelineInfo.layout = result.layout;
 
-    pipelineInfo.renderPass = vkRenderPass;
+    // create info: rendering
+    //> dynamic rendering: the pipeline is compatible with every rendering using the same attachment formats,
+    //> there is no render pass object and no framebuffer tied to the swapchain images
+    VkPipelineRenderingCreateInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &colorFormat;
+    renderingInfo.depthAttachmentFormat = depthFormat;
+    renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+    pipelineInfo.renderPass = VK_NULL_HANDLE;
     pipelineInfo.subpass = 0;
 
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // optional: inherit from other pipelines (can be faster)
     pipelineInfo.basePipelineIndex = -1; // optional
 
+    // pipeline cache
+    //> pipelines compiled by an earlier run are loaded from the cache instead of compiled again
+    VulkanPipelineCache::CreationFeedback feedback{};
+    pipelineInfo.pNext = pPipelineCache->BeginFeedback(feedback, &renderingInfo);
+
     // info: it is designed to take multiple VkGraphicsPipelineCreateInfo objects and create multiple VkPipeline objects in a single call
-    VkResult resultPipeline = vkCreateGraphicsPipelines(vkDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &vkPipeline);
-    if (resultPipeline != VK_SUCCESS)
+    VkResult resultPipeline = vkCreateGraphicsPipelines(vkDevice, pPipelineCache->GetCache(), 1, &pipelineInfo, nullptr, &result.pipeline);
+    if (resultPipeline == VK_SUCCESS)
+        pPipelineCache->EndFeedback(fmt::format("{} + {}", desc.vertexShader, desc.fragmentShader).c_str(), feedback);
+
+    // create depth only variant
+    //> opaque draws write the depth of the frame in the prepass, the main pass then shades only the visible fragment
+    //> blended draws are not in the prepass, they test against its depth in the main pass
+    //> vertex stage only, no color attachment: the rasterizer writes depth without running fragment shaders
+    result.isOpaque = desc.blendMode == BlendMode::Opaque;
+    if (resultPipeline == VK_SUCCESS && result.isOpaque)
     {
-        std::cout << "error: vulkan: failed to create pipeline!";
-        return;
+        dynamicState.dynamicStateCount = 2; // viewport and scissor, depth state is static
+
+        VkPipelineColorBlendStateCreateInfo depthColorBlending{};
+        depthColorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        depthColorBlending.attachmentCount = 0;
+
+        VkPipelineRenderingCreateInfo depthRenderingInfo = renderingInfo;
+        depthRenderingInfo.colorAttachmentCount = 0;
+        depthRenderingInfo.pColorAttachmentFormats = nullptr;
+
+        pipelineInfo.stageCount = 1;
+        pipelineInfo.pColorBlendState = &depthColorBlending;
+        pipelineInfo.pNext = pPipelineCache->BeginFeedback(feedback, &depthRenderingInfo);
+
+        resultPipeline = vkCreateGraphicsPipelines(vkDevice, pPipelineCache->GetCache(), 1, &pipelineInfo, nullptr, &result.depthPipeline);
+        if (resultPipeline == VK_SUCCESS)
+            pPipelineCache->EndFeedback(fmt::format("{} (depth only)", desc.vertexShader).c_str(), feedback);
     }
 
     // cleanup shaders
     vkDestroyShaderModule(vkDevice, shaderModuleVert, nullptr);
     vkDestroyShaderModule(vkDevice, shaderModuleFrag, nullptr);
+
+    if (resultPipeline != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create pipeline!";
+        DestroyPipeline(result);
+        return false;
+    }
+
+    compiled = result;
+    return true;
+}
+
+/// @brief destroys the pipeline and its depth only variant, the layout belongs to the layout cache
+void VulkanRenderPipeline::DestroyPipeline(const CompiledPipeline& compiled) const
+{
+    if (compiled.pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(vkDevice, compiled.pipeline, nullptr);
+    if (compiled.depthPipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(vkDevice, compiled.depthPipeline, nullptr);
+}
+
+/// @brief reads a spir-v file from the shader assets and reflects its interface
+/// @return false when the file is missing, not spir-v or not of the expected stage
+bool VulkanRenderPipeline::readShader(const std::string& name, VkShaderStageFlagBits stage, std::vector<char>& code, ShaderReflection& reflection) const
+{
+    std::string path = fmt::format("{}/shaders/{}", Application::AssetsPath, name);
+    if(!FileUtility::ReadBinaryFile(path, code))
+    {
+        std::cout << "error: vulkan: failed to read shader " << path << "!";
+        return false;
+    }
+
+    if(!layoutCache.Reflect(code, reflection))
+    {
+        std::cout << "error: vulkan: failed to reflect shader " << path << "!";
+        return false;
+    }
+
+    if(reflection.stage != stage)
+    {
+        std::cout << "error: vulkan: shader " << path << " has the wrong stage!";
+        return false;
+    }
+    return true;
 }
 
-void VulkanRenderPipeline::createFramebuffers()
+/// @brief Gets the pipeline layout of the shader pair from the layout cache.
+/// @brief Set 0 is always the frame set, the shaders may use any subset of its bindings. Further sets and the push
+/// @brief constant range come from reflection. Draw constants are pushed at offset 0, vertices come from one Vertex buffer.
+/// @return false when the shaders do not fit the frame set, the draw constants or the vertex format
+bool VulkanRenderPipeline::createPipelineLayout(
+    const PipelineDesc& desc,
+    const ShaderReflection& reflectionVert,
+    const ShaderReflection& reflectionFrag,
+    CompiledPipeline& compiled) const
 {
-    // set size of frame buffers
-    swapChainFramebuffers.resize(swapChainImageViews.size());
+    std::string name = fmt::format("{} + {}", desc.vertexShader, desc.fragmentShader);
 
-    // loop over ALL swap chain image views
-    for (size_t i = 0; i < swapChainImageViews.size(); i++)
+    ShaderLayout layout;
+    if(!VulkanShaderReflection::Merge({ &reflectionVert, &reflectionFrag }, layout))
+        return false;
+
+    // descriptor set layouts
+    // >> set 0: frame set, every binding must exist there with the same type and count and be visible to the stages
+    std::vector<VkDescriptorSetLayout> setLayouts = { vkDescriptorSetLayout };
+    if(!layout.sets.empty())
     {
-        VkImageView attachments[] =
+        for(const auto& binding : layout.sets[0])
         {
-            swapChainImageViews[i]
-        };
-
-        // create info: frame buffer
-        //> you can only use a framebuffer with the render passes that it is compatible with
-        //> which roughly means that they use the same number and type of attachments
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = vkRenderPass;
-        framebufferInfo.attachmentCount = 1;
-        framebufferInfo.pAttachments = attachments;
-        framebufferInfo.width = swapChainData.extent.width;
-        framebufferInfo.height = swapChainData.extent.height;
-        framebufferInfo.layers = 1;
-
-        // create frame buffer
-        VkResult resultFrameBuffer = vkCreateFramebuffer(vkDevice, &framebufferInfo, nullptr, &swapChainFramebuffers[i]);
-        if (resultFrameBuffer != VK_SUCCESS)
+            auto it = std::find_if(frameSetBindings.begin(), frameSetBindings.end(), [&binding](const VkDescriptorSetLayoutBinding& frameBinding)
+            {
+                return frameBinding.binding == binding.binding;
+            });
+
+            VkDescriptorType frameType = binding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : binding.descriptorType;
+            if(it == frameSetBindings.end() || it->descriptorType != frameType || it->descriptorCount != binding.descriptorCount ||
+               (it->stageFlags & binding.stageFlags) != binding.stageFlags)
+            {
+                std::cout << "error: vulkan: " << name << ": set 0 binding " << binding.binding << " does not match the frame set!";
+                return false;
+            }
+        }
+    }
+    for(size_t set = 1; set < layout.sets.size(); ++set)
+    {
+        VkDescriptorSetLayout setLayout = layoutCache.GetDescriptorSetLayout(layout.sets[set]);
+        if(setLayout == VK_NULL_HANDLE)
+            return false;
+        setLayouts.push_back(setLayout);
+    }
+
+    // push constants
+    // >> draw constants are pushed from offset 0, the block may read a prefix of them
+    if(!layout.pushConstantRanges.empty())
+    {
+        const VkPushConstantRange& range = layout.pushConstantRanges[0];
+        if(range.offset != 0)
         {
-            std::cout <<"error: vulkan: failed to create framebuffer!";
-            return;
+            std::cout << "error: vulkan: " << name << ": push constant block must start at offset 0!";
+            return false;
         }
+        compiled.pushConstantStages = range.stageFlags;
+        compiled.pushConstantSize = std::min<uint32_t>(range.size, sizeof(DrawConstants));
     }
+
+    compiled.layout = layoutCache.GetPipelineLayout(setLayouts, layout.pushConstantRanges);
+    return compiled.layout != VK_NULL_HANDLE;
 }
 
-void VulkanRenderPipeline::createDescriptorSetLayout()
+/// @brief Places the reflected vertex inputs at the offsets of their Vertex members.
+/// @return false when an input has no member at its location or a different format
+bool VulkanRenderPipeline::createVertexAttributes(
+    const PipelineDesc& desc,
+    const ShaderReflection& reflectionVert,
+    std::vector<VkVertexInputAttributeDescription>& attributes) const
 {
-    // create descriptor set layout binding: uniform buffer
-    VkDescriptorSetLayoutBinding dslBinding{};
-    dslBinding.binding = 0; // binding index in the shader
-    dslBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    dslBinding.descriptorCount = 1;
-    dslBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT; // we're only referencing the descriptor from the vertex shader
-    dslBinding.pImmutableSamplers = nullptr; // optional, only relevant for image sampling related descriptors
-
-    // create descriptor set layout
-    VkDescriptorSetLayoutCreateInfo dslInfo{};
-    dslInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    dslInfo.bindingCount = 1;
-    dslInfo.pBindings = &dslBinding;
-
-    VkResult result = vkCreateDescriptorSetLayout(this->vkDevice, &dslInfo, nullptr, &this->vkDescriptorSetLayout);
-    if(result != VK_SUCCESS)
+    attributes.clear();
+    for(const auto& input : reflectionVert.vertexAttributes)
     {
-        std::cout <<"error: vulkan: failed to create descriptor set layout!";
-        return;
+        auto it = std::find_if(std::begin(VERTEX_MEMBERS), std::end(VERTEX_MEMBERS), [&input](const VertexMember& member)
+        {
+            return member.location == input.location;
+        });
+        if(it == std::end(VERTEX_MEMBERS) || it->format != input.format)
+        {
+            std::cout << "error: vulkan: " << desc.vertexShader << ": vertex input at location " << input.location << " does not match the vertex layout!";
+            return false;
+        }
+
+        VkVertexInputAttributeDescription attribute = input;
+        attribute.binding = 0;
+        attribute.offset = it->offset;
+        attributes.push_back(attribute);
     }
+    return true;
 }
 
-bool VulkanRenderPipeline::createShaderModule(const std::vector<char>& code, VkShaderModule& shaderModule)
+bool VulkanRenderPipeline::createShaderModule(const std::vector<char>& code, VkShaderModule& shaderModule) const
 {
     // create shader create info
     VkShaderModuleCreateInfo createInfo{};
@@ -1,8 +1,24 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include <vulkan/vulkan_core.h>
 #include "vk_swapchain.h"
+#include "arctic/graphics/rhi/pipeline_desc.h"
+#include "vk_layout_cache.h"
+
+class VulkanPipelineCache;
+
+// pipeline and the layout it was created with
+struct CompiledPipeline
+{
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkPipeline depthPipeline = VK_NULL_HANDLE; // depth only variant for the depth prepass, opaque pipelines only
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    bool isOpaque = true;
+    VkShaderStageFlags pushConstantStages = 0; // 0 when the shaders read no push constants
+    uint32_t pushConstantSize = 0;
+};
 
 class VulkanRenderPipeline
 {
@@ -10,41 +26,59 @@ public:
   VulkanRenderPipeline(
     const VkDevice& device,
     uint32_t graphicsFamilyIndex,
-    uint32_t transferFamilyIndex); 
+    uint32_t transferFamilyIndex,
+    std::shared_ptr<VulkanPipelineCache> pipelineCache); 
 
-  void Load(
-    const SwapChainData& swapChainData, 
-    const std::vector<VkImageView>& swapChainImageViews);
+  // creates the layouts and the default pipeline for the image format of the swapchain
+  // >> dynamic rendering: resizes keep every pipeline, only a format change needs new ones
+  void Load(const SwapChainData& swapChainData);
 
   void CleanUp();
 
+  // creates a pipeline for the color and depth format, the layout is reflected from the shaders
+  // >> safe to call from worker threads
+  bool CreatePipeline(const PipelineDesc& desc, CompiledPipeline& compiled) const;
+  void DestroyPipeline(const CompiledPipeline& compiled) const;
+
   uint32_t GetGraphicsFamilyIndex();
   uint32_t GetTransferFamilyIndex();
-  const VkRenderPass& GetRenderPass();
+  VkFormat GetColorFormat() const;
+  VkFormat GetDepthFormat() const;
   const VkPipeline& GetPipeline();
   const VkPipelineLayout& GetPipelineLayout();
   const VkDescriptorSetLayout& GetDescriptorSetLayout();
-  const VkFramebuffer& GetFrameBuffer(uint32_t index);
+  const CompiledPipeline& GetDefaultPipeline() const;
 
 private:
     VkDevice vkDevice = VK_NULL_HANDLE;
     uint32_t graphicsFamilyIndex;
     uint32_t transferFamilyIndex;
+    std::shared_ptr<VulkanPipelineCache> pPipelineCache;
 
-    SwapChainData swapChainData;
-    std::vector<VkImageView> swapChainImageViews;
-    std::vector<VkFramebuffer> swapChainFramebuffers;
+    // attachment formats the pipelines render to
+    // >> depth is reverse-z: float precision is spent where the projection compresses depth the most (far away)
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat = VK_FORMAT_D32_SFLOAT; // depth attachment support is required for this format
 
-    VkRenderPass vkRenderPass;
-    VkDescriptorSetLayout vkDescriptorSetLayout;
-    VkPipelineLayout vkPipelineLayout;
-    VkPipeline vkPipeline;
+    // layouts
+    // >> reflected from the shaders and shared through the cache, set 0 (frame set) is the same for every pipeline
+    mutable VulkanLayoutCache layoutCache;
+    std::vector<VkDescriptorSetLayoutBinding> frameSetBindings;
+    VkDescriptorSetLayout vkDescriptorSetLayout = VK_NULL_HANDLE;
 
-    void createRenderPass();
-    void createPipeline();
-    void createFramebuffers();
+    CompiledPipeline defaultPipeline;
 
-    void createDescriptorSetLayout();
+    void createPipeline();
 
-    bool createShaderModule(const std::vector<char>& code, VkShaderModule& shaderModule);
+    bool readShader(const std::string& name, VkShaderStageFlagBits stage, std::vector<char>& code, ShaderReflection& reflection) const;
+    bool createPipelineLayout(
+      const PipelineDesc& desc,
+      const ShaderReflection& reflectionVert,
+      const ShaderReflection& reflectionFrag,
+      CompiledPipeline& compiled) const;
+    bool createVertexAttributes(
+      const PipelineDesc& desc,
+      const ShaderReflection& reflectionVert,
+      std::vector<VkVertexInputAttributeDescription>& attributes) const;
+    bool createShaderModule(const std::vector<char>& code, VkShaderModule& shaderModule) const;
 };
\ No newline at end of file
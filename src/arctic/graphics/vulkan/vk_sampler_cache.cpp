@@ -0,0 +1,103 @@
+#include "vk_sampler_cache.h"
+#include "vk_memory_handler.h"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+static VkFilter toVkFilter(SamplerFilter filter)
+{
+    return filter == SamplerFilter::Nearest ? VK_FILTER_NEAREST : VK_FILTER_LINEAR;
+}
+
+static VkSamplerMipmapMode toVkMipmapMode(SamplerFilter filter)
+{
+    return filter == SamplerFilter::Nearest ? VK_SAMPLER_MIPMAP_MODE_NEAREST : VK_SAMPLER_MIPMAP_MODE_LINEAR;
+}
+
+static VkSamplerAddressMode toVkAddressMode(SamplerAddressMode addressMode)
+{
+    switch(addressMode)
+    {
+        case SamplerAddressMode::MirroredRepeat: return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+        case SamplerAddressMode::ClampToEdge: return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        default: return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    }
+}
+
+/// @brief reads the anisotropy support of the device
+/// @return true when creation was successful
+bool VulkanSamplerCache::Create(VkDevice vkDevice, std::shared_ptr<VulkanMemoryHandler> memoryHandler)
+{
+    this->vkDevice = vkDevice;
+
+    // anisotropy is enabled on device creation when the device supports it
+    VkPhysicalDeviceFeatures features{};
+    vkGetPhysicalDeviceFeatures(memoryHandler->GetPhysicalDevice(), &features);
+    this->isAnisotropySupported = features.samplerAnisotropy == VK_TRUE;
+    this->maxDeviceAnisotropy = memoryHandler->GetPhysicalDeviceProperties().limits.maxSamplerAnisotropy;
+    return true;
+}
+
+void VulkanSamplerCache::CleanUp()
+{
+    for(auto& [desc, sampler] : samplers)
+        vkDestroySampler(vkDevice, sampler, nullptr);
+    samplers.clear();
+}
+
+/// @brief returns the sampler of the description, creates it on first use
+/// @return VK_NULL_HANDLE when the sampler could not be created
+VkSampler VulkanSamplerCache::GetSampler(const SamplerDesc& desc)
+{
+    auto it = samplers.find(desc);
+    if(it != samplers.end())
+        return it->second;
+
+    // create info: sampler
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = toVkFilter(desc.filter);
+    samplerInfo.minFilter = toVkFilter(desc.filter);
+    samplerInfo.mipmapMode = toVkMipmapMode(desc.mipFilter);
+    samplerInfo.addressModeU = toVkAddressMode(desc.addressMode);
+    samplerInfo.addressModeV = toVkAddressMode(desc.addressMode);
+    samplerInfo.addressModeW = toVkAddressMode(desc.addressMode);
+    samplerInfo.mipLodBias = desc.mipLodBias;
+    samplerInfo.minLod = desc.minLod;
+    samplerInfo.maxLod = desc.maxLod;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+
+    // >> anisotropic filtering: sharper minification at grazing angles, picks the mip from the shorter axis of the footprint
+    float maxAnisotropy = std::min(desc.maxAnisotropy, maxDeviceAnisotropy);
+    samplerInfo.anisotropyEnable = isAnisotropySupported && maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+    samplerInfo.maxAnisotropy = samplerInfo.anisotropyEnable ? maxAnisotropy : 1.0f;
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    VkResult result = vkCreateSampler(vkDevice, &samplerInfo, nullptr, &sampler);
+    if(result != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create texture sampler!";
+        return VK_NULL_HANDLE;
+    }
+
+    samplers.emplace(desc, sampler);
+    return sampler;
+}
+
+size_t VulkanSamplerCache::SamplerDescHash::operator()(const SamplerDesc& desc) const
+{
+    size_t hash = 0;
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+    combine(static_cast<size_t>(desc.filter));
+    combine(static_cast<size_t>(desc.mipFilter));
+    combine(static_cast<size_t>(desc.addressMode));
+    combine(std::hash<float>()(desc.maxAnisotropy));
+    combine(std::hash<float>()(desc.mipLodBias));
+    combine(std::hash<float>()(desc.minLod));
+    combine(std::hash<float>()(desc.maxLod));
+    return hash;
+}
\ No newline at end of file
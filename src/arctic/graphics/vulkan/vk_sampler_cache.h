@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vulkan/vulkan_core.h>
+#include "arctic/graphics/rhi/sampler_desc.h"
+
+class VulkanMemoryHandler;
+
+/// @brief Creates samplers on demand and shares them between all textures with the same SamplerDesc.
+/// @brief Anisotropy is clamped to the device limit and disabled when the device does not support it.
+class VulkanSamplerCache
+{
+public:
+    bool Create(VkDevice vkDevice, std::shared_ptr<VulkanMemoryHandler> memoryHandler);
+    void CleanUp();
+
+    VkSampler GetSampler(const SamplerDesc& desc);
+
+private:
+    struct SamplerDescHash
+    {
+        size_t operator()(const SamplerDesc& desc) const;
+    };
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+
+    bool isAnisotropySupported = false;
+    float maxDeviceAnisotropy = 1.0f;
+
+    std::unordered_map<SamplerDesc, VkSampler, SamplerDescHash> samplers;
+};
\ No newline at end of file
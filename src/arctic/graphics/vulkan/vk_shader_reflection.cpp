@@ -0,0 +1,544 @@
+#include "vk_shader_reflection.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+// spir-v enumerants used by the parser, see the spir-v specification (section 3)
+static const uint32_t SPV_MAGIC = 0x07230203;
+static const uint32_t SPV_HEADER_WORDS = 5;
+
+enum SpvOp : uint32_t
+{
+    SpvOpEntryPoint = 15,
+    SpvOpTypeBool = 20,
+    SpvOpTypeInt = 21,
+    SpvOpTypeFloat = 22,
+    SpvOpTypeVector = 23,
+    SpvOpTypeMatrix = 24,
+    SpvOpTypeImage = 25,
+    SpvOpTypeSampler = 26,
+    SpvOpTypeSampledImage = 27,
+    SpvOpTypeArray = 28,
+    SpvOpTypeRuntimeArray = 29,
+    SpvOpTypeStruct = 30,
+    SpvOpTypePointer = 32,
+    SpvOpConstant = 43,
+    SpvOpSpecConstant = 50,
+    SpvOpVariable = 59,
+    SpvOpDecorate = 71,
+    SpvOpMemberDecorate = 72,
+    SpvOpTypeAccelerationStructure = 5341
+};
+
+enum SpvDecoration : uint32_t
+{
+    SpvDecorationBlock = 2,
+    SpvDecorationBufferBlock = 3,
+    SpvDecorationArrayStride = 6,
+    SpvDecorationMatrixStride = 7,
+    SpvDecorationBuiltIn = 11,
+    SpvDecorationLocation = 30,
+    SpvDecorationBinding = 33,
+    SpvDecorationDescriptorSet = 34,
+    SpvDecorationOffset = 35
+};
+
+enum SpvStorageClass : uint32_t
+{
+    SpvStorageClassUniformConstant = 0,
+    SpvStorageClassInput = 1,
+    SpvStorageClassUniform = 2,
+    SpvStorageClassPushConstant = 9,
+    SpvStorageClassStorageBuffer = 12
+};
+
+static const uint32_t SPV_DIM_BUFFER = 5;
+static const uint32_t SPV_DIM_SUBPASS_DATA = 6;
+static const uint32_t SPV_IMAGE_SAMPLED_STORAGE = 2; // "sampled" operand of OpTypeImage: 1 sampled, 2 storage
+
+struct SpvDecorations
+{
+    bool isBlock = false;
+    bool isBufferBlock = false;
+    bool isBuiltIn = false;
+    bool hasBinding = false;
+    bool hasLocation = false;
+    uint32_t set = 0;
+    uint32_t binding = 0;
+    uint32_t location = 0;
+    uint32_t arrayStride = 0;
+};
+
+struct SpvMember
+{
+    uint32_t offset = 0;
+    uint32_t matrixStride = 0;
+    bool isBuiltIn = false;
+};
+
+struct SpvType
+{
+    uint32_t opcode = 0;
+    std::vector<uint32_t> operands; // words after the result id
+};
+
+struct SpvVariable
+{
+    uint32_t id = 0;
+    uint32_t pointerTypeId = 0;
+    uint32_t storageClass = 0;
+};
+
+// interface declarations of a module
+struct SpvModule
+{
+    uint32_t executionModel = UINT32_MAX;
+    std::string entryPoint;
+
+    std::unordered_map<uint32_t, SpvType> types;
+    std::unordered_map<uint32_t, uint32_t> constants; // low word of integer constants (array lengths)
+    std::unordered_map<uint32_t, SpvDecorations> decorations;
+    std::unordered_map<uint32_t, std::vector<SpvMember>> members;
+    std::vector<SpvVariable> variables;
+
+    const SpvType* GetType(uint32_t id) const
+    {
+        auto it = types.find(id);
+        return it != types.end() ? &it->second : nullptr;
+    }
+
+    SpvDecorations GetDecorations(uint32_t id) const
+    {
+        auto it = decorations.find(id);
+        return it != decorations.end() ? it->second : SpvDecorations{};
+    }
+};
+
+static bool parseModule(const std::vector<uint32_t>& words, SpvModule& module)
+{
+    size_t position = SPV_HEADER_WORDS;
+    while(position < words.size())
+    {
+        uint32_t wordCount = words[position] >> 16;
+        uint32_t opcode = words[position] & 0xffff;
+        if(wordCount == 0 || position + wordCount > words.size())
+        {
+            std::cout << "error: vulkan: reflection: malformed spir-v instruction!";
+            return false;
+        }
+        const uint32_t* pOperands = &words[position + 1];
+        uint32_t operandCount = wordCount - 1;
+
+        switch(opcode)
+        {
+            case SpvOpEntryPoint:
+            {
+                // >> execution model, function id, literal name
+                if(module.executionModel == UINT32_MAX && operandCount >= 3)
+                {
+                    module.executionModel = pOperands[0];
+                    const char* pName = reinterpret_cast<const char*>(pOperands + 2);
+                    module.entryPoint.assign(pName, strnlen(pName, (operandCount - 2) * sizeof(uint32_t)));
+                }
+                break;
+            }
+            case SpvOpDecorate:
+            {
+                if(operandCount < 2)
+                    break;
+                SpvDecorations& decoration = module.decorations[pOperands[0]];
+                uint32_t value = operandCount >= 3 ? pOperands[2] : 0;
+                switch(pOperands[1])
+                {
+                    case SpvDecorationBlock: decoration.isBlock = true; break;
+                    case SpvDecorationBufferBlock: decoration.isBufferBlock = true; break;
+                    case SpvDecorationBuiltIn: decoration.isBuiltIn = true; break;
+                    case SpvDecorationArrayStride: decoration.arrayStride = value; break;
+                    case SpvDecorationDescriptorSet: decoration.set = value; break;
+                    case SpvDecorationBinding: decoration.binding = value; decoration.hasBinding = true; break;
+                    case SpvDecorationLocation: decoration.location = value; decoration.hasLocation = true; break;
+                    default: break;
+                }
+                break;
+            }
+            case SpvOpMemberDecorate:
+            {
+                if(operandCount < 3)
+                    break;
+                std::vector<SpvMember>& structMembers = module.members[pOperands[0]];
+                if(structMembers.size() <= pOperands[1])
+                    structMembers.resize(pOperands[1] + 1);
+                SpvMember& member = structMembers[pOperands[1]];
+                uint32_t value = operandCount >= 4 ? pOperands[3] : 0;
+                switch(pOperands[2])
+                {
+                    case SpvDecorationOffset: member.offset = value; break;
+                    case SpvDecorationMatrixStride: member.matrixStride = value; break;
+                    case SpvDecorationBuiltIn: member.isBuiltIn = true; break;
+                    default: break;
+                }
+                break;
+            }
+            case SpvOpTypeBool:
+            case SpvOpTypeInt:
+            case SpvOpTypeFloat:
+            case SpvOpTypeVector:
+            case SpvOpTypeMatrix:
+            case SpvOpTypeImage:
+            case SpvOpTypeSampler:
+            case SpvOpTypeSampledImage:
+            case SpvOpTypeArray:
+            case SpvOpTypeRuntimeArray:
+            case SpvOpTypeStruct:
+            case SpvOpTypePointer:
+            case SpvOpTypeAccelerationStructure:
+            {
+                if(operandCount < 1)
+                    break;
+                SpvType type{};
+                type.opcode = opcode;
+                type.operands.assign(pOperands + 1, pOperands + operandCount);
+                module.types[pOperands[0]] = std::move(type);
+                break;
+            }
+            case SpvOpConstant:
+            case SpvOpSpecConstant:
+            {
+                // >> result type, result id, value (spec constants: default value)
+                if(operandCount >= 3)
+                    module.constants[pOperands[1]] = pOperands[2];
+                break;
+            }
+            case SpvOpVariable:
+            {
+                // >> result type, result id, storage class
+                if(operandCount >= 3)
+                    module.variables.push_back({ pOperands[1], pOperands[0], pOperands[2] });
+                break;
+            }
+            default:
+                break;
+        }
+        position += wordCount;
+    }
+    return true;
+}
+
+static bool toShaderStage(uint32_t executionModel, VkShaderStageFlagBits& stage)
+{
+    switch(executionModel)
+    {
+        case 0: stage = VK_SHADER_STAGE_VERTEX_BIT; return true;
+        case 1: stage = VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT; return true;
+        case 2: stage = VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT; return true;
+        case 3: stage = VK_SHADER_STAGE_GEOMETRY_BIT; return true;
+        case 4: stage = VK_SHADER_STAGE_FRAGMENT_BIT; return true;
+        case 5: stage = VK_SHADER_STAGE_COMPUTE_BIT; return true;
+        default: return false;
+    }
+}
+
+/// @brief byte size of a type inside a buffer block, strides come from the layout decorations
+static uint32_t getTypeSize(const SpvModule& module, uint32_t typeId, uint32_t matrixStride = 0)
+{
+    const SpvType* pType = module.GetType(typeId);
+    if(!pType)
+        return 0;
+
+    switch(pType->opcode)
+    {
+        case SpvOpTypeBool:
+            return 4;
+        case SpvOpTypeInt:
+        case SpvOpTypeFloat:
+            return pType->operands[0] / 8;
+        case SpvOpTypeVector:
+            return pType->operands[1] * getTypeSize(module, pType->operands[0]);
+        case SpvOpTypeMatrix:
+            return pType->operands[1] * (matrixStride > 0 ? matrixStride : getTypeSize(module, pType->operands[0]));
+        case SpvOpTypeArray:
+        {
+            auto length = module.constants.find(pType->operands[1]);
+            uint32_t count = length != module.constants.end() ? length->second : 0;
+            uint32_t stride = module.GetDecorations(typeId).arrayStride;
+            return count * (stride > 0 ? stride : getTypeSize(module, pType->operands[0], matrixStride));
+        }
+        case SpvOpTypeStruct:
+        {
+            auto it = module.members.find(typeId);
+            uint32_t size = 0;
+            for(size_t i = 0; i < pType->operands.size(); ++i)
+            {
+                SpvMember member = (it != module.members.end() && i < it->second.size()) ? it->second[i] : SpvMember{};
+                size = std::max(size, member.offset + getTypeSize(module, pType->operands[i], member.matrixStride));
+            }
+            return size;
+        }
+        default:
+            return 0;
+    }
+}
+
+/// @brief vertex attribute format of a scalar or vector input
+static VkFormat getVertexFormat(const SpvModule& module, uint32_t typeId)
+{
+    const SpvType* pType = module.GetType(typeId);
+    if(!pType)
+        return VK_FORMAT_UNDEFINED;
+
+    uint32_t componentCount = 1;
+    if(pType->opcode == SpvOpTypeVector)
+    {
+        componentCount = pType->operands[1];
+        pType = module.GetType(pType->operands[0]);
+        if(!pType)
+            return VK_FORMAT_UNDEFINED;
+    }
+    if(componentCount < 1 || componentCount > 4 || pType->operands.empty() || pType->operands[0] != 32)
+        return VK_FORMAT_UNDEFINED;
+
+    static const VkFormat FLOAT_FORMATS[] = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+    static const VkFormat SINT_FORMATS[] = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+    static const VkFormat UINT_FORMATS[] = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+    if(pType->opcode == SpvOpTypeFloat)
+        return FLOAT_FORMATS[componentCount - 1];
+    if(pType->opcode == SpvOpTypeInt)
+        return (pType->operands.size() > 1 && pType->operands[1] != 0) ? SINT_FORMATS[componentCount - 1] : UINT_FORMATS[componentCount - 1];
+    return VK_FORMAT_UNDEFINED;
+}
+
+/// @brief descriptor type and count of a resource variable, arrays of resources multiply the count
+static bool getDescriptorType(const SpvModule& module, const SpvVariable& variable, uint32_t pointeeId, VkDescriptorType& descriptorType, uint32_t& count)
+{
+    count = 1;
+    uint32_t typeId = pointeeId;
+    const SpvType* pType = module.GetType(typeId);
+    while(pType && (pType->opcode == SpvOpTypeArray || pType->opcode == SpvOpTypeRuntimeArray))
+    {
+        if(pType->opcode == SpvOpTypeRuntimeArray)
+        {
+            std::cout << "error: vulkan: reflection: runtime descriptor arrays are not supported!";
+            return false;
+        }
+        auto length = module.constants.find(pType->operands[1]);
+        count *= length != module.constants.end() ? length->second : 1;
+        typeId = pType->operands[0];
+        pType = module.GetType(typeId);
+    }
+    if(!pType)
+        return false;
+
+    switch(pType->opcode)
+    {
+        case SpvOpTypeSampledImage:
+            descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            return true;
+        case SpvOpTypeSampler:
+            descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+            return true;
+        case SpvOpTypeImage:
+        {
+            // >> sampled type, dim, depth, arrayed, multisampled, sampled, format
+            uint32_t dim = pType->operands[1];
+            bool isStorage = pType->operands[5] == SPV_IMAGE_SAMPLED_STORAGE;
+            if(dim == SPV_DIM_SUBPASS_DATA)
+                descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            else if(dim == SPV_DIM_BUFFER)
+                descriptorType = isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+            else
+                descriptorType = isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            return true;
+        }
+        case SpvOpTypeStruct:
+        {
+            // >> BufferBlock: storage buffer of spir-v 1.0-1.2, later versions use the StorageBuffer storage class
+            SpvDecorations decorations = module.GetDecorations(typeId);
+            bool isStorage = variable.storageClass == SpvStorageClassStorageBuffer || decorations.isBufferBlock;
+            descriptorType = isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            return true;
+        }
+        case SpvOpTypeAccelerationStructure:
+            descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// @brief reflects the first entry point of the module
+/// @return false when the code is not valid spir-v or uses unsupported resources
+bool VulkanShaderReflection::Reflect(const std::vector<char>& code, ShaderReflection& reflection)
+{
+    if(code.size() < SPV_HEADER_WORDS * sizeof(uint32_t) || code.size() % sizeof(uint32_t) != 0)
+    {
+        std::cout << "error: vulkan: reflection: code is not spir-v!";
+        return false;
+    }
+
+    // copy into words, the file buffer is not guaranteed to be aligned
+    std::vector<uint32_t> words(code.size() / sizeof(uint32_t));
+    memcpy(words.data(), code.data(), code.size());
+    if(words[0] != SPV_MAGIC)
+    {
+        std::cout << "error: vulkan: reflection: code is not little endian spir-v!";
+        return false;
+    }
+
+    SpvModule module{};
+    if(!parseModule(words, module))
+        return false;
+
+    reflection = ShaderReflection{};
+    if(!toShaderStage(module.executionModel, reflection.stage))
+    {
+        std::cout << "error: vulkan: reflection: no supported entry point!";
+        return false;
+    }
+    reflection.entryPoint = module.entryPoint;
+
+    for(const auto& variable : module.variables)
+    {
+        const SpvType* pPointer = module.GetType(variable.pointerTypeId);
+        if(!pPointer || pPointer->opcode != SpvOpTypePointer || pPointer->operands.size() < 2)
+            continue;
+        uint32_t pointeeId = pPointer->operands[1];
+        SpvDecorations decorations = module.GetDecorations(variable.id);
+
+        switch(variable.storageClass)
+        {
+            case SpvStorageClassUniformConstant:
+            case SpvStorageClassUniform:
+            case SpvStorageClassStorageBuffer:
+            {
+                ReflectedBinding reflected{};
+                if(!decorations.hasBinding || !getDescriptorType(module, variable, pointeeId, reflected.binding.descriptorType, reflected.binding.descriptorCount))
+                    continue;
+
+                reflected.set = decorations.set;
+                reflected.binding.binding = decorations.binding;
+                reflected.binding.stageFlags = reflection.stage;
+                reflected.binding.pImmutableSamplers = nullptr;
+                reflection.bindings.push_back(reflected);
+                break;
+            }
+            case SpvStorageClassPushConstant:
+            {
+                // >> range from the first to the end of the last member
+                const SpvType* pBlock = module.GetType(pointeeId);
+                auto it = module.members.find(pointeeId);
+                if(!pBlock || pBlock->opcode != SpvOpTypeStruct || it == module.members.end() || it->second.empty())
+                    continue;
+
+                uint32_t begin = UINT32_MAX;
+                for(const auto& member : it->second)
+                    begin = std::min(begin, member.offset);
+
+                reflection.pushConstants.stageFlags = reflection.stage;
+                reflection.pushConstants.offset = begin;
+                reflection.pushConstants.size = getTypeSize(module, pointeeId) - begin;
+                break;
+            }
+            case SpvStorageClassInput:
+            {
+                if(reflection.stage != VK_SHADER_STAGE_VERTEX_BIT || decorations.isBuiltIn || !decorations.hasLocation)
+                    continue;
+
+                // >> matrices take one location per column
+                const SpvType* pType = module.GetType(pointeeId);
+                uint32_t columnTypeId = pointeeId;
+                uint32_t columnCount = 1;
+                if(pType && pType->opcode == SpvOpTypeMatrix)
+                {
+                    columnTypeId = pType->operands[0];
+                    columnCount = pType->operands[1];
+                }
+
+                VkFormat format = getVertexFormat(module, columnTypeId);
+                if(format == VK_FORMAT_UNDEFINED)
+                {
+                    std::cout << "error: vulkan: reflection: unsupported vertex input at location " << decorations.location << "!";
+                    return false;
+                }
+                for(uint32_t column = 0; column < columnCount; ++column)
+                {
+                    VkVertexInputAttributeDescription attribute{};
+                    attribute.location = decorations.location + column;
+                    attribute.format = format;
+                    reflection.vertexAttributes.push_back(attribute);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const ReflectedBinding& a, const ReflectedBinding& b)
+    {
+        return a.set != b.set ? a.set < b.set : a.binding.binding < b.binding.binding;
+    });
+
+    // vertex inputs: sorted by location
+    std::sort(reflection.vertexAttributes.begin(), reflection.vertexAttributes.end(), [](const VkVertexInputAttributeDescription& a, const VkVertexInputAttributeDescription& b)
+    {
+        return a.location < b.location;
+    });
+    return true;
+}
+
+/// @return false when two stages declare the same binding with a different type or count
+bool VulkanShaderReflection::Merge(const std::vector<const ShaderReflection*>& stages, ShaderLayout& layout)
+{
+    layout = ShaderLayout{};
+    VkPushConstantRange pushConstants{};
+    uint32_t pushConstantsEnd = 0;
+
+    for(const ShaderReflection* pStage : stages)
+    {
+        for(const auto& reflected : pStage->bindings)
+        {
+            if(layout.sets.size() <= reflected.set)
+                layout.sets.resize(reflected.set + 1);
+            std::vector<VkDescriptorSetLayoutBinding>& set = layout.sets[reflected.set];
+
+            auto it = std::find_if(set.begin(), set.end(), [&reflected](const VkDescriptorSetLayoutBinding& binding)
+            {
+                return binding.binding == reflected.binding.binding;
+            });
+            if(it == set.end())
+            {
+                set.push_back(reflected.binding);
+                continue;
+            }
+            if(it->descriptorType != reflected.binding.descriptorType || it->descriptorCount != reflected.binding.descriptorCount)
+            {
+                std::cout << "error: vulkan: reflection: stages disagree on set " << reflected.set << " binding " << reflected.binding.binding << "!";
+                return false;
+            }
+            it->stageFlags |= reflected.binding.stageFlags;
+        }
+
+        // push constants: one range visible to every stage using the block
+        if(pStage->pushConstants.size > 0)
+        {
+            pushConstants.offset = pushConstants.stageFlags == 0 ? pStage->pushConstants.offset : std::min(pushConstants.offset, pStage->pushConstants.offset);
+            pushConstants.stageFlags |= pStage->pushConstants.stageFlags;
+            pushConstantsEnd = std::max(pushConstantsEnd, pStage->pushConstants.offset + pStage->pushConstants.size);
+        }
+    }
+
+    for(auto& set : layout.sets)
+    {
+        std::sort(set.begin(), set.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) { return a.binding < b.binding; });
+    }
+
+    if(pushConstants.stageFlags != 0)
+    {
+        pushConstants.size = pushConstantsEnd - pushConstants.offset;
+        layout.pushConstantRanges.push_back(pushConstants);
+    }
+    return true;
+}
\ No newline at end of file
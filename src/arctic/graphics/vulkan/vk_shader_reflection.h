@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+// descriptor binding used by a shader
+struct ReflectedBinding
+{
+    uint32_t set = 0;
+    VkDescriptorSetLayoutBinding binding{};
+};
+
+// interface of one shader stage, read from its spir-v
+struct ShaderReflection
+{
+    VkShaderStageFlagBits stage = VK_SHADER_STAGE_VERTEX_BIT;
+    std::string entryPoint = "main";
+
+    std::vector<ReflectedBinding> bindings;     // sorted by set, then binding
+    VkPushConstantRange pushConstants{};        // size 0 when the stage has no push constant block
+
+    // vertex stage only
+    // >> location and format of the inputs sorted by location, binding and offset are left to the vertex buffer layout
+    std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+};
+
+// interface of all stages of a pipeline
+struct ShaderLayout
+{
+    std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets;   // index is the set number, sets may be empty
+    std::vector<VkPushConstantRange> pushConstantRanges;          // empty or one range covering all stages
+};
+
+/// @brief Reads descriptor bindings, the push constant block and vertex inputs from spir-v modules.
+/// @brief Only the instructions describing the interface are parsed (decorations, types, constants and variables),
+/// @brief function bodies are skipped. Every declared resource is reported, used or not.
+class VulkanShaderReflection
+{
+public:
+    static bool Reflect(const std::vector<char>& code, ShaderReflection& reflection);
+
+    // merges the interfaces of the stages, equal bindings of different stages combine their stage flags
+    static bool Merge(const std::vector<const ShaderReflection*>& stages, ShaderLayout& layout);
+};
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "vk_shader_watcher.h"
+#include "arctic/core/utilities/profiler.h"
+
+#include <sys/inotify.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <spawn.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <vector>
+#include <fmt/core.h>
+
+extern char** environ;
+
+#ifndef ARCTIC_GLSLC_EXECUTABLE
+#define ARCTIC_GLSLC_EXECUTABLE "glslc"
+#endif
+
+/// @brief glsl sources are named <name>.<stage>, their binaries <name>.<stage>.spv (see assets/CMakeLists.txt)
+static bool isShaderSource(const std::string& name)
+{
+    std::string extension = std::filesystem::path(name).extension().string();
+    return extension == ".vert" || extension == ".frag" || extension == ".comp";
+}
+
+/// @brief runs the executable (searched in the PATH) with the arguments and waits for it
+/// @brief >> no shell: arguments are passed as they are, file names cannot inject commands
+/// @return true when the process exited with 0
+static bool runProcess(std::vector<std::string> arguments)
+{
+    std::vector<char*> argv;
+    for(auto& argument : arguments)
+        argv.push_back(argument.data());
+    argv.push_back(nullptr);
+
+    pid_t pid = 0;
+    if(posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ) != 0)
+        return false;
+
+    int status = 0;
+    while(waitpid(pid, &status, 0) < 0)
+    {
+        if(errno != EINTR)
+            return false;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/// @return true when creation was successful
+bool VulkanShaderWatcher::Create(const std::string& shaderDirectory, CompiledCallback onCompiled)
+{
+    this->shaderDirectory = shaderDirectory;
+    this->onCompiled = std::move(onCompiled);
+
+    // create inotify instance
+    // >> close write: the editor finished writing, moved to: the editor saved through a temp file
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(inotifyFd < 0)
+    {
+        std::cout << "error: vulkan: failed to create shader watcher!";
+        return false;
+    }
+
+    if(inotify_add_watch(inotifyFd, shaderDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        std::cout << "error: vulkan: failed to watch " << shaderDirectory << "!";
+        close(inotifyFd);
+        inotifyFd = -1;
+        return false;
+    }
+
+    isStopping = false;
+    watchThread = std::thread(&VulkanShaderWatcher::watchLoop, this);
+    std::cout << "info: vulkan: watching shaders in " << shaderDirectory << std::endl;
+    return true;
+}
+
+void VulkanShaderWatcher::CleanUp()
+{
+    // stop the thread, a running compile is finished first
+    isStopping = true;
+    if(watchThread.joinable())
+        watchThread.join();
+
+    if(inotifyFd >= 0)
+        close(inotifyFd);
+    inotifyFd = -1;
+}
+
+void VulkanShaderWatcher::watchLoop()
+{
+    ARCTIC_PROFILE_THREAD("shader watcher");
+
+    std::set<std::string> changedSources;
+    while(!isStopping)
+    {
+        // wait for events
+        // >> short timeout while changes are collected, a timeout means the directory is quiet
+        pollfd pollFd{};
+        pollFd.fd = inotifyFd;
+        pollFd.events = POLLIN;
+        int ready = poll(&pollFd, 1, changedSources.empty() ? POLL_INTERVAL_MS : QUIET_PERIOD_MS);
+        if(ready < 0)
+            continue;
+
+        if(ready == 0)
+        {
+            // compile collected sources
+            for(const auto& sourceName : changedSources)
+            {
+                if(compile(sourceName) && onCompiled)
+                    onCompiled(sourceName + ".spv");
+            }
+            changedSources.clear();
+            continue;
+        }
+
+        // read events
+        // >> writes of the compiled binaries are events too, only glsl sources are collected
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length = 0;
+        while((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+        {
+            for(char* pEvent = buffer; pEvent < buffer + length; )
+            {
+                auto* event = reinterpret_cast<inotify_event*>(pEvent);
+                if(event->len > 0 && isShaderSource(event->name))
+                    changedSources.insert(event->name);
+                pEvent += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
+
+/// @brief compiles the source next to it, the binary is replaced atomically so a pipeline never reads a partial file
+bool VulkanShaderWatcher::compile(const std::string& sourceName) const
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    std::string sourcePath = fmt::format("{}/{}", shaderDirectory, sourceName);
+    std::string binaryPath = sourcePath + ".spv";
+    std::string tempPath = binaryPath + ".tmp";
+
+    // run glslc
+    // >> diagnostics go to stderr, the previous binary stays in use when compiling fails
+    auto start = std::chrono::steady_clock::now();
+    std::error_code errorCode;
+    if(!runProcess({ ARCTIC_GLSLC_EXECUTABLE, sourcePath, "-o", tempPath }))
+    {
+        std::cout << "error: vulkan: failed to compile shader " << sourcePath << "!";
+        std::filesystem::remove(tempPath, errorCode);
+        return false;
+    }
+
+    std::filesystem::rename(tempPath, binaryPath, errorCode);
+    if(errorCode)
+    {
+        std::cout << "error: vulkan: failed to replace shader " << binaryPath << "!";
+        return false;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "info: vulkan: compiled shader " << sourceName << " in " << ms << " ms" << std::endl;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+/// @brief Watches the shader source directory (inotify) and recompiles changed GLSL to SPIR-V with glslc on its own thread.
+/// @brief Bursts of writes (editors saving through temp files) are collected until the directory is quiet, every
+/// @brief compiled binary is reported through the callback, e.g. to rebuild the pipelines using it.
+class VulkanShaderWatcher
+{
+public:
+    using CompiledCallback = std::function<void(const std::string& binaryName)>;
+
+    bool Create(const std::string& shaderDirectory, CompiledCallback onCompiled);
+    void CleanUp();
+
+private:
+    // the watch thread checks for CleanUp at this interval
+    const int POLL_INTERVAL_MS = 250;
+    // changes are compiled once no event arrived for this long
+    const int QUIET_PERIOD_MS = 50;
+
+    std::string shaderDirectory;
+    CompiledCallback onCompiled;
+
+    int inotifyFd = -1;
+    std::thread watchThread;
+    std::atomic<bool> isStopping = false;
+
+    void watchLoop();
+    bool compile(const std::string& sourceName) const;
+};
\ No newline at end of file
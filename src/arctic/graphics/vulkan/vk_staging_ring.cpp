@@ -0,0 +1,151 @@
+#include "vk_staging_ring.h"
+#include "vk_memory_handler.h"
+#include <iostream>
+
+/// @brief creates the persistently mapped staging buffer
+/// @param memoryHandler used to allocate the buffer
+/// @param capacity size of the buffer in bytes
+/// @return true when creation was successful
+bool VulkanStagingRing::Create(std::shared_ptr<VulkanMemoryHandler> memoryHandler, VkDeviceSize capacity)
+{
+    this->memoryHandler = memoryHandler;
+    this->capacity = capacity;
+
+    // create buffer
+    // >> host sequential write + mapped: the cpu only writes linearly into it, the transfer queue reads it
+    VmaAllocationCreateFlags vmaFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    if(!memoryHandler->CreateBufferVMA(capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, vmaFlags, MemoryClass::Staging, &buffer, &allocation))
+    {
+        std::cout << "error: vulkan: failed to create staging ring buffer!";
+        return false;
+    }
+
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(memoryHandler->GetAllocator(), allocation, &allocationInfo);
+    pMappedData = static_cast<uint8_t*>(allocationInfo.pMappedData);
+    return true;
+}
+
+void VulkanStagingRing::CleanUp()
+{
+    memoryHandler->DestroyBuffer(buffer, allocation);
+    pMappedData = nullptr;
+    segments.clear();
+}
+
+/// @brief sub-allocates a contiguous block
+/// @param size size of the block in bytes, must not exceed the capacity
+/// @param alignment alignment of the block offset, must be a power of two
+/// @param offset offset of the block in the ring buffer (copy source offset)
+/// @param pMappedData mapped pointer to write the block to
+/// @return false when there is not enough free space, Reclaim or Close + wait first
+bool VulkanStagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset, void*& pMappedData)
+{
+    // empty: restart at the beginning, avoids wrapping with a half used buffer
+    if(usedSize == 0)
+    {
+        head = 0;
+        tail = 0;
+    }
+
+    VkDeviceSize alignedHead = (head + alignment - 1) & ~(alignment - 1);
+    VkDeviceSize newHead = 0;
+    if(head >= tail && usedSize < capacity)
+    {
+        // free: [head, capacity) and [0, tail)
+        if(alignedHead + size <= capacity)
+        {
+            offset = alignedHead;
+        }
+        else if(size <= tail)
+        {
+            // wrap around, the rest of the buffer is wasted until reclaimed
+            offset = 0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // free: [head, tail)
+        if(alignedHead + size <= tail)
+            offset = alignedHead;
+        else
+            return false;
+    }
+
+    newHead = offset + size;
+    VkDeviceSize allocatedSize = offset >= head ? newHead - head : (capacity - head) + newHead;
+
+    head = newHead;
+    usedSize += allocatedSize;
+    openSize += allocatedSize;
+    pMappedData = this->pMappedData + offset;
+    return true;
+}
+
+/// @brief makes cpu writes visible to the gpu, no-op on host coherent memory
+void VulkanStagingRing::FlushRange(VkDeviceSize offset, VkDeviceSize size)
+{
+    vmaFlushAllocation(memoryHandler->GetAllocator(), allocation, offset, size);
+}
+
+/// @brief assigns all allocations since the last Close to a ticket
+/// @param ticket value that is reached once the gpu consumed the allocations, tickets must increase
+void VulkanStagingRing::Close(uint64_t ticket)
+{
+    if(openSize == 0)
+        return;
+
+    Segment segment{};
+    segment.ticket = ticket;
+    segment.end = head;
+    segment.size = openSize;
+    segments.push_back(segment);
+    openSize = 0;
+}
+
+/// @brief frees all segments of completed tickets
+/// @param completedTicket last ticket the gpu completed
+void VulkanStagingRing::Reclaim(uint64_t completedTicket)
+{
+    while(!segments.empty() && segments.front().ticket <= completedTicket)
+    {
+        tail = segments.front().end;
+        usedSize -= segments.front().size;
+        segments.pop_front();
+    }
+}
+
+bool VulkanStagingRing::HasOpenAllocations() const
+{
+    return this->openSize > 0;
+}
+
+bool VulkanStagingRing::HasClosedAllocations() const
+{
+    return !this->segments.empty();
+}
+
+/// @brief ticket of the oldest segment still in use, wait for it to free space
+uint64_t VulkanStagingRing::GetOldestTicket() const
+{
+    return segments.empty() ? 0 : segments.front().ticket;
+}
+
+VkDeviceSize VulkanStagingRing::GetCapacity() const
+{
+    return this->capacity;
+}
+
+VkDeviceSize VulkanStagingRing::GetUsedSize() const
+{
+    return this->usedSize;
+}
+
+const VkBuffer& VulkanStagingRing::GetBuffer() const
+{
+    return this->buffer;
+}
\ No newline at end of file
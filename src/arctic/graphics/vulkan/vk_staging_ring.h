@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vulkan/vulkan_core.h>
+#include "vk_mem_alloc.h"
+
+class VulkanMemoryHandler;
+
+/// @brief Persistently mapped staging buffer that all cpu >> gpu transfers sub-allocate from.
+/// @brief Allocations are made at the head and wrap around at the end of the buffer. Everything allocated since the
+/// @brief last Close belongs to the ticket passed to Close (the timeline value of the transfer reading it), and is
+/// @brief reclaimed by Reclaim once that ticket completed. Memory use never exceeds the capacity set on creation.
+class VulkanStagingRing
+{
+public:
+    bool Create(std::shared_ptr<VulkanMemoryHandler> memoryHandler, VkDeviceSize capacity);
+    void CleanUp();
+
+    bool Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset, void*& pMappedData);
+    void FlushRange(VkDeviceSize offset, VkDeviceSize size);
+
+    void Close(uint64_t ticket);
+    void Reclaim(uint64_t completedTicket);
+
+    bool HasOpenAllocations() const;
+    bool HasClosedAllocations() const;
+    uint64_t GetOldestTicket() const;
+
+    VkDeviceSize GetCapacity() const;
+    VkDeviceSize GetUsedSize() const;
+    const VkBuffer& GetBuffer() const;
+
+private:
+    struct Segment
+    {
+        uint64_t ticket = 0;
+        VkDeviceSize end = 0;    // head at the time the segment was closed
+        VkDeviceSize size = 0;   // bytes incl. alignment padding and wrap-around waste
+    };
+
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    uint8_t* pMappedData = nullptr;
+
+    VkDeviceSize capacity = 0;
+    VkDeviceSize head = 0;      // next free byte
+    VkDeviceSize tail = 0;      // oldest byte still in use
+    VkDeviceSize usedSize = 0;
+    VkDeviceSize openSize = 0;  // bytes allocated since the last Close
+
+    std::deque<Segment> segments;
+};
\ No newline at end of file
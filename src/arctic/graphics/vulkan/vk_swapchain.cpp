@@ -1,25 +1,168 @@
 #include "vk_swapchain.h"
 #include "arctic/graphics/vulkan/vk_window.h"
+#include "vk_memory_handler.h"
+#include "arctic/core/utilities/profiler.h"
 #include <iostream>
+#include <algorithm>
+
+static VkPresentModeKHR toVkPresentMode(PresentMode presentMode)
+{
+    switch(presentMode)
+    {
+        case PresentMode::FifoRelaxed: return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        case PresentMode::Mailbox: return VK_PRESENT_MODE_MAILBOX_KHR;
+        case PresentMode::Immediate: return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        default: return VK_PRESENT_MODE_FIFO_KHR;
+    }
+}
 
 void VulkanSwapChain::Configure(
     VkDevice vkDevice, 
     VkPhysicalDevice vkPhysicalDevice,
     VkSurfaceKHR vkSurface,
-    std::shared_ptr<VulkanWindow> window)
+    std::shared_ptr<VulkanWindow> window,
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+    const PresentSettings& presentSettings)
 {
     this->vkDevice = vkDevice;
     this->vkPhysicalDevice = vkPhysicalDevice;
     this->vkSurface = vkSurface;
     this->window = window;
+    this->memoryHandler = memoryHandler;
+    this->presentSettings = presentSettings;
 }
 
 void VulkanSwapChain::CreateSwapChain()
 {
-    createSwapChain(vkDevice, vkPhysicalDevice, vkSurface, *window.get());
+    // headless: render into a ring of offscreen images instead of surface images
+    if(window->IsHeadless())
+        createOffscreenImages(*window.get());
+    else
+        createSwapChain(vkDevice, vkPhysicalDevice, vkSurface, *window.get(), VK_NULL_HANDLE);
+
     createImageViews(vkDevice);
 }
 
+/// @brief Creates a new swapchain for the current surface size, the current swapchain is passed as old swapchain.
+/// @brief The driver can hand over resources to the new swapchain and images already queued for presenting are still shown.
+/// @brief Nothing waits for the device: the old swapchain and its views are retired with the value of the last frame
+/// @brief rendered into them and destroyed by CollectGarbage, see there.
+/// @return false when no swapchain can be created right now (minimized window), the current one is kept
+bool VulkanSwapChain::Recreate(uint64_t lastFrameValue)
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    // headless: offscreen images do not depend on a surface
+    if(swapChainData.isHeadless)
+        return true;
+
+    // minimized: zero sized swapchains are not allowed, try again once the window has a size
+    SwapChainDeviceSupport swapChainSupport = QuerySwapChainSupport(vkPhysicalDevice, vkSurface);
+    auto framebufferSize = window->GetFramebufferSize();
+    if(swapChainSupport.capabilities.currentExtent.width == 0 || swapChainSupport.capabilities.currentExtent.height == 0 ||
+       framebufferSize.first == 0 || framebufferSize.second == 0)
+        return false;
+
+    // create swapchain
+    // >> on failure the old swapchain is retired anyway, acquiring from it reports out of date and recreation is retried
+    VkSwapchainKHR oldSwapChain = vkSwapChain;
+    if(!createSwapChain(vkDevice, vkPhysicalDevice, vkSurface, *window.get(), oldSwapChain))
+        return false;
+
+    // retire old swapchain
+    RetiredSwapChain retired{};
+    retired.swapChain = oldSwapChain;
+    retired.imageViews = std::move(swapChainImageViews);
+    retired.frameValue = lastFrameValue;
+    retiredSwapChains.push_back(std::move(retired));
+
+    swapChainImageViews.clear();
+    createImageViews(vkDevice);
+    return true;
+}
+
+/// @brief Destroys retired swapchains whose presents can no longer be pending.
+/// @brief The frame timeline only tells when rendering into an image finished, not when its present was processed.
+/// @brief A retired swapchain is therefore kept until a full frame slot cycle after the first successful present
+/// @brief on a newer swapchain completed: by then the presentation engine has moved on to the newer images.
+/// @param completedFrameValue completed value of the frame timeline
+void VulkanSwapChain::CollectGarbage(uint64_t completedFrameValue)
+{
+    auto itRetired = std::remove_if(retiredSwapChains.begin(), retiredSwapChains.end(), [this, completedFrameValue](RetiredSwapChain& retired)
+    {
+        if(retired.frameValue > completedFrameValue)
+            return false;
+        if(retired.releaseFrameValue == 0 || retired.releaseFrameValue > completedFrameValue)
+            return false;
+
+        for(auto& imageView : retired.imageViews)
+            vkDestroyImageView(vkDevice, imageView, nullptr);
+        vkDestroySwapchainKHR(vkDevice, retired.swapChain, nullptr);
+        return true;
+    });
+    retiredSwapChains.erase(itRetired, retiredSwapChains.end());
+}
+
+/// @brief Acquires the next image to render into.
+/// @brief Headless: cycles through the offscreen images. The image count matches the frames in flight,
+/// @brief so the frame timeline wait done before acquiring also guarantees the image is no longer in use.
+/// @param imageAvailableSemaphore is signaled by the presentation engine (unused when headless)
+/// @param imageIndex index of the acquired image
+/// @return result of the acquire
+VkResult VulkanSwapChain::AcquireNextImage(VkSemaphore imageAvailableSemaphore, uint32_t& imageIndex)
+{
+    if(swapChainData.isHeadless)
+    {
+        imageIndex = nextOffscreenImageIndex;
+        return VK_SUCCESS;
+    }
+
+    return vkAcquireNextImageKHR(vkDevice, vkSwapChain, UINT64_MAX, imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+}
+
+/// @brief Presents a rendered image.
+/// @brief Headless: nothing is shown, the ring simply advances to the next offscreen image.
+/// @param presentQueue queue that supports presenting to the surface
+/// @param renderFinishedSemaphore presentation waits on this semaphore (unused when headless)
+/// @param imageIndex index of the image to present
+/// @param frameValue frame timeline value of the frame rendered into the image, releases the retired swapchains
+/// @return result of the present
+VkResult VulkanSwapChain::Present(VkQueue presentQueue, VkSemaphore renderFinishedSemaphore, uint32_t imageIndex, uint64_t frameValue)
+{
+    if(swapChainData.isHeadless)
+    {
+        nextOffscreenImageIndex = (imageIndex + 1) % swapChainData.imageCount;
+        return VK_SUCCESS;
+    }
+
+    // create info: present khr
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &renderFinishedSemaphore;
+
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &vkSwapChain;
+    presentInfo.pImageIndices = &imageIndex;
+    presentInfo.pResults = nullptr; // Optional
+
+    // queue present khr
+    VkResult result = vkQueuePresentKHR(presentQueue, &presentInfo);
+
+    // release retired swapchains
+    // >> the current swapchain is presenting again, the retired ones are destroyed a full frame slot cycle later
+    if(result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+    {
+        for(auto& retired : retiredSwapChains)
+        {
+            if(retired.releaseFrameValue == 0)
+                retired.releaseFrameValue = frameValue + presentSettings.framesInFlight;
+        }
+    }
+    return result;
+}
+
 SwapChainDeviceSupport VulkanSwapChain::QuerySwapChainSupport(const VkPhysicalDevice & device, const VkSurfaceKHR & vkSurface) const
 {
     SwapChainDeviceSupport details;
@@ -50,11 +193,29 @@ SwapChainDeviceSupport VulkanSwapChain::QuerySwapChainSupport(const VkPhysicalDe
 
 void VulkanSwapChain::CleanUp(const VkDevice &vkDevice)
 {
+    // cleanup retired swapchains
+    // >> called after the device is idle, every frame completed
+    CollectGarbage(UINT64_MAX);
+
     // cleanup images
     for(auto & imageView : swapChainImageViews)
     {
         vkDestroyImageView(vkDevice, imageView, nullptr);
     }
+    swapChainImageViews.clear();
+
+    // cleanup offscreen images (headless)
+    // >> surface images are owned by the swapchain
+    if(swapChainData.isHeadless)
+    {
+        for(size_t i = 0; i < swapChainImages.size(); ++i)
+        {
+            memoryHandler->DestroyImage(swapChainImages[i], offscreenImageAllocations[i]);
+        }
+        offscreenImageAllocations.clear();
+        swapChainImages.clear();
+        return;
+    }
 
     // cleanup swapchain
     vkDestroySwapchainKHR(vkDevice, vkSwapChain, nullptr);
@@ -70,16 +231,29 @@ const VkSwapchainKHR &VulkanSwapChain::GetSwapChain()
     return this->vkSwapChain;
 }
 
+const std::vector<VkImage> &VulkanSwapChain::GetImages()
+{
+    return this->swapChainImages;
+}
+
 const std::vector<VkImageView> &VulkanSwapChain::GetImageViews()
 {
     return this->swapChainImageViews;
 }
 
-void VulkanSwapChain::createSwapChain(
+bool VulkanSwapChain::IsHeadless() const
+{
+    return this->swapChainData.isHeadless;
+}
+
+/// @param oldSwapChain swapchain being replaced, VK_NULL_HANDLE for the first one
+/// @return true when creation was successful
+bool VulkanSwapChain::createSwapChain(
     const VkDevice& vkDevice, 
     const VkPhysicalDevice& vkPhysicalDevice, 
     const VkSurfaceKHR& vkSurface,
-    const VulkanWindow& window)
+    const VulkanWindow& window,
+    VkSwapchainKHR oldSwapChain)
 {
     // query device support
     SwapChainDeviceSupport swapChainSupport = QuerySwapChainSupport(vkPhysicalDevice, vkSurface);
@@ -89,9 +263,7 @@ void VulkanSwapChain::createSwapChain(
     VkPresentModeKHR presentMode = selectSwapChainPresentMode(swapChainSupport.presentModes);
     VkExtent2D extent = selectSwapChainExtent(window, swapChainSupport.capabilities);
 
-    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1; // make sure to have al least 2 images
-    imageCount = std::clamp(imageCount, static_cast<uint32_t>(1), swapChainSupport.capabilities.maxImageCount);
-    imageCount = 3; // set to triple buffering
+    uint32_t imageCount = selectSwapChainImageCount(swapChainSupport.capabilities);
 
     // create swap chain info
     // .. default data
@@ -120,29 +292,79 @@ void VulkanSwapChain::createSwapChain(
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
 
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    createInfo.oldSwapchain = oldSwapChain;
 
     // create swap chain
-    VkResult result = vkCreateSwapchainKHR(vkDevice, &createInfo, nullptr, &vkSwapChain);
+    VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+    VkResult result = vkCreateSwapchainKHR(vkDevice, &createInfo, nullptr, &swapChain);
     if (result != VK_SUCCESS)
     {
         std::cout << "error: vulkan: failed to create swap chain!";
-        return;
+        return false;
     }
+    vkSwapChain = swapChain;
 
     swapChainData = {};
     swapChainData.imageFormat = surfaceFormat.format;
     swapChainData.extent = extent;
     swapChainData.imageCount = imageCount;
-}
+    swapChainData.presentMode = presentMode;
 
-void VulkanSwapChain::createImageViews(const VkDevice &vkDevice)
-{
     // get image handles
-    uint32_t imageCount = swapChainData.imageCount;
+    // >> the driver may create more images than requested
+    vkGetSwapchainImagesKHR(vkDevice, vkSwapChain, &imageCount, nullptr);
     swapChainImages.resize(imageCount);
     vkGetSwapchainImagesKHR(vkDevice, vkSwapChain, &imageCount, swapChainImages.data());
+    swapChainData.imageCount = imageCount;
+    return true;
+}
 
+/// @brief Creates a ring of offscreen color images that stand in for the swapchain images when running headless.
+/// @brief The images use the same format and size a window surface would get, so the render pass and pipeline are unchanged.
+void VulkanSwapChain::createOffscreenImages(const VulkanWindow& window)
+{
+    auto framebufferSize = window.GetFramebufferSize();
+
+    swapChainData = {};
+    swapChainData.imageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+    swapChainData.extent = { framebufferSize.first, framebufferSize.second };
+    swapChainData.imageCount = presentSettings.framesInFlight;
+    swapChainData.isHeadless = true;
+
+    swapChainImages.resize(swapChainData.imageCount);
+    offscreenImageAllocations.resize(swapChainData.imageCount);
+    nextOffscreenImageIndex = 0;
+
+    // create info: image
+    //> transfer src allows reading back the rendered frame
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = swapChainData.extent.width;
+    imageInfo.extent.height = swapChainData.extent.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = swapChainData.imageFormat;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+    // create images
+    for(uint32_t i = 0; i < swapChainData.imageCount; ++i)
+    {
+        if(!memoryHandler->CreateImageVMA(imageInfo, 0, MemoryClass::Default, &swapChainImages[i], &offscreenImageAllocations[i]))
+        {
+            std::cout << "error: vulkan: failed to create offscreen image!";
+            return;
+        }
+    }
+}
+
+void VulkanSwapChain::createImageViews(const VkDevice &vkDevice)
+{
     // resize views from created images
     swapChainImageViews.resize(swapChainImages.size());
 
@@ -193,18 +415,33 @@ VkSurfaceFormatKHR VulkanSwapChain::selectSwapChainSurfaceFormat(const std::vect
     return availableFormats[0];
 }
 
+/// @brief returns the requested present mode when the surface supports it, fifo otherwise (always supported)
 VkPresentModeKHR VulkanSwapChain::selectSwapChainPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes)
 {
+    VkPresentModeKHR requestedPresentMode = toVkPresentMode(presentSettings.presentMode);
+
     // loop over available modes
     for (const auto& availablePresentMode : availablePresentModes)
     {
         // return mode when met requirements
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+        if (availablePresentMode == requestedPresentMode)
             return availablePresentMode;
     }
+
+    // >> reported once, recreating the swapchain asks again
+    if(!isPresentModeFallbackReported)
+        std::cout << "info: vulkan: present mode " << requestedPresentMode << " not supported, using fifo" << std::endl;
+    isPresentModeFallbackReported = true;
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+/// @brief returns the requested image count clamped to the surface limits (max 0: no limit)
+uint32_t VulkanSwapChain::selectSwapChainImageCount(const VkSurfaceCapabilitiesKHR &capabilities)
+{
+    uint32_t maxImageCount = capabilities.maxImageCount > 0 ? capabilities.maxImageCount : UINT32_MAX;
+    return std::clamp(presentSettings.imageCount, capabilities.minImageCount, maxImageCount);
+}
+
 
 VkExtent2D VulkanSwapChain::selectSwapChainExtent(const VulkanWindow& window, const VkSurfaceCapabilitiesKHR & capabilities)
 {
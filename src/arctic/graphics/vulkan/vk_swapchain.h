@@ -3,6 +3,8 @@
 #include <vector>
 #include <memory>
 #include <vulkan/vulkan_core.h>
+#include "vk_mem_alloc.h"
+#include "arctic/graphics/rhi/present_settings.h"
 
 struct SwapChainDeviceSupport
 {
@@ -16,9 +18,12 @@ struct SwapChainData
     uint32_t imageCount;
     VkFormat imageFormat;
     VkExtent2D extent;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    bool isHeadless = false; // images are offscreen render targets, not presentable surface images
 };
 
 class VulkanWindow;
+class VulkanMemoryHandler;
 
 class VulkanSwapChain
 {
@@ -28,17 +33,31 @@ public:
         VkDevice vkDevice, 
         VkPhysicalDevice vkPhysicalDevice,
         VkSurfaceKHR vkSurface,
-        std::shared_ptr<VulkanWindow> window);
+        std::shared_ptr<VulkanWindow> window,
+        std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+        const PresentSettings& presentSettings);
 
     void CreateSwapChain();
 
+    // recreates the swapchain for the current window size without waiting for the device
+    // >> lastFrameValue: frame timeline value of the last frame rendered into the current images
+    bool Recreate(uint64_t lastFrameValue);
+
+    // destroys the swapchains replaced by Recreate once their presents can no longer be pending
+    void CollectGarbage(uint64_t completedFrameValue);
+
+    VkResult AcquireNextImage(VkSemaphore imageAvailableSemaphore, uint32_t& imageIndex);
+    VkResult Present(VkQueue presentQueue, VkSemaphore renderFinishedSemaphore, uint32_t imageIndex, uint64_t frameValue);
+
     SwapChainDeviceSupport QuerySwapChainSupport(const VkPhysicalDevice & device, const VkSurfaceKHR & vkSurface) const;
 
     void CleanUp(const VkDevice &vkDevice);
 
     const SwapChainData GetData();
     const VkSwapchainKHR &GetSwapChain();
+    const std::vector<VkImage> &GetImages();
     const std::vector<VkImageView> &GetImageViews();
+    bool IsHeadless() const;
 
 private:
 
@@ -46,22 +65,45 @@ private:
     VkPhysicalDevice vkPhysicalDevice;
     VkSurfaceKHR vkSurface;
     std::shared_ptr<VulkanWindow> window;
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler;
+    PresentSettings presentSettings;
+    bool isPresentModeFallbackReported = false;
 
-    void createSwapChain(
+    bool createSwapChain(
         const VkDevice& vkDevice, 
         const VkPhysicalDevice& vkPhysicalDevice, 
         const VkSurfaceKHR& vkSurface,
-        const VulkanWindow& window);
+        const VulkanWindow& window,
+        VkSwapchainKHR oldSwapChain);
 
+    void createOffscreenImages(const VulkanWindow& window);
     void createImageViews(const VkDevice &vkDevice);
 
     VkSurfaceFormatKHR selectSwapChainSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &availableFormats);
     VkPresentModeKHR selectSwapChainPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes);
+    uint32_t selectSwapChainImageCount(const VkSurfaceCapabilitiesKHR &capabilities);
     VkExtent2D selectSwapChainExtent(const VulkanWindow& window, const VkSurfaceCapabilitiesKHR &capabilities);
 
     SwapChainData swapChainData;
 
-    VkSwapchainKHR vkSwapChain;
+    VkSwapchainKHR vkSwapChain = VK_NULL_HANDLE;
     std::vector<VkImage> swapChainImages;
     std::vector<VkImageView> swapChainImageViews;
+
+    // replaced swapchains
+    // >> frames in flight may still render into (or present) their images, destroyed by CollectGarbage
+    // >> releaseFrameValue: set by the first successful present on a newer swapchain, 0 until then
+    struct RetiredSwapChain
+    {
+        VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+        std::vector<VkImageView> imageViews;
+        uint64_t frameValue = 0;
+        uint64_t releaseFrameValue = 0;
+    };
+    std::vector<RetiredSwapChain> retiredSwapChains;
+
+    // headless
+    // >> one image per frame in flight
+    std::vector<VmaAllocation> offscreenImageAllocations;
+    uint32_t nextOffscreenImageIndex = 0;
 };
\ No newline at end of file
@@ -0,0 +1,397 @@
+#include "vk_texture_streamer.h"
+#include "vk_memory_handler.h"
+#include "vk_upload_manager.h"
+#include "vk_mip_generator.h"
+#include "vk_sampler_cache.h"
+#include "arctic/core/utilities/thread_pool.h"
+#include "arctic/core/utilities/profiler.h"
+#include "arctic/graphics/texture/ktx2_loader.h"
+#include "arctic/graphics/texture/bc_decoder.h"
+
+#include <iostream>
+#include <chrono>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+/// @brief creates the decode workers and the placeholder texture
+/// @param pUploadManager upload manager the decoded images are queued on, must outlive the streamer
+/// @param pMipGenerator generates the mip chains of uploaded textures, must outlive the streamer
+/// @param pSamplerCache provides the samplers of the textures, must outlive the streamer
+/// @param decodeThreadCount worker threads decoding images, kept apart from the record workers so decodes never delay a frame
+/// @return true when creation was successful
+bool VulkanTextureStreamer::Create(
+    VkDevice vkDevice,
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+    VulkanUploadManager* pUploadManager,
+    VulkanMipGenerator* pMipGenerator,
+    VulkanSamplerCache* pSamplerCache,
+    uint32_t decodeThreadCount)
+{
+    this->vkDevice = vkDevice;
+    this->memoryHandler = memoryHandler;
+    this->pUploadManager = pUploadManager;
+    this->pMipGenerator = pMipGenerator;
+    this->pSamplerCache = pSamplerCache;
+
+    pDecodeThreadPool = std::make_unique<ThreadPool>(decodeThreadCount);
+    supportedFormatMask = querySupportedFormats();
+
+    return createPlaceholder();
+}
+
+void VulkanTextureStreamer::CleanUp()
+{
+    // finish running decodes, the workers must not outlive the textures they write to
+    for(auto& texture : textures)
+    {
+        if(texture.decodeTask.valid())
+            texture.decodeTask.wait();
+    }
+    pDecodeThreadPool.reset();
+
+    // textures
+    for(auto& texture : textures)
+        destroyTexture(texture);
+    textures.clear();
+    pendingCount = 0;
+
+    destroyTexture(placeholder);
+}
+
+/// @brief queues the decode of an image file on the decode workers
+/// @param path path of the image file
+/// @param samplerDesc sampling settings of the material using the texture
+/// @return handle of the texture, shows the placeholder until it is resident
+TextureHandle VulkanTextureStreamer::Request(const std::string& path, const SamplerDesc& samplerDesc)
+{
+    TextureHandle handle = static_cast<TextureHandle>(textures.size());
+
+    Texture texture{};
+    texture.path = path;
+    texture.sampler = pSamplerCache->GetSampler(samplerDesc);
+    uint32_t formatMask = supportedFormatMask;
+    texture.decodeTask = pDecodeThreadPool->Submit([path, formatMask]() { return decode(path, formatMask); });
+    textures.push_back(std::move(texture));
+    ++pendingCount;
+
+    return handle;
+}
+
+/// @brief Creates and queues the uploads of all textures decoded since the last call.
+/// @brief Call on the render thread before the upload manager is flushed, the uploads are then part of this frame's batch
+/// @brief and acquired by this frame, so a texture is marked resident as soon as its upload is queued.
+void VulkanTextureStreamer::Update()
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    if(pendingCount == 0)
+        return;
+
+    VkDeviceSize queuedSize = 0;
+    for(auto& texture : textures)
+    {
+        // stay within the upload budget
+        if(queuedSize >= UPLOAD_BUDGET_PER_UPDATE)
+            break;
+
+        // skip textures that are resident or still decoding
+        if(!texture.decodeTask.valid())
+            continue;
+        if(texture.decodeTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            continue;
+
+        TextureData textureData = texture.decodeTask.get();
+        --pendingCount;
+
+        if(textureData.levels.empty())
+        {
+            // keeps showing the placeholder
+            std::cout << "error: vulkan: failed to load texture image " << texture.path << "!";
+            continue;
+        }
+
+        if(!createTexture(textureData, texture))
+            continue;
+
+        queuedSize += textureData.GetSize();
+        texture.isResident = true;
+        ++residencyVersion;
+    }
+}
+
+bool VulkanTextureStreamer::IsResident(TextureHandle handle) const
+{
+    return handle < textures.size() && textures[handle].isResident;
+}
+
+/// @brief image view of the texture, the placeholder while it is not resident
+VkImageView VulkanTextureStreamer::GetImageView(TextureHandle handle) const
+{
+    if(!IsResident(handle))
+        return placeholder.imageView;
+
+    return textures[handle].imageView;
+}
+
+/// @brief sampler of the texture, the placeholder's sampler for invalid handles
+VkSampler VulkanTextureStreamer::GetSampler(TextureHandle handle) const
+{
+    if(handle >= textures.size())
+        return placeholder.sampler;
+
+    return textures[handle].sampler;
+}
+
+/// @brief increases every time a texture became resident, descriptors written with an older version are outdated
+uint64_t VulkanTextureStreamer::GetResidencyVersion() const
+{
+    return this->residencyVersion;
+}
+
+/// @brief Decodes an image file, runs on a decode worker.
+/// @brief KTX2 files are loaded with their mip chain, block compressed formats the device cannot sample are decompressed
+/// @brief to rgba8. Other files are decoded to rgba8 srgb with one level.
+/// @param supportedFormatMask bit per TextureFormat the device can sample
+/// @return no levels when the file could not be decoded
+TextureData VulkanTextureStreamer::decode(const std::string& path, uint32_t supportedFormatMask)
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    TextureData textureData{};
+
+    if(Ktx2Loader::IsKtx2File(path))
+    {
+        if(!Ktx2Loader::Load(path, textureData))
+            return TextureData{};
+
+        bool isSupported = supportedFormatMask & (1u << static_cast<uint32_t>(textureData.format));
+        if(!isSupported && TextureFormats::IsCompressed(textureData.format))
+        {
+            TextureData decompressed{};
+            if(!BcDecoder::Decompress(textureData, decompressed))
+                return TextureData{};
+            return decompressed;
+        }
+        return textureData;
+    }
+
+    int width, height, channels;
+    stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if(!pixels)
+        return textureData;
+
+    TextureLevel level{};
+    level.width = static_cast<uint32_t>(width);
+    level.height = static_cast<uint32_t>(height);
+    level.data.assign(pixels, pixels + static_cast<size_t>(width) * height * STBI_rgb_alpha);
+    stbi_image_free(pixels);
+
+    textureData.format = TextureFormat::RGBA8_SRGB;
+    textureData.width = level.width;
+    textureData.height = level.height;
+    textureData.levels.push_back(std::move(level));
+    return textureData;
+}
+
+/// @brief texture formats the device can sample with linear filtering as a bit mask (bit = TextureFormat)
+uint32_t VulkanTextureStreamer::querySupportedFormats() const
+{
+    const TextureFormat formats[] = {
+        TextureFormat::RGBA8_UNORM, TextureFormat::RGBA8_SRGB,
+        TextureFormat::BC1_UNORM, TextureFormat::BC1_SRGB,
+        TextureFormat::BC1_RGB_UNORM, TextureFormat::BC1_RGB_SRGB,
+        TextureFormat::BC3_UNORM, TextureFormat::BC3_SRGB,
+        TextureFormat::BC5_UNORM,
+        TextureFormat::BC7_UNORM, TextureFormat::BC7_SRGB };
+
+    const VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+
+    uint32_t mask = 0;
+    for(TextureFormat format : formats)
+    {
+        VkFormatProperties properties{};
+        vkGetPhysicalDeviceFormatProperties(memoryHandler->GetPhysicalDevice(), static_cast<VkFormat>(Ktx2Loader::ToVkFormat(format)), &properties);
+        if((properties.optimalTilingFeatures & requiredFeatures) == requiredFeatures)
+            mask |= 1u << static_cast<uint32_t>(format);
+    }
+    return mask;
+}
+
+/// @brief creates the image of the texture, queues the upload of its levels and the generation of its mip chain
+/// @brief textures with a single rgba8 level get their mip chain from the mip generator, other textures bring their own
+bool VulkanTextureStreamer::createTexture(const TextureData& textureData, Texture& texture)
+{
+    texture.format = static_cast<VkFormat>(Ktx2Loader::ToVkFormat(textureData.format));
+    uint32_t blockSize = TextureFormats::GetBlockSize(textureData.format);
+    uint32_t bytesPerBlock = TextureFormats::GetBytesPerBlock(textureData.format);
+
+    // full mip chain when the mip generator supports the format, levels of the file otherwise
+    uint32_t levelCount = static_cast<uint32_t>(textureData.levels.size());
+    bool generateMips = levelCount == 1 && !TextureFormats::IsCompressed(textureData.format) && pMipGenerator->IsSupported(texture.format);
+    texture.mipLevels = generateMips ? VulkanMipGenerator::GetMipLevelCount(textureData.width, textureData.height) : levelCount;
+    if(texture.mipLevels == 1)
+        generateMips = false;
+
+    // create image
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = textureData.width;
+    imageInfo.extent.height = textureData.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = texture.mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = texture.format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    if(generateMips)
+    {
+        imageInfo.usage |= pMipGenerator->GetRequiredUsage(texture.format);
+        imageInfo.flags |= pMipGenerator->GetRequiredCreateFlags(texture.format);
+    }
+
+    if(!memoryHandler->CreateImageVMA(imageInfo, 0, MemoryClass::Texture, &texture.image, &texture.allocation))
+    {
+        std::cout << "error: vulkan: failed to create texture image!";
+        return false;
+    }
+
+    // queue transfer of the levels (staging ring >> image)
+    // >> levels are copied into the staging ring right away, the texture data can be freed afterwards
+    // >> with generated mips: all levels stay in TRANSFER_DST, the graphics queue reads mip 0 to build the chain
+    std::vector<ImageLevelData> levels;
+    levels.reserve(levelCount);
+    for(const auto& level : textureData.levels)
+        levels.push_back(ImageLevelData{level.data.data(), level.width, level.height});
+
+    bool isUploaded = false;
+    if(generateMips)
+    {
+        isUploaded = pUploadManager->UploadImageLevels(
+            levels,
+            blockSize,
+            bytesPerBlock,
+            texture.image,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+            texture.mipLevels,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    }
+    else
+    {
+        isUploaded = pUploadManager->UploadImageLevels(
+            levels,
+            blockSize,
+            bytesPerBlock,
+            texture.image,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            VK_ACCESS_SHADER_READ_BIT,
+            texture.mipLevels);
+    }
+
+    if(!isUploaded)
+    {
+        // chunks queued before the failure may still write the image, it is kept alive until clean up
+        std::cout << "error: vulkan: failed to upload texture image!";
+        return false;
+    }
+
+    // queue mip generation, recorded by the frame that acquires the upload
+    if(generateMips)
+    {
+        pMipGenerator->Queue(
+            texture.image,
+            texture.format,
+            textureData.width,
+            textureData.height,
+            texture.mipLevels,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    return createImageView(texture.image, texture.format, texture.mipLevels, texture.imageView);
+}
+
+bool VulkanTextureStreamer::createImageView(VkImage image, VkFormat format, uint32_t mipLevels, VkImageView& imageView)
+{
+    // create info: image view
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = mipLevels;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    VkResult result = vkCreateImageView(vkDevice, &viewInfo, nullptr, &imageView);
+    if(result != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create texture image view!";
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Creates the texture shown while a requested texture is not resident yet.
+/// @brief A small grey checker board, uploaded and mipmapped with the first batch like any other texture.
+bool VulkanTextureStreamer::createPlaceholder()
+{
+    const uint32_t size = 64;
+    const uint32_t cellSize = 8;
+
+    TextureData checker{};
+    checker.format = TextureFormat::RGBA8_SRGB;
+    checker.width = size;
+    checker.height = size;
+    checker.levels.resize(1);
+    checker.levels[0].width = size;
+    checker.levels[0].height = size;
+    checker.levels[0].data.resize(size * size * BYTES_PER_PIXEL);
+    for(uint32_t y = 0; y < size; ++y)
+    {
+        for(uint32_t x = 0; x < size; ++x)
+        {
+            bool isLight = ((x / cellSize) + (y / cellSize)) % 2 == 0;
+            uint8_t value = isLight ? 192 : 96;
+
+            uint8_t* pPixel = &checker.levels[0].data[(y * size + x) * BYTES_PER_PIXEL];
+            pPixel[0] = value;
+            pPixel[1] = value;
+            pPixel[2] = value;
+            pPixel[3] = 255;
+        }
+    }
+
+    if(!createTexture(checker, placeholder))
+    {
+        std::cout << "error: vulkan: failed to create placeholder texture!";
+        return false;
+    }
+
+    placeholder.path = "placeholder";
+    placeholder.sampler = pSamplerCache->GetSampler(SamplerDesc());
+    placeholder.isResident = true;
+    return true;
+}
+
+void VulkanTextureStreamer::destroyTexture(Texture& texture)
+{
+    if(texture.imageView != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(vkDevice, texture.imageView, nullptr);
+        texture.imageView = VK_NULL_HANDLE;
+    }
+
+    if(texture.image != VK_NULL_HANDLE)
+        memoryHandler->DestroyImage(texture.image, texture.allocation);
+
+    texture.isResident = false;
+}
\ No newline at end of file
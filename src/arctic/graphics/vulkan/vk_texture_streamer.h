@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include "vk_mem_alloc.h"
+#include "arctic/graphics/rhi/sampler_desc.h"
+#include "arctic/graphics/texture/texture_data.h"
+
+class VulkanMemoryHandler;
+class VulkanUploadManager;
+class VulkanMipGenerator;
+class VulkanSamplerCache;
+class ThreadPool;
+
+using TextureHandle = uint32_t;
+
+/// @brief Loads textures in the background and makes them resident without blocking the render thread.
+/// @brief Request queues the decode (ktx2, jpeg, png, ...) on the decode worker threads and returns right away.
+/// @brief KTX2 files keep their block compressed format and mip chain when the device can sample the format, otherwise
+/// @brief they are decompressed to rgba8 on the worker.
+/// @brief Update runs on the render thread once per frame: decoded images are created and queued on the upload
+/// @brief manager, so they are copied with the next upload batch on the transfer queue. The mip chain is generated on the
+/// @brief graphics queue by the mip generator in the frame that acquires the upload.
+/// @brief Until a texture is resident GetImageView returns a placeholder, users rewrite their descriptors when
+/// @brief GetResidencyVersion changed.
+class VulkanTextureStreamer
+{
+public:
+    bool Create(
+        VkDevice vkDevice,
+        std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+        VulkanUploadManager* pUploadManager,
+        VulkanMipGenerator* pMipGenerator,
+        VulkanSamplerCache* pSamplerCache,
+        uint32_t decodeThreadCount = 2);
+    void CleanUp();
+
+    TextureHandle Request(const std::string& path, const SamplerDesc& samplerDesc = SamplerDesc());
+    void Update();
+
+    bool IsResident(TextureHandle handle) const;
+    VkImageView GetImageView(TextureHandle handle) const;
+    VkSampler GetSampler(TextureHandle handle) const;
+    uint64_t GetResidencyVersion() const;
+
+private:
+    struct Texture
+    {
+        std::string path;
+        std::future<TextureData> decodeTask; // valid until the decoded texture was picked up by Update
+
+        VkImage image = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        VkImageView imageView = VK_NULL_HANDLE;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t mipLevels = 1;
+        VkSampler sampler = VK_NULL_HANDLE; // shared, owned by the sampler cache
+        bool isResident = false;
+    };
+
+    // limits the bytes queued for upload per Update, keeps a level load from stalling one frame on the staging ring
+    // >> at least one texture is queued per Update, even when it is larger
+    const VkDeviceSize UPLOAD_BUDGET_PER_UPDATE = 16 * 1024 * 1024;
+    const uint32_t BYTES_PER_PIXEL = 4;
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler;
+    VulkanUploadManager* pUploadManager = nullptr;
+    VulkanMipGenerator* pMipGenerator = nullptr;
+    VulkanSamplerCache* pSamplerCache = nullptr;
+
+    std::unique_ptr<ThreadPool> pDecodeThreadPool;
+    std::vector<Texture> textures; // indexed by handle
+    uint32_t pendingCount = 0;     // requested textures that are not resident yet
+    uint32_t supportedFormatMask = 0; // bit per TextureFormat the device can sample and filter
+
+    Texture placeholder;
+
+    uint64_t residencyVersion = 0;
+
+    static TextureData decode(const std::string& path, uint32_t supportedFormatMask);
+    uint32_t querySupportedFormats() const;
+    bool createTexture(const TextureData& textureData, Texture& texture);
+    bool createImageView(VkImage image, VkFormat format, uint32_t mipLevels, VkImageView& imageView);
+    bool createPlaceholder();
+    void destroyTexture(Texture& texture);
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "vk_timeline.h"
+#include <iostream>
+
+/// @brief creates the timeline semaphore
+/// @param vkDevice device that owns the semaphore
+/// @param initialValue value the counter starts at, waiting on any value <= initialValue returns immediately
+/// @return true when creation was successful
+bool VulkanTimeline::Create(VkDevice vkDevice, uint64_t initialValue)
+{
+    this->vkDevice = vkDevice;
+
+    // create info: timeline semaphore type
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = initialValue;
+
+    // create info: semaphore
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(vkDevice, &semaphoreInfo, nullptr, &vkSemaphore) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create timeline semaphore!";
+        return false;
+    }
+    return true;
+}
+
+void VulkanTimeline::CleanUp()
+{
+    vkDestroySemaphore(vkDevice, vkSemaphore, nullptr);
+    vkSemaphore = VK_NULL_HANDLE;
+}
+
+const VkSemaphore& VulkanTimeline::GetSemaphore() const
+{
+    return this->vkSemaphore;
+}
+
+/// @brief returns the last value the gpu signaled, without blocking
+uint64_t VulkanTimeline::GetCompletedValue() const
+{
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(vkDevice, vkSemaphore, &value);
+    return value;
+}
+
+bool VulkanTimeline::IsComplete(uint64_t value) const
+{
+    return GetCompletedValue() >= value;
+}
+
+/// @brief blocks until the counter reaches value
+/// @param value value to wait for
+/// @param timeout timeout in nanoseconds
+/// @return true when the value was reached, false on timeout or error
+bool VulkanTimeline::Wait(uint64_t value, uint64_t timeout) const
+{
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &vkSemaphore;
+    waitInfo.pValues = &value;
+
+    return vkWaitSemaphores(vkDevice, &waitInfo, timeout) == VK_SUCCESS;
+}
\ No newline at end of file
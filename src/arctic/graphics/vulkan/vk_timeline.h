@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+/// @brief Wraps a Vulkan 1.2 timeline semaphore: a single monotonically increasing 64 bit counter
+/// @brief that the gpu signals when work completes and that the cpu (or other queues) can wait on.
+class VulkanTimeline
+{
+public:
+    bool Create(VkDevice vkDevice, uint64_t initialValue = 0);
+    void CleanUp();
+
+    const VkSemaphore& GetSemaphore() const;
+    uint64_t GetCompletedValue() const;
+
+    bool IsComplete(uint64_t value) const;
+    bool Wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+private:
+    VkDevice vkDevice = VK_NULL_HANDLE;
+    VkSemaphore vkSemaphore = VK_NULL_HANDLE;
+};
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "vk_uniform_ring.h"
+#include "vk_memory_handler.h"
+#include <algorithm>
+#include <iostream>
+
+/// @brief creates the persistently mapped ring buffer
+/// @param memoryHandler used to allocate the buffer
+/// @param frameCapacity bytes available for uniform data per frame
+/// @param frameCount number of frames in flight, each frame gets its own region
+/// @return true when creation was successful
+bool VulkanUniformRing::Create(
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+    VkDeviceSize frameCapacity,
+    uint32_t frameCount)
+{
+    this->memoryHandler = memoryHandler;
+    this->frameCount = frameCount;
+
+    // dynamic offsets must be a multiple of minUniformBufferOffsetAlignment
+    // >> keep every frame region aligned too
+    this->alignment = std::max<VkDeviceSize>(1, memoryHandler->GetPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment);
+    this->frameCapacity = (frameCapacity + alignment - 1) & ~(alignment - 1);
+
+    // create buffer
+    // >> host sequential write + mapped: persistently mapped, the cpu only writes linearly into it
+    VkDeviceSize bufferSize = this->frameCapacity * frameCount;
+    VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    VmaAllocationCreateFlags vmaFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    if(!memoryHandler->CreateBufferVMA(bufferSize, usage, vmaFlags, MemoryClass::Uniform, &buffer, &allocation))
+    {
+        std::cout << "error: vulkan: failed to create uniform ring buffer!";
+        return false;
+    }
+
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(memoryHandler->GetAllocator(), allocation, &allocationInfo);
+    pMappedData = static_cast<uint8_t*>(allocationInfo.pMappedData);
+
+    BeginFrame(0);
+    return true;
+}
+
+void VulkanUniformRing::CleanUp()
+{
+    memoryHandler->DestroyBuffer(buffer, allocation);
+    pMappedData = nullptr;
+}
+
+/// @brief resets the region of a frame, the caller must make sure the gpu is done reading it
+/// @param frameIndex index of the frame in flight
+void VulkanUniformRing::BeginFrame(uint32_t frameIndex)
+{
+    frameStart = frameCapacity * (frameIndex % frameCount);
+    frameOffset.store(0, std::memory_order_relaxed);
+}
+
+/// @brief makes the writes of the current frame visible to the gpu
+/// @brief no-op on host coherent memory
+void VulkanUniformRing::EndFrame()
+{
+    VkDeviceSize usedSize = std::min(frameOffset.load(std::memory_order_relaxed), frameCapacity);
+    if(usedSize > 0)
+        vmaFlushAllocation(memoryHandler->GetAllocator(), allocation, frameStart, usedSize);
+}
+
+/// @brief sub-allocates an aligned block in the region of the current frame, thread safe
+/// @param size size of the block in bytes
+/// @param dynamicOffset offset of the block in the buffer, to pass to vkCmdBindDescriptorSets
+/// @return mapped pointer to write the block to, nullptr when the frame region is full
+void* VulkanUniformRing::Allocate(VkDeviceSize size, uint32_t& dynamicOffset)
+{
+    VkDeviceSize alignedSize = (size + alignment - 1) & ~(alignment - 1);
+    VkDeviceSize offset = frameOffset.fetch_add(alignedSize, std::memory_order_relaxed);
+    if(offset + alignedSize > frameCapacity)
+    {
+        if(!hasReportedOverflow.exchange(true))
+            std::cout << "error: vulkan: uniform ring frame capacity exceeded!";
+        return nullptr;
+    }
+
+    dynamicOffset = static_cast<uint32_t>(frameStart + offset);
+    return pMappedData + frameStart + offset;
+}
+
+const VkBuffer& VulkanUniformRing::GetBuffer() const
+{
+    return this->buffer;
+}
\ No newline at end of file
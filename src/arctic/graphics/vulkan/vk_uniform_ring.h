@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vulkan/vulkan_core.h>
+#include "vk_mem_alloc.h"
+
+class VulkanMemoryHandler;
+
+/// @brief Linear per-frame allocator for uniform data on top of one large persistently mapped buffer.
+/// @brief The buffer is split into one region per frame in flight. Every frame the region of that frame is reset
+/// @brief and callers sub-allocate aligned blocks from it, which are bound with UNIFORM_BUFFER_DYNAMIC offsets.
+/// @brief Allocating is a single atomic add, so worker threads recording command buffers can allocate concurrently.
+class VulkanUniformRing
+{
+public:
+    bool Create(
+        std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+        VkDeviceSize frameCapacity,
+        uint32_t frameCount);
+    void CleanUp();
+
+    void BeginFrame(uint32_t frameIndex);
+    void EndFrame();
+
+    void* Allocate(VkDeviceSize size, uint32_t& dynamicOffset);
+
+    template<typename T>
+    bool Push(const T& data, uint32_t& dynamicOffset)
+    {
+        void* pMapped = Allocate(sizeof(T), dynamicOffset);
+        if(pMapped == nullptr)
+            return false;
+        *static_cast<T*>(pMapped) = data;
+        return true;
+    }
+
+    const VkBuffer& GetBuffer() const;
+
+private:
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    uint8_t* pMappedData = nullptr;
+
+    VkDeviceSize frameCapacity = 0;
+    VkDeviceSize alignment = 1;
+    uint32_t frameCount = 0;
+
+    VkDeviceSize frameStart = 0;                  // start of the region of the current frame
+    std::atomic<VkDeviceSize> frameOffset = 0;    // next free byte, relative to frameStart
+    std::atomic<bool> hasReportedOverflow = false;
+};
\ No newline at end of file
@@ -0,0 +1,520 @@
+#include "vk_upload_manager.h"
+#include "vk_memory_handler.h"
+#include "arctic/core/utilities/profiler.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+/// @brief creates the command pool, upload timeline and staging ring
+/// @param vkDevice device used to create the objects
+/// @param memoryHandler used to allocate the staging ring
+/// @param transferQueue queue the batches are submitted to
+/// @param transferFamilyIndex family of the transfer queue
+/// @param graphicsFamilyIndex family the uploaded resources are used on
+/// @param stagingCapacity size of the staging ring in bytes, bounds the transfer memory in use
+/// @return true when creation was successful
+bool VulkanUploadManager::Create(
+    VkDevice vkDevice,
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+    VkQueue transferQueue,
+    uint32_t transferFamilyIndex,
+    uint32_t graphicsFamilyIndex,
+    VkDeviceSize stagingCapacity)
+{
+    this->vkDevice = vkDevice;
+    this->memoryHandler = memoryHandler;
+    this->vkTransferQueue = transferQueue;
+    this->transferFamilyIndex = transferFamilyIndex;
+    this->graphicsFamilyIndex = graphicsFamilyIndex;
+
+    // create info: command pool
+    // >> transient: one short lived command buffer per batch, freed once the batch completed
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = transferFamilyIndex;
+
+    if (vkCreateCommandPool(vkDevice, &poolInfo, nullptr, &vkCommandPool) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create command pool!";
+        return false;
+    }
+
+    // create staging ring
+    // >> buffer >> image copies need offsets aligned to the texel block size (<= 16) and perform best at optimalBufferCopyOffsetAlignment
+    VkDeviceSize optimalAlignment = memoryHandler->GetPhysicalDeviceProperties().limits.optimalBufferCopyOffsetAlignment;
+    this->stagingAlignment = std::max<VkDeviceSize>(16, optimalAlignment);
+    if(!stagingRing.Create(memoryHandler, stagingCapacity))
+        return false;
+
+    return uploadTimeline.Create(vkDevice, 0);
+}
+
+void VulkanUploadManager::CleanUp()
+{
+    // wait for all submitted batches
+    uploadTimeline.Wait(submittedValue);
+
+    for(auto& batch : batches)
+        destroyBatch(batch);
+    batches.clear();
+    pendingCopies.clear();
+
+    stagingRing.CleanUp();
+
+    vkDestroyCommandPool(vkDevice, vkCommandPool, nullptr);
+    vkCommandPool = VK_NULL_HANDLE;
+    uploadTimeline.CleanUp();
+}
+
+/// @brief copies the data into the staging ring and queues the copy into dstBuffer for the next Flush
+/// @brief uploads larger than a chunk are split, each chunk is copied as soon as ring space is available
+/// @param pData data to upload
+/// @param size size of the data in bytes
+/// @param dstBuffer destination buffer, must be created with VK_BUFFER_USAGE_TRANSFER_DST_BIT
+/// @param dstOffset offset in the destination buffer
+/// @param dstStageMask graphics stages that will read the buffer (e.g. VK_PIPELINE_STAGE_VERTEX_INPUT_BIT)
+/// @param dstAccessMask graphics accesses that will read the buffer (e.g. VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT)
+/// @return true when the copy was queued
+bool VulkanUploadManager::UploadBuffer(
+    const void* pData,
+    VkDeviceSize size,
+    VkBuffer dstBuffer,
+    VkDeviceSize dstOffset,
+    VkPipelineStageFlags dstStageMask,
+    VkAccessFlags dstAccessMask)
+{
+    const uint8_t* pSource = static_cast<const uint8_t*>(pData);
+    VkDeviceSize maxChunkSize = getMaxChunkSize();
+
+    for(VkDeviceSize progress = 0; progress < size;)
+    {
+        VkDeviceSize chunkSize = std::min(size - progress, maxChunkSize);
+
+        // copy chunk into the staging ring
+        PendingCopy copy{};
+        void* pMapped = nullptr;
+        if(!allocateStaging(chunkSize, copy.srcOffset, pMapped))
+            return false;
+        memcpy(pMapped, pSource + progress, chunkSize);
+        stagingRing.FlushRange(copy.srcOffset, chunkSize);
+
+        copy.dstBuffer = dstBuffer;
+        copy.bufferRegion.srcOffset = copy.srcOffset;
+        copy.bufferRegion.dstOffset = dstOffset + progress;
+        copy.bufferRegion.size = chunkSize;
+
+        progress += chunkSize;
+        copy.isFirstChunk = copy.bufferRegion.dstOffset == dstOffset;
+        copy.isLastChunk = progress == size;
+        copy.dstOffset = dstOffset;
+        copy.dstSize = size;
+        copy.dstStageMask = dstStageMask;
+        copy.dstAccessMask = dstAccessMask;
+        pendingCopies.push_back(copy);
+    }
+    return true;
+}
+
+/// @brief copies the pixels into the staging ring and queues the copy into mip 0 of dstImage for the next Flush
+/// @brief the image is transitioned UNDEFINED >> TRANSFER_DST_OPTIMAL >> finalLayout
+/// @brief images larger than a chunk are split into bands of rows
+/// @param pData tightly packed pixels
+/// @param width width in pixels
+/// @param height height in pixels
+/// @param bytesPerPixel size of one pixel in bytes
+/// @param dstImage destination image, must be created with VK_IMAGE_USAGE_TRANSFER_DST_BIT and layout UNDEFINED
+/// @param dstStageMask graphics stages that will read the image (e.g. VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+/// @param dstAccessMask graphics accesses that will read the image (e.g. VK_ACCESS_SHADER_READ_BIT)
+/// @param mipLevels mip levels of dstImage, all levels are transitioned and handed to the graphics family
+/// @param finalLayout layout of all levels after the upload, TRANSFER_DST_OPTIMAL keeps them writable for mip generation
+/// @return true when the copy was queued
+bool VulkanUploadManager::UploadImage(
+    const void* pData,
+    uint32_t width,
+    uint32_t height,
+    uint32_t bytesPerPixel,
+    VkImage dstImage,
+    VkPipelineStageFlags dstStageMask,
+    VkAccessFlags dstAccessMask,
+    uint32_t mipLevels,
+    VkImageLayout finalLayout)
+{
+    std::vector<ImageLevelData> levels = { ImageLevelData{pData, width, height} };
+    return UploadImageLevels(levels, 1, bytesPerPixel, dstImage, dstStageMask, dstAccessMask, mipLevels, finalLayout);
+}
+
+/// @brief copies the levels into the staging ring and queues the copies into the first levels of dstImage for the next Flush
+/// @brief the image is transitioned UNDEFINED >> TRANSFER_DST_OPTIMAL >> finalLayout
+/// @brief levels larger than a chunk are split into bands of block rows
+/// @param levels data of mip 0, 1, ... tightly packed in blocks
+/// @param blockSize width and height of a block in pixels, 1 for uncompressed formats, 4 for BC formats
+/// @param bytesPerBlock size of one block in bytes (bytes per pixel for uncompressed formats)
+/// @param dstImage destination image, must be created with VK_IMAGE_USAGE_TRANSFER_DST_BIT and layout UNDEFINED
+/// @param dstStageMask graphics stages that will read the image (e.g. VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+/// @param dstAccessMask graphics accesses that will read the image (e.g. VK_ACCESS_SHADER_READ_BIT)
+/// @param mipLevels mip levels of dstImage (>= levels), all levels are transitioned and handed to the graphics family
+/// @param finalLayout layout of all levels after the upload, TRANSFER_DST_OPTIMAL keeps them writable for mip generation
+/// @return true when the copies were queued
+bool VulkanUploadManager::UploadImageLevels(
+    const std::vector<ImageLevelData>& levels,
+    uint32_t blockSize,
+    uint32_t bytesPerBlock,
+    VkImage dstImage,
+    VkPipelineStageFlags dstStageMask,
+    VkAccessFlags dstAccessMask,
+    uint32_t mipLevels,
+    VkImageLayout finalLayout)
+{
+    if(levels.empty() || levels.size() > mipLevels)
+    {
+        std::cout << "error: vulkan: invalid image level count for upload!";
+        return false;
+    }
+
+    VkDeviceSize maxChunkSize = getMaxChunkSize();
+    for(uint32_t level = 0; level < levels.size(); ++level)
+    {
+        const ImageLevelData& levelData = levels[level];
+        const uint8_t* pSource = static_cast<const uint8_t*>(levelData.pData);
+        uint32_t blocksWide = (levelData.width + blockSize - 1) / blockSize;
+        uint32_t blocksHigh = (levelData.height + blockSize - 1) / blockSize;
+
+        VkDeviceSize rowSize = static_cast<VkDeviceSize>(blocksWide) * bytesPerBlock;
+        if(rowSize > maxChunkSize)
+        {
+            std::cout << "error: vulkan: image row exceeds staging chunk size!";
+            return false;
+        }
+        uint32_t rowsPerChunk = static_cast<uint32_t>(maxChunkSize / rowSize);
+
+        for(uint32_t row = 0; row < blocksHigh;)
+        {
+            uint32_t chunkRows = std::min(blocksHigh - row, rowsPerChunk);
+            VkDeviceSize chunkSize = rowSize * chunkRows;
+
+            // copy band of block rows into the staging ring
+            PendingCopy copy{};
+            void* pMapped = nullptr;
+            if(!allocateStaging(chunkSize, copy.srcOffset, pMapped))
+                return false;
+            memcpy(pMapped, pSource + rowSize * row, chunkSize);
+            stagingRing.FlushRange(copy.srcOffset, chunkSize);
+
+            // region in pixels, partial blocks at the image edge are clamped to the level size
+            uint32_t firstPixelRow = row * blockSize;
+            uint32_t pixelRows = std::min(chunkRows * blockSize, levelData.height - firstPixelRow);
+
+            copy.dstImage = dstImage;
+            copy.imageRegion.bufferOffset = copy.srcOffset;
+            copy.imageRegion.bufferRowLength = 0; // tightly packed
+            copy.imageRegion.bufferImageHeight = 0;
+            copy.imageRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copy.imageRegion.imageSubresource.mipLevel = level;
+            copy.imageRegion.imageSubresource.baseArrayLayer = 0;
+            copy.imageRegion.imageSubresource.layerCount = 1;
+            copy.imageRegion.imageOffset = {0, static_cast<int32_t>(firstPixelRow), 0};
+            copy.imageRegion.imageExtent = {levelData.width, pixelRows, 1};
+
+            copy.mipLevels = mipLevels;
+            copy.finalLayout = finalLayout;
+
+            copy.isFirstChunk = level == 0 && row == 0;
+            row += chunkRows;
+            copy.isLastChunk = level + 1 == levels.size() && row == blocksHigh;
+            copy.dstStageMask = dstStageMask;
+            copy.dstAccessMask = dstAccessMask;
+            pendingCopies.push_back(copy);
+        }
+    }
+    return true;
+}
+
+/// @brief records all queued copies into one command buffer and submits it to the transfer queue
+/// @return timeline value signaled when the batch completed, 0 when nothing was queued
+uint64_t VulkanUploadManager::Flush()
+{
+    ARCTIC_PROFILE_FUNCTION();
+
+    if(pendingCopies.empty())
+        return 0;
+
+    // create info: command buffer allocation
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = vkCommandPool;
+    allocInfo.commandBufferCount = 1;
+
+    Batch batch{};
+    if (vkAllocateCommandBuffers(vkDevice, &allocInfo, &batch.commandBuffer) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to create command buffer!";
+        return 0;
+    }
+
+    // command buffer: begin
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+
+    // command: copy staging ring >> dst
+    // >> chunks of one upload may be spread over several batches, barriers in earlier batches still apply
+    // >> because batches execute in submission order on the transfer queue
+    bool isOwnershipTransfer = isOwnershipTransferRequired();
+    uint32_t srcFamily = isOwnershipTransfer ? transferFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dstFamily = isOwnershipTransfer ? graphicsFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+
+    std::vector<VkBufferMemoryBarrier> releaseBufferBarriers;
+    std::vector<VkImageMemoryBarrier> releaseImageBarriers;
+    for(const auto& copy : pendingCopies)
+    {
+        if(copy.dstImage != VK_NULL_HANDLE)
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.image = copy.dstImage;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = copy.mipLevels;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+
+            // command: transition UNDEFINED >> TRANSFER_DST before the first chunk
+            if(copy.isFirstChunk)
+            {
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                barrier.srcAccessMask = 0;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+            }
+
+            vkCmdCopyBufferToImage(batch.commandBuffer, stagingRing.GetBuffer(), copy.dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.imageRegion);
+
+            // transition TRANSFER_DST >> final layout after the last chunk
+            // >> with an ownership transfer the release and acquire barrier perform the same transition
+            if(copy.isLastChunk)
+            {
+                barrier.srcQueueFamilyIndex = srcFamily;
+                barrier.dstQueueFamilyIndex = dstFamily;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                barrier.newLayout = copy.finalLayout;
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = 0;
+                releaseImageBarriers.push_back(barrier);
+
+                if(isOwnershipTransfer)
+                {
+                    barrier.srcAccessMask = 0;
+                    barrier.dstAccessMask = copy.dstAccessMask;
+                    batch.acquireImageBarriers.push_back(barrier);
+                }
+                batch.dstStageMask |= copy.dstStageMask;
+            }
+            continue;
+        }
+
+        vkCmdCopyBuffer(batch.commandBuffer, stagingRing.GetBuffer(), copy.dstBuffer, 1, &copy.bufferRegion);
+
+        // ownership transfer: release (transfer queue) and acquire (graphics queue) over the whole upload after the last chunk
+        // >> access masks of the other queue are ignored
+        if(copy.isLastChunk)
+        {
+            batch.dstStageMask |= copy.dstStageMask;
+            if(!isOwnershipTransfer)
+                continue;
+
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = srcFamily;
+            barrier.dstQueueFamilyIndex = dstFamily;
+            barrier.buffer = copy.dstBuffer;
+            barrier.offset = copy.dstOffset;
+            barrier.size = copy.dstSize;
+
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            releaseBufferBarriers.push_back(barrier);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = copy.dstAccessMask;
+            batch.acquireBufferBarriers.push_back(barrier);
+        }
+    }
+    pendingCopies.clear();
+
+    // command: release ownership to the graphics family / final image layouts
+    if(!releaseBufferBarriers.empty() || !releaseImageBarriers.empty())
+    {
+        vkCmdPipelineBarrier(
+            batch.commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0, nullptr,
+            static_cast<uint32_t>(releaseBufferBarriers.size()), releaseBufferBarriers.data(),
+            static_cast<uint32_t>(releaseImageBarriers.size()), releaseImageBarriers.data());
+    }
+
+    // command buffer: end
+    vkEndCommandBuffer(batch.commandBuffer);
+
+    // submit: signal the next upload timeline value
+    batch.timelineValue = submittedValue + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &batch.timelineValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &uploadTimeline.GetSemaphore();
+
+    if (vkQueueSubmit(vkTransferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    {
+        std::cout << "error: vulkan: failed to submit upload batch to transfer queue!";
+        destroyBatch(batch);
+        return 0;
+    }
+
+    // staging space of this batch is reclaimed once the upload timeline reaches its value
+    stagingRing.Close(batch.timelineValue);
+
+    submittedValue = batch.timelineValue;
+    batches.push_back(std::move(batch));
+    return submittedValue;
+}
+
+/// @brief records the acquire side of the ownership transfer for all submitted batches that have not been acquired yet
+/// @param graphicsCommandBuffer graphics command buffer recorded before the uploaded resources are used (outside a render pass)
+/// @param waitValue upload timeline value the submit of the command buffer must wait on, 0 when there is nothing to wait for
+/// @param waitStageMask stages that must wait on the upload timeline
+void VulkanUploadManager::RecordAcquireBarriers(VkCommandBuffer graphicsCommandBuffer, uint64_t& waitValue, VkPipelineStageFlags& waitStageMask)
+{
+    waitValue = 0;
+    waitStageMask = 0;
+
+    std::vector<VkBufferMemoryBarrier> acquireBufferBarriers;
+    std::vector<VkImageMemoryBarrier> acquireImageBarriers;
+    for(auto& batch : batches)
+    {
+        if(batch.isAcquired)
+            continue;
+
+        acquireBufferBarriers.insert(acquireBufferBarriers.end(), batch.acquireBufferBarriers.begin(), batch.acquireBufferBarriers.end());
+        acquireImageBarriers.insert(acquireImageBarriers.end(), batch.acquireImageBarriers.begin(), batch.acquireImageBarriers.end());
+        waitValue = std::max(waitValue, batch.timelineValue);
+        waitStageMask |= batch.dstStageMask;
+        batch.isAcquireRecorded = true;
+    }
+
+    // batches without a complete upload (only leading chunks) still have to be waited on by some stage
+    if(waitValue > 0 && waitStageMask == 0)
+        waitStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+    // command: acquire ownership from the transfer family
+    if(!acquireBufferBarriers.empty() || !acquireImageBarriers.empty())
+    {
+        vkCmdPipelineBarrier(
+            graphicsCommandBuffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            waitStageMask,
+            0,
+            0, nullptr,
+            static_cast<uint32_t>(acquireBufferBarriers.size()), acquireBufferBarriers.data(),
+            static_cast<uint32_t>(acquireImageBarriers.size()), acquireImageBarriers.data());
+    }
+}
+
+/// @brief marks the recorded acquires as done, called once the graphics command buffer was submitted
+/// @brief >> without a submit they are recorded again by the next frame
+void VulkanUploadManager::CommitAcquireBarriers()
+{
+    for(auto& batch : batches)
+    {
+        if(batch.isAcquireRecorded)
+            batch.isAcquired = true;
+    }
+}
+
+/// @brief reclaims staging space and frees command buffers of batches that completed and were acquired
+void VulkanUploadManager::CollectGarbage()
+{
+    uint64_t completedValue = uploadTimeline.GetCompletedValue();
+    stagingRing.Reclaim(completedValue);
+
+    while(!batches.empty() && batches.front().isAcquired && batches.front().timelineValue <= completedValue)
+    {
+        destroyBatch(batches.front());
+        batches.pop_front();
+    }
+}
+
+const VkSemaphore& VulkanUploadManager::GetTimelineSemaphore() const
+{
+    return this->uploadTimeline.GetSemaphore();
+}
+
+uint64_t VulkanUploadManager::GetSubmittedValue() const
+{
+    return this->submittedValue;
+}
+
+bool VulkanUploadManager::Wait(uint64_t value, uint64_t timeout) const
+{
+    return this->uploadTimeline.Wait(value, timeout);
+}
+
+/// @brief allocates staging space, makes room when the ring is full
+/// @brief >> queued chunks are submitted so their space can be reclaimed, then the oldest batch is waited on
+bool VulkanUploadManager::allocateStaging(VkDeviceSize size, VkDeviceSize& offset, void*& pMappedData)
+{
+    while(!stagingRing.Allocate(size, stagingAlignment, offset, pMappedData))
+    {
+        if(stagingRing.HasOpenAllocations())
+        {
+            if(Flush() == 0)
+                return false;
+        }
+        else if(stagingRing.HasClosedAllocations())
+        {
+            uploadTimeline.Wait(stagingRing.GetOldestTicket());
+            stagingRing.Reclaim(uploadTimeline.GetCompletedValue());
+        }
+        else
+        {
+            std::cout << "error: vulkan: staging ring is too small for upload!";
+            return false;
+        }
+    }
+    return true;
+}
+
+VkDeviceSize VulkanUploadManager::getMaxChunkSize() const
+{
+    // keep chunks aligned, so a chunk of maximum size always fits into an empty ring
+    VkDeviceSize chunkSize = stagingRing.GetCapacity() / STAGING_MAX_CHUNK_DIVISOR;
+    return chunkSize & ~(stagingAlignment - 1);
+}
+
+/// @brief resources are created with VK_SHARING_MODE_EXCLUSIVE, so they must change owner when the families differ
+bool VulkanUploadManager::isOwnershipTransferRequired() const
+{
+    return transferFamilyIndex != graphicsFamilyIndex;
+}
+
+void VulkanUploadManager::destroyBatch(Batch& batch)
+{
+    if(batch.commandBuffer != VK_NULL_HANDLE)
+        vkFreeCommandBuffers(vkDevice, vkCommandPool, 1, &batch.commandBuffer);
+    batch.commandBuffer = VK_NULL_HANDLE;
+}
\ No newline at end of file
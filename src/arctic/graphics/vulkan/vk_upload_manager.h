@@ -0,0 +1,138 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include "vk_mem_alloc.h"
+#include "vk_timeline.h"
+#include "vk_staging_ring.h"
+
+class VulkanMemoryHandler;
+
+// one mip level of an image upload, tightly packed texels or blocks
+struct ImageLevelData
+{
+    const void* pData = nullptr;
+    uint32_t width = 0;     // in pixels
+    uint32_t height = 0;
+};
+
+/// @brief Batches buffer and image uploads into one submission on the transfer queue.
+/// @brief Uploads are written into the staging ring and submitted together by Flush, completion is signaled on the upload timeline.
+/// @brief When the transfer and graphics families differ, ownership of the destinations is released on the transfer
+/// @brief queue and acquired on the graphics queue (RecordAcquireBarriers), the graphics submit then waits on the upload timeline.
+/// @brief The cpu only waits when the staging ring is full.
+/// @brief Used from the render thread: a full staging ring submits to the transfer queue, which may be the graphics queue.
+class VulkanUploadManager
+{
+public:
+    bool Create(
+        VkDevice vkDevice,
+        std::shared_ptr<VulkanMemoryHandler> memoryHandler,
+        VkQueue transferQueue,
+        uint32_t transferFamilyIndex,
+        uint32_t graphicsFamilyIndex,
+        VkDeviceSize stagingCapacity);
+    void CleanUp();
+
+    bool UploadBuffer(
+        const void* pData,
+        VkDeviceSize size,
+        VkBuffer dstBuffer,
+        VkDeviceSize dstOffset,
+        VkPipelineStageFlags dstStageMask,
+        VkAccessFlags dstAccessMask);
+
+    bool UploadImage(
+        const void* pData,
+        uint32_t width,
+        uint32_t height,
+        uint32_t bytesPerPixel,
+        VkImage dstImage,
+        VkPipelineStageFlags dstStageMask,
+        VkAccessFlags dstAccessMask,
+        uint32_t mipLevels = 1,
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    bool UploadImageLevels(
+        const std::vector<ImageLevelData>& levels,
+        uint32_t blockSize,
+        uint32_t bytesPerBlock,
+        VkImage dstImage,
+        VkPipelineStageFlags dstStageMask,
+        VkAccessFlags dstAccessMask,
+        uint32_t mipLevels,
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    uint64_t Flush();
+    void RecordAcquireBarriers(VkCommandBuffer graphicsCommandBuffer, uint64_t& waitValue, VkPipelineStageFlags& waitStageMask);
+    void CommitAcquireBarriers();
+    void CollectGarbage();
+
+    const VkSemaphore& GetTimelineSemaphore() const;
+    uint64_t GetSubmittedValue() const;
+    bool Wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+private:
+    // one staged chunk of an upload
+    // >> the barriers of an upload are recorded with its first (image layout) and last chunk (release)
+    struct PendingCopy
+    {
+        VkDeviceSize srcOffset = 0;
+
+        VkBuffer dstBuffer = VK_NULL_HANDLE;
+        VkBufferCopy bufferRegion{};
+
+        VkImage dstImage = VK_NULL_HANDLE;
+        VkBufferImageCopy imageRegion{};
+        uint32_t mipLevels = 1;             // levels transitioned and transferred, not all of them have to be written
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        bool isFirstChunk = false;
+        bool isLastChunk = false;
+        VkDeviceSize dstOffset = 0; // whole destination range, used by the barriers
+        VkDeviceSize dstSize = 0;
+        VkPipelineStageFlags dstStageMask = 0;
+        VkAccessFlags dstAccessMask = 0;
+    };
+
+    struct Batch
+    {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+        // acquire side of the ownership transfer, recorded once into a graphics command buffer
+        std::vector<VkBufferMemoryBarrier> acquireBufferBarriers;
+        std::vector<VkImageMemoryBarrier> acquireImageBarriers;
+        VkPipelineStageFlags dstStageMask = 0;
+        bool isAcquireRecorded = false; // recorded into a graphics command buffer that was not submitted yet
+        bool isAcquired = false;
+
+        uint64_t timelineValue = 0; // batch is done once the upload timeline reaches this value
+    };
+
+    // chunks are limited to a part of the ring, so a large upload does not have to wait for the whole ring to drain
+    const VkDeviceSize STAGING_MAX_CHUNK_DIVISOR = 4;
+
+    VkDevice vkDevice = VK_NULL_HANDLE;
+    std::shared_ptr<VulkanMemoryHandler> memoryHandler;
+
+    VkQueue vkTransferQueue = VK_NULL_HANDLE;
+    uint32_t transferFamilyIndex = 0;
+    uint32_t graphicsFamilyIndex = 0;
+    VkCommandPool vkCommandPool = VK_NULL_HANDLE;
+
+    VulkanTimeline uploadTimeline;
+    uint64_t submittedValue = 0;
+
+    VulkanStagingRing stagingRing;
+    VkDeviceSize stagingAlignment = 16;
+
+    std::vector<PendingCopy> pendingCopies;
+    std::deque<Batch> batches;
+
+    bool allocateStaging(VkDeviceSize size, VkDeviceSize& offset, void*& pMappedData);
+    VkDeviceSize getMaxChunkSize() const;
+    bool isOwnershipTransferRequired() const;
+    void destroyBatch(Batch& batch);
+};
\ No newline at end of file
@@ -15,6 +15,10 @@ SDL_Window* VulkanWindow::GetSDLWindow()
 
 std::vector<const char*> VulkanWindow::GetExtensions() const
 {
+    // headless: no surface, so no surface instance extensions are needed
+    if(isHeadless)
+        return {};
+
     uint32_t extensionCount = 0;
     SDL_Vulkan_GetInstanceExtensions(this->window, &extensionCount, nullptr);
     std::vector<const char*> extensions(extensionCount);
@@ -24,6 +28,10 @@ std::vector<const char*> VulkanWindow::GetExtensions() const
 
 std::pair<uint32_t, uint32_t> VulkanWindow::GetFramebufferSize() const
 {
+    // headless: offscreen images use the default window size
+    if(isHeadless)
+        return std::make_pair(WINDOW_WIDTH, WINDOW_HEIGHT);
+
     // get window size
     int windowFrameBufferWidth;
     int windowFrameBufferHeight;
@@ -52,6 +60,14 @@ void VulkanWindow::CreateWindow()
     //SDL_Delay(100);
 }
 
+void VulkanWindow::CreateHeadless()
+{
+    // no SDL window or X server required
+    // >> the renderer will present into a ring of offscreen images instead of a surface
+    window = nullptr;
+    isHeadless = true;
+}
+
 void VulkanWindow::CreateSurface(const VkInstance& vkInstance, VkSurfaceKHR& vkSurface) const
 {
     SDL_bool result = SDL_Vulkan_CreateSurface(window, vkInstance, &vkSurface);
@@ -64,9 +80,18 @@ void VulkanWindow::CreateSurface(const VkInstance& vkInstance, VkSurfaceKHR& vkS
 
 void VulkanWindow::CleanupWindow()
 {
+    // headless: SDL was never used
+    if(isHeadless)
+        return;
+
     // frees memory
     SDL_DestroyWindow(window);
   
     // Shuts down all SDL subsystems
     SDL_Quit(); 
+}
+
+bool VulkanWindow::IsHeadless() const
+{
+    return this->isHeadless;
 }
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "arctic/core/engine/arctic_engine.h"
+#include "arctic/core/utilities/argument_parser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+struct BenchmarkSettings
+{
+    uint64_t warmupFrames = 100;
+    uint64_t frames = 1000;
+    std::string outputPath = "benchmark_results.json";
+    bool headless = false;
+    std::string tracePath;
+    uint64_t draws = 1;
+    PresentSettings present;
+    MemoryPoolSizes memoryPools;
+    bool depthPrepass = true;
+};
+
+struct Percentiles
+{
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+};
+
+/// @brief computes nearest-rank percentiles of the samples
+/// @brief >> the p-th percentile is the smallest sample that at least p of all samples are less than or equal to
+static Percentiles computePercentiles(std::vector<double> samples)
+{
+    Percentiles result{};
+    if(samples.empty())
+        return result;
+
+    std::sort(samples.begin(), samples.end());
+
+    auto percentile = [&samples](double p)
+    {
+        size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+
+    double sum = 0.0;
+    for(double sample : samples)
+        sum += sample;
+
+    result.p50 = percentile(0.50);
+    result.p95 = percentile(0.95);
+    result.p99 = percentile(0.99);
+    result.max = samples.back();
+    result.mean = sum / static_cast<double>(samples.size());
+    return result;
+}
+
+/// @brief copies of the quad draw in a grid covering the area of a single quad
+static std::vector<DrawItem> createQuadGrid(const DrawItem& quad, uint64_t count)
+{
+    uint64_t columns = static_cast<uint64_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    float cellSize = 1.0f / static_cast<float>(columns);
+
+    std::vector<DrawItem> drawList;
+    drawList.reserve(count);
+    for(uint64_t i = 0; i < count; ++i)
+    {
+        float x = (static_cast<float>(i % columns) + 0.5f) * cellSize - 0.5f;
+        float y = (static_cast<float>(i / columns) + 0.5f) * cellSize - 0.5f;
+
+        DrawItem draw = quad;
+        draw.model = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(cellSize * 0.9f));
+        drawList.push_back(draw);
+    }
+    return drawList;
+}
+
+static BenchmarkSettings parseArguments(int argc, char* argv[])
+{
+    // >> --frames <count>: measured frames
+    // >> --warmup <count>: frames rendered before measuring
+    // >> --output <path>: json result file
+    // >> --headless: render offscreen without a window
+    // >> --trace <path>: write a chrome trace of cpu frames and gpu zones
+    // >> --draws <count>: draws per frame, 1024 and more are recorded by worker threads
+    // >> --present-mode <fifo|fifo-relaxed|mailbox|immediate>, --swapchain-images <count>, --frames-in-flight <count>
+    // >> --geometry-block-mb, --uniform-block-mb, --staging-block-mb, --texture-block-mb <MB>: memory pool block sizes
+    // >> --no-depth-prepass: compare against shading opaque draws without the depth prepass
+    BenchmarkSettings settings;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if(arg == "--headless")
+            settings.headless = true;
+        else if(arg == "--frames" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.frames);
+        else if(arg == "--warmup" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.warmupFrames);
+        else if(arg == "--output" && i + 1 < argc)
+            settings.outputPath = argv[++i];
+        else if(arg == "--trace" && i + 1 < argc)
+            settings.tracePath = argv[++i];
+        else if(arg == "--draws" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.draws);
+        else if(arg == "--present-mode" && i + 1 < argc)
+        {
+            if(!ParsePresentMode(argv[++i], settings.present.presentMode))
+                std::cout << "error: benchmark: unknown present mode " << argv[i] << std::endl;
+        }
+        else if(arg == "--swapchain-images" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.present.imageCount);
+        else if(arg == "--frames-in-flight" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.present.framesInFlight);
+        else if(arg == "--geometry-block-mb" && i + 1 < argc)
+            ArgumentParser::ParseMegabytes(argv[++i], settings.memoryPools.geometryBlockSize);
+        else if(arg == "--uniform-block-mb" && i + 1 < argc)
+            ArgumentParser::ParseMegabytes(argv[++i], settings.memoryPools.uniformBlockSize);
+        else if(arg == "--staging-block-mb" && i + 1 < argc)
+            ArgumentParser::ParseMegabytes(argv[++i], settings.memoryPools.stagingBlockSize);
+        else if(arg == "--texture-block-mb" && i + 1 < argc)
+            ArgumentParser::ParseMegabytes(argv[++i], settings.memoryPools.textureBlockSize);
+        else if(arg == "--no-depth-prepass")
+            settings.depthPrepass = false;
+    }
+    return settings;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkSettings benchmarkSettings = parseArguments(argc, argv);
+
+    // start engine
+    EngineSettings engineSettings;
+    engineSettings.headless = benchmarkSettings.headless;
+    engineSettings.present = benchmarkSettings.present;
+    engineSettings.memoryPools = benchmarkSettings.memoryPools;
+    engineSettings.depthPrepass = benchmarkSettings.depthPrepass;
+    engineSettings.tracePath = benchmarkSettings.tracePath;
+
+    ArcticEngine engine;
+    engine.Initialize(engineSettings);
+
+    // scene: the quad, or a grid of quads to measure recording of large draw lists
+    if(benchmarkSettings.draws > 1)
+        engine.SetDrawList(createQuadGrid(engine.GetQuadDraw(), benchmarkSettings.draws));
+
+    // warmup: let pipelines, caches and clocks settle
+    for(uint64_t i = 0; i < benchmarkSettings.warmupFrames; ++i)
+    {
+        if(!engine.Update())
+            break;
+    }
+
+    // measure
+    // >> only submitted frames are sampled, frames skipped early (swapchain reload, failed acquire) carry no timings
+    // >> gpu timings complete frames in flight later, every completed frame is sampled once
+    std::vector<FrameTimings> timings;
+    std::vector<double> gpuFrameSamples;
+    timings.reserve(benchmarkSettings.frames);
+    uint64_t cpuFrameValue = 0;
+    uint64_t gpuFrameValue = 0;
+    uint64_t measuredFrames = 0;
+    for(; measuredFrames < benchmarkSettings.frames; ++measuredFrames)
+    {
+        if(!engine.Update())
+            break;
+
+        FrameTimings frameTimings = engine.GetFrameTimings();
+        if(frameTimings.frameValue != 0 && frameTimings.frameValue != cpuFrameValue)
+        {
+            timings.push_back(frameTimings);
+            cpuFrameValue = frameTimings.frameValue;
+        }
+
+        GpuFrameTimings gpuTimings = engine.GetGpuFrameTimings();
+        if(gpuTimings.frameValue != 0 && gpuTimings.frameValue != gpuFrameValue)
+        {
+            gpuFrameSamples.push_back(gpuTimings.frameMs);
+            gpuFrameValue = gpuTimings.frameValue;
+        }
+    }
+
+    // effective configuration: the engine clamps the requested frames in flight
+    uint32_t framesInFlight = engine.GetFramesInFlight();
+
+    engine.Cleanup();
+    uint64_t skippedFrames = measuredFrames - timings.size();
+
+    // collect metrics
+    struct Metric
+    {
+        const char* name;
+        std::function<double(const FrameTimings&)> getValue;
+    };
+
+    const std::vector<Metric> metrics =
+    {
+        { "wait", [](const FrameTimings& t) { return t.waitMs; } },
+        { "acquire", [](const FrameTimings& t) { return t.acquireMs; } },
+        { "record", [](const FrameTimings& t) { return t.recordMs; } },
+        { "submit", [](const FrameTimings& t) { return t.submitMs; } },
+        { "present", [](const FrameTimings& t) { return t.presentMs; } },
+        { "frame", [](const FrameTimings& t) { return t.frameMs; } },
+    };
+
+    std::vector<std::pair<const char*, std::vector<double>>> series;
+    for(const auto& metric : metrics)
+    {
+        std::vector<double> samples;
+        samples.reserve(timings.size());
+        for(const auto& timing : timings)
+            samples.push_back(metric.getValue(timing));
+        series.emplace_back(metric.name, std::move(samples));
+    }
+    series.emplace_back("gpu", std::move(gpuFrameSamples));
+
+    // write json
+    std::ofstream file(benchmarkSettings.outputPath);
+    if(!file.is_open())
+    {
+        std::cout << "error: benchmark: failed to open output file " << benchmarkSettings.outputPath << std::endl;
+        return 1;
+    }
+
+    file << std::fixed << std::setprecision(4);
+    file << "{\n";
+    file << "  \"frames\": " << timings.size() << ",\n";
+    file << "  \"skippedFrames\": " << skippedFrames << ",\n";
+    file << "  \"warmupFrames\": " << benchmarkSettings.warmupFrames << ",\n";
+    file << "  \"draws\": " << benchmarkSettings.draws << ",\n";
+    file << "  \"headless\": " << (benchmarkSettings.headless ? "true" : "false") << ",\n";
+    file << "  \"framesInFlight\": " << framesInFlight << ",\n";
+    file << "  \"depthPrepass\": " << (benchmarkSettings.depthPrepass ? "true" : "false") << ",\n";
+    file << "  \"unit\": \"ms\",\n";
+    file << "  \"metrics\": {\n";
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "benchmark: " << timings.size() << " frames (ms)" << std::endl;
+
+    for(size_t m = 0; m < series.size(); ++m)
+    {
+        const auto& [name, samples] = series[m];
+        Percentiles result = computePercentiles(samples);
+
+        file << "    \"" << name << "\": { "
+             << "\"p50\": " << result.p50 << ", "
+             << "\"p95\": " << result.p95 << ", "
+             << "\"p99\": " << result.p99 << ", "
+             << "\"max\": " << result.max << ", "
+             << "\"mean\": " << result.mean << " }"
+             << (m + 1 < series.size() ? "," : "") << "\n";
+
+        std::cout << "\t" << std::left << std::setw(8) << name
+                  << " p50 " << result.p50
+                  << "  p95 " << result.p95
+                  << "  p99 " << result.p99
+                  << "  max " << result.max << std::endl;
+    }
+
+    file << "  }\n";
+    file << "}\n";
+
+    std::cout << "benchmark: results written to " << benchmarkSettings.outputPath << std::endl;
+    return 0;
+}
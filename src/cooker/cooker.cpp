@@ -0,0 +1,323 @@
+#include "arctic/graphics/texture/texture_cooker.h"
+#include "arctic/graphics/texture/ktx2_loader.h"
+#include "arctic/graphics/texture/bc_decoder.h"
+#include "arctic/core/utilities/thread_pool.h"
+#include "arctic/core/utilities/argument_parser.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct CookerSettings
+{
+    std::vector<std::string> inputs;
+    std::string outputDir;
+    std::string format = "bc7";
+    EncodePreset preset = EncodePreset::Normal;
+    SimdLevel simdLevel = SimdLevel::AVX2;
+    uint32_t threadCount = 0;
+    uint32_t iterations = 3;
+    bool linear = false;
+    bool generateMips = true;
+    bool benchmark = false;
+};
+
+static const EncodePreset PRESETS[] = { EncodePreset::Fast, EncodePreset::Normal, EncodePreset::Quality };
+static const char* PRESET_NAMES[] = { "fast", "normal", "quality" };
+
+static CookerSettings parseArguments(int argc, char* argv[])
+{
+    // >> --input <path>: image file or directory of images (jpg, png, tga, bmp), repeatable
+    // >> --output <dir>: directory of the ktx2 files, next to each input when omitted
+    // >> --format <bc1|bc7|rgba8>: format of the cooked textures
+    // >> --preset <fast|normal|quality>: encoder speed / quality trade off
+    // >> --simd <scalar|sse4.1|avx2>: widest encoder kernel, limited to what the cpu supports
+    // >> --threads <count>: encoder threads, 0 uses all cores
+    // >> --linear: inputs hold linear data (normal maps, masks) instead of srgb colors
+    // >> --no-mips: cook level 0 only
+    // >> --benchmark: encode the inputs with every format, preset and kernel and report megapixels per second
+    // >> --iterations <count>: encodes per benchmark measurement
+    CookerSettings settings;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if(arg == "--input" && i + 1 < argc)
+            settings.inputs.push_back(argv[++i]);
+        else if(arg == "--output" && i + 1 < argc)
+            settings.outputDir = argv[++i];
+        else if(arg == "--format" && i + 1 < argc)
+            settings.format = argv[++i];
+        else if(arg == "--preset" && i + 1 < argc)
+        {
+            std::string preset = argv[++i];
+            bool isKnownPreset = false;
+            for(size_t p = 0; p < std::size(PRESETS); ++p)
+            {
+                if(preset == PRESET_NAMES[p])
+                {
+                    settings.preset = PRESETS[p];
+                    isKnownPreset = true;
+                }
+            }
+            if(!isKnownPreset)
+                std::cout << "error: cooker: unknown preset " << preset << std::endl;
+        }
+        else if(arg == "--simd" && i + 1 < argc)
+        {
+            std::string simd = argv[++i];
+            if(simd == "scalar")
+                settings.simdLevel = SimdLevel::Scalar;
+            else if(simd == "sse4.1")
+                settings.simdLevel = SimdLevel::SSE41;
+            else if(simd == "avx2")
+                settings.simdLevel = SimdLevel::AVX2;
+            else
+                std::cout << "error: cooker: unknown simd level " << simd << std::endl;
+        }
+        else if(arg == "--threads" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.threadCount);
+        else if(arg == "--iterations" && i + 1 < argc)
+        {
+            ArgumentParser::ParseCount(argv[++i], settings.iterations);
+            settings.iterations = std::max(1u, settings.iterations);
+        }
+        else if(arg == "--linear")
+            settings.linear = true;
+        else if(arg == "--no-mips")
+            settings.generateMips = false;
+        else if(arg == "--benchmark")
+            settings.benchmark = true;
+    }
+    return settings;
+}
+
+/// @brief expands directories into the image files they contain, sorted by path
+static std::vector<std::filesystem::path> collectInputs(const std::vector<std::string>& inputs)
+{
+    auto isImage = [](const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        return extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".tga" || extension == ".bmp";
+    };
+
+    std::vector<std::filesystem::path> files;
+    for(const auto& input : inputs)
+    {
+        if(std::filesystem::is_directory(input))
+        {
+            for(const auto& entry : std::filesystem::directory_iterator(input))
+            {
+                if(entry.is_regular_file() && isImage(entry.path()))
+                    files.push_back(entry.path());
+            }
+        }
+        else
+        {
+            files.push_back(input);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static TextureFormat getTargetFormat(const std::string& name, bool linear)
+{
+    if(name == "bc1")
+        return linear ? TextureFormat::BC1_UNORM : TextureFormat::BC1_SRGB;
+    if(name == "bc7")
+        return linear ? TextureFormat::BC7_UNORM : TextureFormat::BC7_SRGB;
+    if(name == "rgba8")
+        return linear ? TextureFormat::RGBA8_UNORM : TextureFormat::RGBA8_SRGB;
+    return TextureFormat::Undefined;
+}
+
+static bool loadImage(const std::filesystem::path& path, bool linear, TextureData& texture)
+{
+    int width, height, channels;
+    stbi_uc* pixels = stbi_load(path.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if(!pixels)
+    {
+        std::cout << "error: cooker: failed to load " << path.string() << std::endl;
+        return false;
+    }
+
+    TextureLevel level{};
+    level.width = static_cast<uint32_t>(width);
+    level.height = static_cast<uint32_t>(height);
+    level.data.assign(pixels, pixels + static_cast<size_t>(width) * height * STBI_rgb_alpha);
+    stbi_image_free(pixels);
+
+    texture.format = linear ? TextureFormat::RGBA8_UNORM : TextureFormat::RGBA8_SRGB;
+    texture.width = level.width;
+    texture.height = level.height;
+    texture.levels.clear();
+    texture.levels.push_back(std::move(level));
+    return true;
+}
+
+static double getMegapixels(const TextureData& texture)
+{
+    double pixels = 0.0;
+    for(const auto& level : texture.levels)
+        pixels += static_cast<double>(level.width) * level.height;
+    return pixels / 1000000.0;
+}
+
+/// @brief peak signal to noise ratio of the decoded blocks against the source texels (rgb)
+static double computePsnr(const TextureLevel& source, const TextureLevel& compressed, TextureFormat format)
+{
+    TextureData compressedData{};
+    compressedData.format = format;
+    compressedData.width = compressed.width;
+    compressedData.height = compressed.height;
+    compressedData.levels.push_back(compressed);
+
+    TextureData decoded{};
+    if(!BcDecoder::Decompress(compressedData, decoded))
+        return 0.0;
+
+    double squaredError = 0.0;
+    const std::vector<uint8_t>& decodedData = decoded.levels[0].data;
+    for(size_t i = 0; i < source.data.size(); ++i)
+    {
+        if(i % 4 == 3)
+            continue;
+        double delta = static_cast<double>(decodedData[i]) - static_cast<double>(source.data[i]);
+        squaredError += delta * delta;
+    }
+
+    double meanSquaredError = squaredError / (static_cast<double>(source.data.size()) * 3.0 / 4.0);
+    if(meanSquaredError <= 0.0)
+        return 99.0;
+    return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+static bool cookFile(const std::filesystem::path& input, const CookerSettings& settings, ThreadPool& threadPool)
+{
+    TextureData source{};
+    if(!loadImage(input, settings.linear, source))
+        return false;
+
+    CookSettings cookSettings{};
+    cookSettings.format = getTargetFormat(settings.format, settings.linear);
+    cookSettings.encodeSettings.preset = settings.preset;
+    cookSettings.encodeSettings.simdLevel = settings.simdLevel;
+    cookSettings.generateMips = settings.generateMips;
+
+    auto start = std::chrono::steady_clock::now();
+    TextureData cooked{};
+    if(!TextureCooker::Cook(source, cookSettings, threadPool, cooked))
+        return false;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::filesystem::path outputDir = settings.outputDir.empty() ? input.parent_path() : std::filesystem::path(settings.outputDir);
+    std::filesystem::path output = outputDir / input.stem();
+    output += ".ktx2";
+    if(!Ktx2Loader::Save(output.string(), cooked))
+    {
+        std::cout << "error: cooker: failed to write " << output.string() << std::endl;
+        return false;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "cooker: " << input.filename().string() << " >> " << output.string()
+              << " (" << settings.format << ", " << cooked.width << "x" << cooked.height << ", " << cooked.levels.size() << " levels, "
+              << seconds << " s, " << getMegapixels(cooked) / seconds << " MP/s)" << std::endl;
+    return true;
+}
+
+/// @brief encodes level 0 of every input with every format, preset and supported kernel
+static bool runBenchmark(const std::vector<std::filesystem::path>& inputs, const CookerSettings& settings, ThreadPool& threadPool)
+{
+    std::vector<TextureData> sources;
+    for(const auto& input : inputs)
+    {
+        TextureData source{};
+        if(!loadImage(input, settings.linear, source))
+            return false;
+        sources.push_back(std::move(source));
+    }
+
+    double megapixels = 0.0;
+    for(const auto& source : sources)
+        megapixels += getMegapixels(source);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "benchmark: " << sources.size() << " images, " << megapixels << " MP, " << threadPool.GetThreadCount()
+              << " threads, " << settings.iterations << " iterations" << std::endl;
+
+    SimdLevel supportedLevel = BcEncoder::GetSupportedSimdLevel();
+    for(const std::string format : { "bc1", "bc7" })
+    {
+        TextureFormat targetFormat = getTargetFormat(format, settings.linear);
+        for(size_t p = 0; p < std::size(PRESETS); ++p)
+        {
+            for(uint32_t level = 0; level <= static_cast<uint32_t>(supportedLevel); ++level)
+            {
+                BcEncodeSettings encodeSettings{};
+                encodeSettings.preset = PRESETS[p];
+                encodeSettings.simdLevel = static_cast<SimdLevel>(level);
+
+                std::vector<TextureLevel> compressed(sources.size());
+                auto start = std::chrono::steady_clock::now();
+                for(uint32_t iteration = 0; iteration < settings.iterations; ++iteration)
+                {
+                    for(size_t s = 0; s < sources.size(); ++s)
+                        TextureCooker::Compress(sources[s].levels[0], targetFormat, encodeSettings, threadPool, compressed[s]);
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                double psnr = 0.0;
+                for(size_t s = 0; s < sources.size(); ++s)
+                    psnr += computePsnr(sources[s].levels[0], compressed[s], targetFormat);
+                psnr /= static_cast<double>(sources.size());
+
+                std::cout << "\t" << format << " " << std::left << std::setw(8) << PRESET_NAMES[p]
+                          << std::setw(8) << BcEncoder::GetSimdLevelName(encodeSettings.simdLevel) << std::right
+                          << " MP/s " << std::setw(8) << megapixels * settings.iterations / seconds
+                          << "  psnr " << psnr << " dB" << std::endl;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    CookerSettings settings = parseArguments(argc, argv);
+
+    std::vector<std::filesystem::path> inputs = collectInputs(settings.inputs);
+    if(inputs.empty())
+    {
+        std::cout << "error: cooker: no input images, use --input <file|dir>" << std::endl;
+        return 1;
+    }
+    if(getTargetFormat(settings.format, settings.linear) == TextureFormat::Undefined)
+    {
+        std::cout << "error: cooker: unknown format " << settings.format << std::endl;
+        return 1;
+    }
+
+    // the main thread only waits on the encode tasks, use every core for workers
+    uint32_t threadCount = settings.threadCount > 0 ? settings.threadCount : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool threadPool(threadCount);
+
+    if(settings.benchmark)
+        return runBenchmark(inputs, settings, threadPool) ? 0 : 1;
+
+    bool isSuccessful = true;
+    for(const auto& input : inputs)
+        isSuccessful &= cookFile(input, settings, threadPool);
+    return isSuccessful ? 0 : 1;
+}
\ No newline at end of file
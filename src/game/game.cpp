@@ -1,9 +1,83 @@
 #include "arctic/core/engine/arctic_engine.h"
+#include "arctic/core/utilities/argument_parser.h"
+#include <iostream>
+#include <string>
+#include <glm/gtc/matrix_transform.hpp>
 
-int main()
+int main(int argc, char* argv[])
 {
+    // parse arguments
+    // >> --headless: render offscreen without a window
+    // >> --frames <count>: stop after rendering count frames
+    // >> --memory-report <path>: append gpu memory statistics to path (json lines)
+    // >> --memory-report-interval <frames>: frames between two memory reports
+    // >> --trace <path>: write a chrome trace of cpu frames and gpu zones (chrome://tracing, perfetto)
+    // >> --present-mode <fifo|fifo-relaxed|mailbox|immediate>: falls back to fifo when unsupported
+    // >> --swapchain-images <count>: clamped to the surface limits
+    // >> --frames-in-flight <count>: 1 to 4
+    // >> --geometry-block-mb, --uniform-block-mb, --staging-block-mb, --texture-block-mb <MB>: memory pool block sizes, 0 uses the vma default
+    // >> --frame-limiter <off|throughput|latency>: latency samples input as late as possible, at the cost of throughput
+    // >> --target-fps <fps>: frame rate cap of the frame limiter, 0 does not cap
+    // >> --watch-shaders: recompile edited shaders and rebuild their pipelines while running
+    // >> --no-depth-prepass: opaque draws test and write depth in the main pass instead
+    EngineSettings settings;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if(arg == "--headless")
+            settings.headless = true;
+        else if(arg == "--frames" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.frameCount);
+        else if(arg == "--memory-report" && i + 1 < argc)
+            settings.memoryReportPath = argv[++i];
+        else if(arg == "--memory-report-interval" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.memoryReportInterval);
+        else if(arg == "--trace" && i + 1 < argc)
+            settings.tracePath = argv[++i];
+        else if(arg == "--present-mode" && i + 1 < argc)
+        {
+            if(!ParsePresentMode(argv[++i], settings.present.presentMode))
+                std::cout << "error: game: unknown present mode " << argv[i] << std::endl;
+        }
+        else if(arg == "--swapchain-images" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.present.imageCount);
+        else if(arg == "--frames-in-flight" && i + 1 < argc)
+            ArgumentParser::ParseCount(argv[++i], settings.present.framesInFlight);
+        else if(arg == "--geometry-block-mb" && i + 1 < argc)
+            ArgumentParser::ParseMegabytes(argv[++i], settings.memoryPools.geometryBlockSize);
+        else if(arg == "--uniform-block-mb" && i + 1 < argc)
+            ArgumentParser::ParseMegabytes(argv[++i], settings.memoryPools.uniformBlockSize);
+        else if(arg == "--staging-block-mb" && i + 1 < argc)
+            ArgumentParser::ParseMegabytes(argv[++i], settings.memoryPools.stagingBlockSize);
+        else if(arg == "--texture-block-mb" && i + 1 < argc)
+            ArgumentParser::ParseMegabytes(argv[++i], settings.memoryPools.textureBlockSize);
+        else if(arg == "--frame-limiter" && i + 1 < argc)
+        {
+            if(!ParseFrameLimiterMode(argv[++i], settings.frameLimiterMode))
+                std::cout << "error: game: unknown frame limiter mode " << argv[i] << std::endl;
+        }
+        else if(arg == "--target-fps" && i + 1 < argc)
+            ArgumentParser::ParseNumber(argv[++i], settings.targetFps);
+        else if(arg == "--watch-shaders")
+            settings.watchShaders = true;
+        else if(arg == "--no-depth-prepass")
+            settings.depthPrepass = false;
+    }
+
     ArcticEngine engine;
-    engine.Initialize();
+    engine.Initialize(settings);
+
+    // scene: the opaque quad and a blended quad above it
+    // >> the blended pipeline compiles in the background, until then the quad is drawn with the default pipeline
+    PipelineDesc blendedDesc{};
+    blendedDesc.blendMode = BlendMode::AlphaBlend;
+
+    DrawItem opaqueQuad = engine.GetQuadDraw();
+    DrawItem blendedQuad = opaqueQuad;
+    blendedQuad.pipeline = engine.RequestPipeline(blendedDesc);
+    blendedQuad.model = glm::translate(glm::mat4(1.0f), glm::vec3(0.25f, 0.25f, 0.25f));
+    engine.SetDrawList({ opaqueQuad, blendedQuad });
+
     engine.Run();
     engine.Cleanup();
 